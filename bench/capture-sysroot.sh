@@ -0,0 +1,88 @@
+#!/bin/sh
+#
+# TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+# Designed by Syndromatic in Manchester.
+#
+# Captures the parts of /proc, /sys and /etc that the Hardware probes read,
+# plus canned lscpu/lspci output, into a tree usable with
+# `probebench --root <dir>` (or Hardware::setSysRoot()).
+#
+# Usage: capture-sysroot.sh <output-dir>
+# Run as root to include the SMBIOS table (per-DIMM memory details).
+
+set -eu
+
+OUT=${1:?usage: capture-sysroot.sh <output-dir>}
+mkdir -p "$OUT"
+
+copy() {
+    # Copies a file's current contents (sysfs attributes can't be cp -a'd).
+    [ -r "$1" ] || return 0
+    mkdir -p "$OUT$(dirname "$1")"
+    cat "$1" > "$OUT$1" 2>/dev/null || rm -f "$OUT$1"
+}
+
+copy /proc/cpuinfo
+copy /proc/meminfo
+copy /proc/sys/kernel/random/boot_id
+copy /etc/os-release
+copy /sys/devices/system/cpu/online
+copy /sys/firmware/dmi/tables/DMI
+
+for f in /sys/class/dmi/id/*; do
+    [ -f "$f" ] && copy "$f"
+done
+
+for cpu in /sys/devices/system/cpu/cpu[0-9]*; do
+    copy "$cpu/topology/physical_package_id"
+    copy "$cpu/topology/core_id"
+    copy "$cpu/topology/thread_siblings_list"
+    copy "$cpu/cpufreq/cpuinfo_max_freq"
+    copy "$cpu/cpufreq/scaling_cur_freq"
+    for idx in "$cpu"/cache/index*; do
+        copy "$idx/shared_cpu_list"
+    done
+done
+
+for node in /sys/devices/system/node/node[0-9]*; do
+    for attr in cpulist meminfo distance; do
+        copy "$node/$attr"
+    done
+done
+
+for idx in /sys/devices/system/cpu/cpu0/cache/index*; do
+    for attr in level type size ways_of_associativity coherency_line_size shared_cpu_list; do
+        copy "$idx/$attr"
+    done
+done
+copy /sys/devices/cpu_core/cpus
+copy /sys/devices/cpu_atom/cpus
+
+# /sys/bus/pci/devices entries are symlinks; store them as plain directories.
+for dev in /sys/bus/pci/devices/*; do
+    for attr in class vendor device boot_vga; do
+        copy "$dev/$attr"
+    done
+done
+
+# /sys/block entries are symlinks too. Partitions only need their dev number.
+for blk in /sys/block/*; do
+    for attr in dev size removable queue/rotational queue/logical_block_size \
+                queue/physical_block_size queue/nr_requests queue/scheduler \
+                device/model device/vendor; do
+        copy "$blk/$attr"
+    done
+    for part in "$blk"/"$(basename "$blk")"*; do
+        [ -f "$part/partition" ] && copy "$part/partition" && copy "$part/dev"
+    done
+done
+
+for ids in /usr/share/hwdata/pci.ids /usr/share/misc/pci.ids /usr/share/pci.ids; do
+    copy "$ids"
+done
+
+mkdir -p "$OUT/tools"
+lscpu > "$OUT/tools/lscpu.txt" 2>/dev/null || true
+lspci -vmm > "$OUT/tools/lspci-vmm.txt" 2>/dev/null || true
+
+echo "Captured into $OUT"
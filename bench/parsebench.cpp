@@ -0,0 +1,379 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+// Parser microbenchmark.
+//
+// Runs the string_view tool parsers (toolparse.cpp) and, for comparison, the
+// QString split/section code they replaced over captured lscpu and lspci -vmm
+// output, and reports throughput and heap allocations per parse. Inputs are
+// padded with --repeat copies so they look like a big machine's output.
+// The cpuid rows time the ISA probe that replaced reading "Flags:" out of
+// lscpu: the captured flags line, and cpuid on this machine.
+// The names rows check the display-name tables against the golden file
+// (bench/fixtures/names.tsv; any mismatch is printed and fails the run) and
+// time them against the regex cleanup they replaced. The larger hand-checked
+// corpus (bench/fixtures/names-corpus.tsv, a couple of thousand lscpu model
+// names and pci.ids display devices) is checked the same way. --pci-ids adds
+// every vendor/device pair in a pci.ids file to the timing, a few tens of
+// thousands of real names.
+//
+//   ./parsebench --root ../bench/fixtures/sample --repeat 64
+//   ./parsebench --names ../bench/fixtures/names.tsv --pci-ids /usr/share/hwdata/pci.ids
+//
+
+#include "hardware_p.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QPair>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+// Count every heap allocation in the process. Qt allocates QString data with
+// malloc rather than operator new, so interpose malloc itself (glibc).
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *p, size_t size);
+}
+
+namespace {
+std::atomic<unsigned long long> g_allocations{0};
+}
+
+extern "C" void *malloc(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t n, size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(n, size);
+}
+
+extern "C" void *realloc(void *p, size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(p, size);
+}
+
+namespace {
+
+// The QString parsing as it was before toolparse.cpp, kept here as the baseline.
+namespace Before {
+
+void parseLscpu(const QString &output, QString &modelName, int &cores, double &ghz) {
+    int coresPerSocket = 1;
+    int sockets = 1;
+    const QStringList lines = output.split('\n');
+    for (const QString &line : lines) {
+        if (line.startsWith("Model name:")) {
+            modelName = line.section(':', 1).trimmed();
+        } else if (line.startsWith("Core(s) per socket:")) {
+            coresPerSocket = line.section(':', 1).trimmed().toInt();
+        } else if (line.startsWith("Socket(s):")) {
+            sockets = line.section(':', 1).trimmed().toInt();
+        } else if (line.startsWith("CPU max MHz:")) {
+            double mhz = line.section(':', 1).trimmed().toDouble();
+            if (mhz > 0) ghz = mhz / 1000.0;
+        }
+    }
+    cores = coresPerSocket * sockets;
+
+    QRegularExpression speedRe("@\\s*([0-9.]+)\\s*GHz");
+    QRegularExpressionMatch match = speedRe.match(modelName);
+    if (ghz == 0.0 && match.hasMatch()) ghz = match.captured(1).toDouble();
+    modelName.replace(QRegularExpression("\\(R\\)"), "");
+    modelName.replace(QRegularExpression("\\(TM\\)"), "");
+    modelName.replace("CPU", "", Qt::CaseInsensitive);
+    modelName.replace(QRegularExpression("@.*"), "");
+    modelName = modelName.trimmed();
+}
+
+QString cleanModelName(QString modelName) {
+    modelName.replace(QRegularExpression("\\(R\\)"), "");
+    modelName.replace(QRegularExpression("\\(TM\\)"), "");
+    modelName.replace("CPU", "", Qt::CaseInsensitive);
+    modelName.replace(QRegularExpression("@.*"), "");
+    return modelName.simplified();
+}
+
+QString joinVendorDevice(const QString &vendor, const QString &device) {
+    if (device.startsWith(vendor, Qt::CaseInsensitive)) return device;
+    return vendor + " " + device;
+}
+
+bool parseLspci(const QString &output, QString &vendor, QString &device) {
+    const QStringList blocks = output.split("\n\n");
+    for (const QString &block : blocks) {
+        if (block.contains("VGA compatible controller") || block.contains("3D controller")) {
+            const QStringList lines = block.split('\n');
+            for (const QString &line : lines) {
+                if (line.startsWith("Vendor:")) vendor = line.section(':', 1).trimmed();
+                if (line.startsWith("Device:")) device = line.section(':', 1).trimmed();
+            }
+            if (!vendor.isEmpty() && !device.isEmpty()) return true;
+        }
+    }
+    return false;
+}
+
+}
+
+struct Result {
+    QString name;
+    double mbPerSec = 0.0;
+    double nsPerParse = 0.0;
+    double allocsPerParse = 0.0;
+};
+
+// volatile sink so the optimiser can't drop a parse
+volatile size_t g_sink = 0;
+
+Result run(const QString &name, size_t bytes, int iterations, const std::function<void()> &parse) {
+    parse(); // warm-up
+
+    const unsigned long long allocsBefore = g_allocations.load();
+    QElapsedTimer t;
+    t.start();
+    for (int i = 0; i < iterations; ++i) parse();
+    const qint64 ns = t.nsecsElapsed();
+    const unsigned long long allocs = g_allocations.load() - allocsBefore;
+
+    Result r;
+    r.name = name;
+    r.nsPerParse = double(ns) / iterations;
+    r.mbPerSec = ns > 0 ? (double(bytes) * iterations / 1e6) / (ns / 1e9) : 0.0;
+    r.allocsPerParse = double(allocs) / iterations;
+    return r;
+}
+
+QByteArray readInput(const QString &path) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return QByteArray();
+    return f.readAll();
+}
+
+struct Name {
+    bool cpu = true;
+    QByteArray vendor;   // model name for CPUs
+    QByteArray device;
+    QByteArray expected; // empty: not a golden entry
+};
+
+// "cpu\t<model>\t<expected>" or "gpu\t<vendor>\t<device>\t<expected>"
+QVector<Name> readGolden(const QString &path) {
+    QVector<Name> names;
+    for (const QByteArray &line : readInput(path).split('\n')) {
+        if (line.isEmpty() || line.startsWith('#')) continue;
+        const QList<QByteArray> f = line.split('\t');
+        Name name;
+        name.cpu = f.value(0) == "cpu";
+        if (name.cpu && f.size() == 3) {
+            name.vendor = f[1];
+            name.expected = f[2];
+        } else if (!name.cpu && f.size() == 4) {
+            name.vendor = f[1];
+            name.device = f[2];
+            name.expected = f[3];
+        } else {
+            continue;
+        }
+        names.append(name);
+    }
+    return names;
+}
+
+// Every vendor/device pair in pci.ids: vendors at column 0, their devices
+// indented by one tab. Classes ("C xx") end the device list.
+QVector<Name> readPciIds(const QString &path) {
+    QVector<Name> names;
+    QByteArray vendor;
+    for (const QByteArray &line : readInput(path).split('\n')) {
+        if (line.isEmpty() || line.startsWith('#')) continue;
+        if (line.startsWith("C ")) break;
+        if (line[0] != '\t') {
+            vendor = line.mid(4).trimmed();
+        } else if (line.size() > 6 && line[1] != '\t') {
+            Name name;
+            name.cpu = false;
+            name.vendor = vendor;
+            name.device = line.mid(6).trimmed();
+            names.append(name);
+        }
+    }
+    return names;
+}
+
+std::string_view view(const QByteArray &b) {
+    return std::string_view(b.constData(), size_t(b.size()));
+}
+
+void normalize(const Name &name, Hardware::Native::NameBuffer &out) {
+    if (name.cpu) Hardware::Native::normalizeCpuName(view(name.vendor), out);
+    else Hardware::Native::normalizeGpuName(view(name.vendor), view(name.device), out);
+}
+
+// Prints each name whose display name isn't the expected one; the count.
+int checkGolden(const QVector<Name> &names, QTextStream &out) {
+    int mismatches = 0;
+    for (const Name &name : names) {
+        Hardware::Native::NameBuffer result;
+        normalize(name, result);
+        if (view(name.expected) == result.view()) continue;
+        ++mismatches;
+        out << "names: " << name.vendor << (name.cpu ? "" : " | ") << name.device << "\n"
+            << "   got \"" << QByteArray(result.data, int(result.size)) << "\", expected \""
+            << name.expected << "\"\n";
+    }
+    return mismatches;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Throughput and allocations of the lscpu/lspci parsers.");
+    parser.addHelpOption();
+    QCommandLineOption rootOption("root", "Captured tree holding tools/lscpu.txt and tools/lspci-vmm.txt.", "dir",
+                                  "bench/fixtures/sample");
+    QCommandLineOption repeatOption("repeat", "Pad each input to this many copies (default 64).", "n", "64");
+    QCommandLineOption iterOption("iterations", "Parses per measurement (default 2000).", "n", "2000");
+    QCommandLineOption namesOption("names", "Golden display names to check and time.", "file",
+                                   "bench/fixtures/names.tsv");
+    QCommandLineOption corpusOption("corpus", "Larger hand-checked name corpus, same columns as --names.", "file",
+                                    "bench/fixtures/names-corpus.tsv");
+    QCommandLineOption pciIdsOption("pci-ids", "Also time every vendor/device name in this pci.ids.", "file");
+    parser.addOption(rootOption);
+    parser.addOption(repeatOption);
+    parser.addOption(iterOption);
+    parser.addOption(namesOption);
+    parser.addOption(corpusOption);
+    parser.addOption(pciIdsOption);
+    parser.process(app);
+
+    const QString root = parser.value(rootOption);
+    const int repeat = qMax(1, parser.value(repeatOption).toInt());
+    const int iterations = qMax(1, parser.value(iterOption).toInt());
+
+    const QByteArray lscpuOne = readInput(root + "/tools/lscpu.txt");
+    const QByteArray lspciOne = readInput(root + "/tools/lspci-vmm.txt");
+    if (lscpuOne.isEmpty() || lspciOne.isEmpty()) {
+        QTextStream(stderr) << "No tools/lscpu.txt or tools/lspci-vmm.txt under " << root << "\n";
+        return 1;
+    }
+
+    // lscpu: the whole listing repeated (last value wins, every line is seen).
+    // lspci: non-display devices in front, so the scan has to walk past them
+    // to reach the GPU the way it would on a server with hundreds of functions.
+    QByteArray lscpu;
+    for (int i = 0; i < repeat; ++i) lscpu += lscpuOne;
+    const int gpu = lspciOne.indexOf("Class:\tVGA");
+    const QByteArray filler = gpu < 0 ? lspciOne : lspciOne.left(lspciOne.lastIndexOf("\n\n", gpu) + 2);
+    QByteArray lspciFiller;
+    for (int i = 0; i < repeat; ++i) lspciFiller += filler;
+    const QByteArray lspci = lspciFiller + lspciOne;
+
+    const QString lscpuText = QString::fromUtf8(lscpu);
+    const QString lspciText = QString::fromUtf8(lspci);
+
+    std::vector<Result> results;
+
+    results.push_back(run("lscpu  string_view", size_t(lscpu.size()), iterations, [&]() {
+        using namespace Hardware::Native;
+        LscpuFacts facts;
+        parseLscpu(std::string_view(lscpu.constData(), size_t(lscpu.size())), facts);
+        g_sink = g_sink + facts.modelName.size() + size_t(facts.sockets) + size_t(ghzFromModelName(facts.modelName));
+    }));
+    results.push_back(run("lscpu  QString (before)", size_t(lscpu.size()), iterations, [&]() {
+        QString model;
+        int cores = 0;
+        double ghz = 0.0;
+        Before::parseLscpu(lscpuText, model, cores, ghz);
+        g_sink = g_sink + size_t(model.size()) + size_t(cores);
+    }));
+    results.push_back(run("lspci  string_view", size_t(lspci.size()), iterations, [&]() {
+        Hardware::Native::LspciDevice gpu;
+        Hardware::Native::parseLspciGraphics(std::string_view(lspci.constData(), size_t(lspci.size())), gpu);
+        g_sink = g_sink + gpu.vendor.size() + gpu.device.size();
+    }));
+    results.push_back(run("lspci  QString (before)", size_t(lspci.size()), iterations, [&]() {
+        QString vendor, device;
+        Before::parseLspci(lspciText, vendor, device);
+        g_sink = g_sink + size_t(vendor.size() + device.size());
+    }));
+
+    QByteArray flags;
+    const QByteArray cpuinfo = readInput(root + "/proc/cpuinfo");
+    const int flagsAt = cpuinfo.indexOf("\nflags");
+    if (flagsAt >= 0) {
+        const int colon = cpuinfo.indexOf(':', flagsAt);
+        flags = cpuinfo.mid(colon + 1, cpuinfo.indexOf('\n', colon) - colon - 1).trimmed();
+    }
+    if (!flags.isEmpty()) {
+        results.push_back(run("isa    cpuinfo flags", size_t(flags.size()), iterations, [&]() {
+            g_sink = g_sink + Hardware::Native::isaFeaturesFromFlags(std::string_view(flags.constData(), size_t(flags.size())));
+        }));
+    }
+    results.push_back(run("isa    cpuid (this host)", 0, iterations, [&]() {
+        Hardware::Native::IsaFacts facts;
+        Hardware::Native::probeIsa(facts);
+        g_sink = g_sink + facts.features + facts.caches.size();
+    }));
+
+    // Display names: golden check first, so a bad table row fails the run.
+    QTextStream out(stdout);
+    const QVector<Name> golden = readGolden(parser.value(namesOption));
+    const QVector<Name> handChecked = readGolden(parser.value(corpusOption));
+    const int mismatches = checkGolden(golden, out) + checkGolden(handChecked, out);
+
+    QVector<Name> corpus = golden + handChecked;
+    if (parser.isSet(pciIdsOption)) corpus += readPciIds(parser.value(pciIdsOption));
+    size_t corpusBytes = 0;
+    for (const Name &name : corpus) corpusBytes += size_t(name.vendor.size() + name.device.size());
+    QVector<QPair<QString, QString>> corpusText;
+    for (const Name &name : corpus) corpusText.append({ QString::fromUtf8(name.vendor), QString::fromUtf8(name.device) });
+    const int nameIterations = qMax(1, iterations / qMax(1, corpus.size() / 64));
+
+    if (!corpus.isEmpty()) {
+        results.push_back(run("names  tables", corpusBytes, nameIterations, [&]() {
+            Hardware::Native::NameBuffer result;
+            for (const Name &name : corpus) {
+                normalize(name, result);
+                g_sink = g_sink + result.size;
+            }
+        }));
+        results.push_back(run("names  regex (before)", corpusBytes, nameIterations, [&]() {
+            for (int i = 0; i < corpus.size(); ++i) {
+                const QString name = corpus[i].cpu ? Before::cleanModelName(corpusText[i].first)
+                                                   : Before::joinVendorDevice(corpusText[i].first, corpusText[i].second);
+                g_sink = g_sink + size_t(name.size());
+            }
+        }));
+    }
+
+    out << "inputs: lscpu " << lscpu.size() << " bytes, lspci -vmm " << lspci.size() << " bytes\n";
+    out << "names: " << golden.size() + handChecked.size() << " golden (" << mismatches << " wrong), " << corpus.size()
+        << " timed; the names rows are per pass over all of them\n";
+    out << "(the string_view rows exclude the final QString/std::string copy of the kept fields)\n\n";
+    out << QString("%1 %2 %3 %4\n").arg("", -26).arg("MB/s", 10).arg("ns/parse", 12).arg("allocs/parse", 14);
+    for (const Result &r : results) {
+        out << QString("%1 %2 %3 %4\n")
+                   .arg(r.name, -26)
+                   .arg(QString::number(r.mbPerSec, 'f', 1), 10)
+                   .arg(QString::number(r.nsPerParse, 'f', 0), 12)
+                   .arg(QString::number(r.allocsPerParse, 'f', 1), 14);
+    }
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,207 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+// Startup latency benchmark.
+//
+// Times every Hardware probe on its own, the whole set sequentially and in
+// parallel, and the window's time to first frame and to fully populated
+// rows. Point it at a captured tree with --root to get numbers that don't
+// depend on the machine it runs on:
+//
+//   QT_QPA_PLATFORM=offscreen ./probebench --root ../bench/fixtures/sample
+//
+
+#include "hardware.h"
+#include "mainwindow.h"
+#include "probeengine.h"
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QEventLoop>
+#include <QTextStream>
+#include <QTimer>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace {
+
+struct Stats {
+    QString name;
+    std::vector<qint64> samples;   // nanoseconds
+
+    qint64 percentile(double p) const {
+        if (samples.empty()) return 0;
+        std::vector<qint64> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        size_t rank = size_t(p / 100.0 * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+};
+
+Stats measure(const QString &name, int iterations, const std::function<void()> &fn) {
+    Stats s;
+    s.name = name;
+    s.samples.reserve(size_t(iterations));
+
+    fn(); // warm-up: page cache, pci.ids mapping, dynamic loader
+    QElapsedTimer t;
+    for (int i = 0; i < iterations; ++i) {
+        t.start();
+        fn();
+        s.samples.push_back(t.nsecsElapsed());
+    }
+    return s;
+}
+
+void printHeader(QTextStream &out) {
+    out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+               .arg("", -28).arg("n", 6).arg("min", 10).arg("p50", 10)
+               .arg("p90", 10).arg("p99", 10).arg("max", 10);
+}
+
+void printRow(QTextStream &out, const Stats &s) {
+    auto us = [](qint64 ns) { return QString::number(ns / 1000.0, 'f', 1); };
+    out << QString("%1 %2 %3 %4 %5 %6 %7\n")
+               .arg(s.name, -28)
+               .arg(int(s.samples.size()), 6)
+               .arg(us(s.percentile(0)), 10)
+               .arg(us(s.percentile(50)), 10)
+               .arg(us(s.percentile(90)), 10)
+               .arg(us(s.percentile(99)), 10)
+               .arg(us(s.percentile(100)), 10);
+}
+
+// Watches a freshly shown window for its first paint.
+class FirstFrameFilter : public QObject
+{
+public:
+    bool painted = false;
+    qint64 paintedAt = 0;
+    const QElapsedTimer *clock = nullptr;
+    QEventLoop *loop = nullptr;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override {
+        if (event->type() == QEvent::Paint && !painted) {
+            painted = true;
+            paintedAt = clock->nsecsElapsed();
+            if (loop) loop->quit();
+        }
+        return QObject::eventFilter(watched, event);
+    }
+};
+
+void measureWindow(int iterations, Stats &firstFrame, Stats &populated) {
+    for (int i = 0; i < iterations; ++i) {
+        QElapsedTimer clock;
+        QEventLoop loop;
+        FirstFrameFilter filter;
+        filter.clock = &clock;
+        filter.loop = &loop;
+
+        clock.start();
+        MainWindow *w = new MainWindow;
+        w->installEventFilter(&filter);
+
+        qint64 doneAt = -1;
+        QObject::connect(w->probeEngine(), &ProbeEngine::allFinished, &loop, [&]() {
+            doneAt = clock.nsecsElapsed();
+            if (filter.painted) loop.quit();
+        });
+
+        w->show();
+        QTimer::singleShot(60000, &loop, &QEventLoop::quit); // never hang the run
+        while (!filter.painted || doneAt < 0) {
+            if (loop.exec() != 0) break;
+            if (clock.elapsed() >= 60000) break;
+        }
+
+        if (filter.painted) firstFrame.samples.push_back(filter.paintedAt);
+        if (doneAt >= 0) populated.samples.push_back(doneAt);
+
+        w->removeEventFilter(&filter);
+        delete w;
+    }
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    // The engine inside MainWindow must see this before it's constructed.
+    qputenv("ABOUTTHISSYN_NO_CACHE", "1");
+
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Per-probe and window startup latency for AboutThisSyn.");
+    parser.addHelpOption();
+    QCommandLineOption rootOption("root", "Probe a captured tree instead of the live machine.", "dir");
+    QCommandLineOption iterOption("iterations", "Iterations per probe (default 200).", "n", "200");
+    QCommandLineOption windowIterOption("window-iterations", "Windows to open (default 20, 0 to skip).", "n", "20");
+    QCommandLineOption backendOption("backend", "native, legacy or both (default both).", "name", "both");
+    parser.addOption(rootOption);
+    parser.addOption(iterOption);
+    parser.addOption(windowIterOption);
+    parser.addOption(backendOption);
+    parser.process(app);
+
+    if (parser.isSet(rootOption)) Hardware::setSysRoot(parser.value(rootOption));
+
+    const int iterations = qMax(1, parser.value(iterOption).toInt());
+    const int windowIterations = qMax(0, parser.value(windowIterOption).toInt());
+    const QString which = parser.value(backendOption);
+
+    QTextStream out(stdout);
+    out << "root: " << (Hardware::sysRoot().isEmpty() ? QString("/ (live)") : Hardware::sysRoot()) << "\n";
+    out << "times in microseconds\n\n";
+
+    QVector<QPair<Hardware::Backend, QString>> backends;
+    if (which != "legacy") backends.append(qMakePair(Hardware::Backend::Native, QString("native")));
+    if (which != "native") backends.append(qMakePair(Hardware::Backend::Legacy, QString("legacy")));
+
+    for (const auto &b : backends) {
+        Hardware::setBackend(b.first);
+        out << "[" << b.second << "]\n";
+        printHeader(out);
+
+        std::vector<Stats> rows;
+        rows.push_back(measure("os", iterations, [] { Hardware::probeOS(); }));
+        rows.push_back(measure("cpu", iterations, [] { Hardware::probeProcessor(); }));
+        rows.push_back(measure("memory", iterations, [] { Hardware::probeMemory(); }));
+        rows.push_back(measure("graphics", iterations, [] { Hardware::probeGraphics(); }));
+        rows.push_back(measure("disk", iterations, [] { Hardware::probeStartupDisk(); }));
+        rows.push_back(measure("total (sequential)", iterations, [] {
+            Hardware::probeOS();
+            Hardware::probeProcessor();
+            Hardware::probeMemory();
+            Hardware::probeGraphics();
+            Hardware::probeStartupDisk();
+        }));
+        rows.push_back(measure("total (parallel)", iterations, [] { Hardware::probeAll(); }));
+
+        for (const Stats &s : rows) printRow(out, s);
+        out << "\n";
+        out.flush();
+    }
+
+    if (windowIterations > 0) {
+        Hardware::setBackend(Hardware::Backend::Native);
+        Stats firstFrame;
+        firstFrame.name = "window first frame";
+        Stats populated;
+        populated.name = "window all rows filled";
+        measureWindow(windowIterations, firstFrame, populated);
+
+        out << "[window]\n";
+        printHeader(out);
+        printRow(out, firstFrame);
+        printRow(out, populated);
+    }
+
+    return 0;
+}
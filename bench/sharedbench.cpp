@@ -0,0 +1,157 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+// Shared-memory snapshot benchmark.
+//
+// Publishes one host's snapshot into a private segment, then has --readers
+// threads read it back as fast as they can for --seconds while the publisher
+// rewrites it --rate times a second, and compares that with what each reader
+// would pay to probe for itself:
+//
+//   probeAll()      one full probe of the tree, what every agent does today
+//   shared read     seqlock copy out of the segment
+//   shared decode   copy + Binary::Reader + toSnapshot() (Qt structs)
+//
+//   ./sharedbench --root ../bench/fixtures/sample --readers 8 --rate 100
+//
+
+#include "hardware.h"
+#include "sharedsnapshot.h"
+#include "snapshotfile.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct ReaderStats {
+    uint64_t reads = 0;
+    uint64_t failed = 0;
+    uint64_t changes = 0;
+    double ns = 0.0;
+};
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Read cost of the shared snapshot segment under concurrent publishing.");
+    parser.addHelpOption();
+    QCommandLineOption rootOption("root", "Captured tree to probe for the snapshot.", "dir",
+                                  "bench/fixtures/sample");
+    QCommandLineOption readersOption("readers", "Reader threads (default 4).", "n", "4");
+    QCommandLineOption rateOption("rate", "Publishes per second while reading (default 100).", "n", "100");
+    QCommandLineOption secondsOption("seconds", "How long to read for (default 2).", "n", "2");
+    QCommandLineOption decodeOption("decode", "Readers also decode into Hardware::Snapshot.");
+    parser.addOption(rootOption);
+    parser.addOption(readersOption);
+    parser.addOption(rateOption);
+    parser.addOption(secondsOption);
+    parser.addOption(decodeOption);
+    parser.process(app);
+
+    const int readers = qMax(1, parser.value(readersOption).toInt());
+    const int rate = qMax(0, parser.value(rateOption).toInt());
+    const int seconds = qMax(1, parser.value(secondsOption).toInt());
+    const bool decode = parser.isSet(decodeOption);
+
+    Hardware::setSysRoot(parser.value(rootOption));
+    QElapsedTimer probeTimer;
+    probeTimer.start();
+    const Hardware::Snapshot snapshot = Hardware::probeAll();
+    const double probeMs = probeTimer.nsecsElapsed() / 1e6;
+
+    Hardware::Binary::Writer writer;
+    writer.add("bench", snapshot);
+    const QByteArray bytes = writer.toByteArray();
+
+    const std::string name = "/aboutthissyn-bench-" + std::to_string(::getpid());
+    Hardware::Shared::Publisher publisher;
+    std::string error;
+    if (!publisher.open(name, Hardware::Shared::kDefaultCapacity, &error)) {
+        QTextStream(stderr) << "Can't create " << QString::fromStdString(name) << ": "
+                            << QString::fromStdString(error) << "\n";
+        return 1;
+    }
+    publisher.publish(bytes.constData(), size_t(bytes.size()));
+
+    std::atomic<bool> stop{false};
+    std::vector<ReaderStats> stats(size_t(readers));
+    std::vector<std::thread> threads;
+    for (int i = 0; i < readers; ++i) {
+        threads.emplace_back([&, i]() {
+            Hardware::Shared::Subscriber subscriber;
+            if (!subscriber.open(name)) return;
+            std::vector<char> buffer;
+            uint64_t last = 0;
+            ReaderStats &s = stats[size_t(i)];
+            const auto start = std::chrono::steady_clock::now();
+            while (!stop.load(std::memory_order_relaxed)) {
+                uint64_t sequence = 0;
+                if (!subscriber.read(&buffer, &sequence)) {
+                    ++s.failed;
+                    continue;
+                }
+                if (decode) {
+                    Hardware::Binary::Reader reader;
+                    if (reader.openBuffer(buffer.data(), buffer.size()) && !reader.hosts().empty()) {
+                        const Hardware::Snapshot copy = Hardware::Binary::toSnapshot(reader, reader.hosts()[0]);
+                        if (copy.processor.model.isEmpty()) ++s.failed;
+                    }
+                }
+                if (sequence != last) ++s.changes;
+                last = sequence;
+                ++s.reads;
+            }
+            s.ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        });
+    }
+
+    // Republish the same bytes: readers can't tell, but they still have to
+    // get past every write.
+    const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    uint64_t publishes = 0;
+    while (std::chrono::steady_clock::now() < end) {
+        if (rate > 0) {
+            publisher.publish(bytes.constData(), size_t(bytes.size()));
+            ++publishes;
+            std::this_thread::sleep_for(std::chrono::microseconds(1000000 / rate));
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    stop = true;
+    for (std::thread &t : threads) t.join();
+    publisher.close();
+
+    uint64_t reads = 0, failed = 0, changes = 0;
+    double ns = 0.0;
+    for (const ReaderStats &s : stats) {
+        reads += s.reads;
+        failed += s.failed;
+        changes += s.changes;
+        ns += s.ns;
+    }
+
+    QTextStream out(stdout);
+    out << "snapshot " << bytes.size() << " bytes, " << readers << " readers, "
+        << publishes << " publishes over " << seconds << " s\n\n";
+    out << QString("%1 %2\n").arg("probeAll()", -16).arg(QString::number(probeMs * 1000.0, 'f', 1) + " us");
+    out << QString("%1 %2\n")
+               .arg(decode ? "shared decode" : "shared read", -16)
+               .arg(QString::number(reads ? ns / double(reads) : 0.0, 'f', 1) + " ns");
+    out << "\nreads " << reads << " (" << QString::number(double(reads) / seconds, 'f', 0) << "/s), "
+        << "gave up " << failed << ", saw " << changes << " sequence changes\n";
+    return 0;
+}
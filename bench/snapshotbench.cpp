@@ -0,0 +1,167 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+// Snapshot loading benchmark.
+//
+// Probes one captured tree, writes it out as a fleet of --hosts copies in both
+// the binary snapshot format and NDJSON (as --batch prints it), then times
+// getting through each file:
+//
+//   read()        just reading the bytes, the I/O floor
+//   binary walk   mmap + touching every record and string (zero-copy)
+//   binary copy   mmap + toSnapshot() for every host (Qt structs)
+//   ndjson        QJsonDocument::fromJson per line
+//
+//   ./snapshotbench --root ../bench/fixtures/sample --hosts 100000
+//
+
+#include "hardware.h"
+#include "snapshotfile.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <fcntl.h>
+#include <functional>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct Result {
+    QString name;
+    double ms = 0.0;
+    double mbPerSec = 0.0;
+    double hostsPerSec = 0.0;
+};
+
+// volatile sink so the optimiser can't drop the work
+volatile size_t g_sink = 0;
+
+Result run(const QString &name, qint64 bytes, int hosts, const std::function<void()> &load) {
+    load(); // warm the page cache, so every row measures the same thing
+    QElapsedTimer t;
+    t.start();
+    load();
+    const qint64 ns = qMax<qint64>(1, t.nsecsElapsed());
+
+    Result r;
+    r.name = name;
+    r.ms = ns / 1e6;
+    r.mbPerSec = (double(bytes) / 1e6) / (ns / 1e9);
+    r.hostsPerSec = double(hosts) / (ns / 1e9);
+    return r;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Load time of binary snapshot files against NDJSON.");
+    parser.addHelpOption();
+    QCommandLineOption rootOption("root", "Captured tree to probe for the host record.", "dir",
+                                  "bench/fixtures/sample");
+    QCommandLineOption hostsOption("hosts", "Hosts in the generated fleet (default 100000).", "n", "100000");
+    parser.addOption(rootOption);
+    parser.addOption(hostsOption);
+    parser.process(app);
+
+    const int hosts = qMax(1, parser.value(hostsOption).toInt());
+    Hardware::setSysRoot(parser.value(rootOption));
+    Hardware::Snapshot snapshot = Hardware::probeAll();
+    snapshot.startupDisk = Hardware::DiskInfo();
+    snapshot.storage.volumes.clear();
+
+    QTemporaryDir dir;
+    const QString binaryPath = dir.filePath("fleet.atss");
+    const QString jsonPath = dir.filePath("fleet.ndjson");
+
+    Hardware::Binary::Writer writer;
+    QFile json(jsonPath);
+    if (!dir.isValid() || !json.open(QIODevice::WriteOnly)) {
+        QTextStream(stderr) << "Can't write to a temporary directory\n";
+        return 1;
+    }
+    for (int i = 0; i < hosts; ++i) {
+        const QString name = QString("host%1").arg(i, 6, 10, QChar('0'));
+        writer.add(name, snapshot);
+
+        QJsonObject o = Hardware::toJson(snapshot);
+        o["host"] = name;
+        json.write(QJsonDocument(o).toJson(QJsonDocument::Compact));
+        json.write("\n");
+    }
+    json.close();
+    if (!writer.save(binaryPath)) {
+        QTextStream(stderr) << "Couldn't write " << binaryPath << "\n";
+        return 1;
+    }
+
+    const qint64 binaryBytes = QFileInfo(binaryPath).size();
+    const qint64 jsonBytes = QFileInfo(jsonPath).size();
+
+    auto readAll = [](const QString &path) {
+        int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        std::vector<char> buf(1 << 20);
+        ssize_t n;
+        while ((n = ::read(fd, buf.data(), buf.size())) > 0) g_sink = g_sink + size_t(n) + size_t(buf[0]);
+        ::close(fd);
+    };
+
+    std::vector<Result> results;
+    results.push_back(run("binary read()", binaryBytes, hosts, [&]() { readAll(binaryPath); }));
+    results.push_back(run("binary walk", binaryBytes, hosts, [&]() {
+        using namespace Hardware::Binary;
+        Reader reader;
+        if (!reader.open(binaryPath.toStdString())) return;
+        size_t sum = 0;
+        for (const HostRecord &host : reader.hosts()) {
+            sum += reader.string(host.name).size() + reader.string(host.osPrettyName).size();
+            for (const CpuRecord &cpu : reader.cpus(host)) sum += reader.string(cpu.model).size() + cpu.physicalCores;
+            for (const DimmRecord &d : reader.dimms(host)) sum += reader.string(d.type).size() + d.speedMts;
+            for (const GpuRecord &g : reader.gpus(host)) sum += reader.string(g.name).size() + g.deviceId;
+            for (const DiskRecord &d : reader.disks(host)) sum += reader.string(d.model).size() + d.bytesTotal;
+        }
+        g_sink = g_sink + sum;
+    }));
+    results.push_back(run("binary copy", binaryBytes, hosts, [&]() {
+        using namespace Hardware::Binary;
+        Reader reader;
+        if (!reader.open(binaryPath.toStdString())) return;
+        for (const HostRecord &host : reader.hosts()) {
+            const Hardware::Snapshot s = toSnapshot(reader, host);
+            g_sink = g_sink + size_t(s.processor.model.size());
+        }
+    }));
+    results.push_back(run("ndjson read()", jsonBytes, hosts, [&]() { readAll(jsonPath); }));
+    results.push_back(run("ndjson parse", jsonBytes, hosts, [&]() {
+        QFile f(jsonPath);
+        if (!f.open(QIODevice::ReadOnly)) return;
+        while (!f.atEnd()) {
+            const QJsonDocument doc = QJsonDocument::fromJson(f.readLine());
+            g_sink = g_sink + size_t(doc.object().size());
+        }
+    }));
+
+    QTextStream out(stdout);
+    out << hosts << " hosts: binary " << binaryBytes << " bytes, ndjson " << jsonBytes << " bytes\n\n";
+    out << QString("%1 %2 %3 %4\n").arg("", -16).arg("ms", 10).arg("MB/s", 10).arg("hosts/s", 14);
+    for (const Result &r : results) {
+        out << QString("%1 %2 %3 %4\n")
+                   .arg(r.name, -16)
+                   .arg(QString::number(r.ms, 'f', 1), 10)
+                   .arg(QString::number(r.mbPerSec, 'f', 0), 10)
+                   .arg(QString::number(r.hostsPerSec, 'f', 0), 14);
+    }
+    return 0;
+}
@@ -0,0 +1,189 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+// CPU/NUMA topology read benchmark.
+//
+// Builds a synthetic sysfs tree for a big machine (--cpus threads across
+// --nodes nodes, --smt threads per core) and times Native::probeProcessor()
+// over it with the batched reader forced to each backend:
+//
+//   pread      open/pread/close per file, what the probe did before
+//   io_uring   OPENAT, READ and CLOSE for up to 256 files per submission
+//
+//   ./topobench --cpus 4096 --nodes 16 --smt 2 --repeat 20
+//   ./topobench --live            (this machine's /sys instead)
+//
+// A tmpfs or ext4 tree isn't sysfs (no kernfs locking, no show() callbacks),
+// so the synthetic numbers show syscall overhead; --live is the real thing.
+//
+
+#include "hardware_p.h"
+#include "sysfs.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+bool writeFile(const QString &path, const QByteArray &data) {
+    QDir().mkpath(path.section('/', 0, -2));
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    return file.write(data) == data.size();
+}
+
+QByteArray range(int first, int last) {
+    return first == last ? QByteArray::number(first) + '\n'
+                         : QByteArray::number(first) + '-' + QByteArray::number(last) + '\n';
+}
+
+// cpuN is thread N / cores of core N % cores, the way Linux numbers SMT
+// siblings on x86. Packages and nodes split the cores evenly.
+bool buildTree(const QString &root, int cpus, int nodes, int smt) {
+    const int cores = cpus / smt;
+    const int coresPerNode = qMax(1, cores / nodes);
+    const QString cpuDir = root + "/sys/devices/system/cpu";
+    const QString nodeDir = root + "/sys/devices/system/node";
+
+    for (int cpu = 0; cpu < cpus; ++cpu) {
+        const int core = cpu % cores;
+        const int node = qMin(nodes - 1, core / coresPerNode);
+        const QString dir = cpuDir + "/cpu" + QString::number(cpu);
+
+        QByteArray siblings;
+        for (int t = 0; t < smt; ++t) siblings += (t ? "," : "") + QByteArray::number(core + t * cores);
+        bool ok = writeFile(dir + "/topology/physical_package_id", QByteArray::number(node) + '\n')
+               && writeFile(dir + "/topology/core_id", QByteArray::number(core % coresPerNode) + '\n')
+               && writeFile(dir + "/topology/thread_siblings_list", siblings + '\n')
+               && writeFile(dir + "/cpufreq/cpuinfo_max_freq", "3500000\n");
+
+        // One L3 per node; L1/L2 per core.
+        const char *levels[] = { "1", "1", "2", "3" };
+        const char *types[] = { "Data\n", "Instruction\n", "Unified\n", "Unified\n" };
+        for (int i = 0; i < 4 && ok; ++i) {
+            const QString index = dir + "/cache/index" + QString::number(i);
+            const QByteArray shared = i < 3 ? siblings + '\n'
+                                            : range(node * coresPerNode, node * coresPerNode + coresPerNode - 1);
+            ok = writeFile(index + "/level", QByteArray(levels[i]) + '\n')
+              && writeFile(index + "/type", types[i])
+              && writeFile(index + "/shared_cpu_list", shared);
+        }
+        if (!ok) return false;
+    }
+
+    for (int node = 0; node < nodes; ++node) {
+        const QString dir = nodeDir + "/node" + QString::number(node);
+        QByteArray cpulist;
+        for (int t = 0; t < smt; ++t) {
+            const int first = node * coresPerNode + t * cores;
+            const QByteArray r = range(first, first + coresPerNode - 1);
+            cpulist += (t ? "," : "") + r.left(r.size() - 1);
+        }
+        QByteArray distance;
+        for (int other = 0; other < nodes; ++other) distance += (other ? " " : "") + QByteArray(other == node ? "10" : "21");
+        const QByteArray prefix = "Node " + QByteArray::number(node) + ' ';
+        const QByteArray meminfo = prefix + "MemTotal:       65536000 kB\n" + prefix + "MemFree:        60000000 kB\n";
+        if (!writeFile(dir + "/cpulist", cpulist + '\n') || !writeFile(dir + "/distance", distance + '\n')
+            || !writeFile(dir + "/meminfo", meminfo))
+            return false;
+    }
+
+    return writeFile(root + "/proc/cpuinfo", "processor\t: 0\nmodel name\t: Synthetic CPU @ 3.50GHz\n");
+}
+
+struct Result {
+    std::vector<double> ms;
+    Hardware::Native::ProcessorFacts facts;
+    bool ok = true;
+};
+
+Result run(Hardware::SysFs::BatchMode mode, int repeat) {
+    Hardware::SysFs::setBatchMode(mode);
+    Result result;
+    Hardware::Native::probeProcessor(result.facts); // warm the dentry cache and the ring
+    for (int i = 0; i < repeat; ++i) {
+        QElapsedTimer timer;
+        timer.start();
+        result.ok = Hardware::Native::probeProcessor(result.facts) && result.ok;
+        result.ms.push_back(timer.nsecsElapsed() / 1e6);
+    }
+    std::sort(result.ms.begin(), result.ms.end());
+    return result;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Topology probe cost with the pread and io_uring batch readers.");
+    parser.addHelpOption();
+    QCommandLineOption cpusOption("cpus", "Logical CPUs in the synthetic tree (default 4096).", "n", "4096");
+    QCommandLineOption nodesOption("nodes", "NUMA nodes (default 16).", "n", "16");
+    QCommandLineOption smtOption("smt", "Threads per core (default 2).", "n", "2");
+    QCommandLineOption repeatOption("repeat", "Timed probes per backend (default 20).", "n", "20");
+    QCommandLineOption liveOption("live", "Probe this machine's /sys rather than a synthetic tree.");
+    parser.addOption(cpusOption);
+    parser.addOption(nodesOption);
+    parser.addOption(smtOption);
+    parser.addOption(repeatOption);
+    parser.addOption(liveOption);
+    parser.process(app);
+
+    const int smt = qMax(1, parser.value(smtOption).toInt());
+    const int cpus = qMax(smt, parser.value(cpusOption).toInt() / smt * smt);
+    const int nodes = qBound(1, parser.value(nodesOption).toInt(), cpus / smt);
+    const int repeat = qMax(1, parser.value(repeatOption).toInt());
+
+    QTextStream out(stdout);
+    QTemporaryDir dir;
+    if (!parser.isSet(liveOption)) {
+        QElapsedTimer build;
+        build.start();
+        if (!dir.isValid() || !buildTree(dir.path(), cpus, nodes, smt)) {
+            QTextStream(stderr) << "Can't build the synthetic tree under " << dir.path() << "\n";
+            return 1;
+        }
+        Hardware::SysFs::setRoot(dir.path().toStdString());
+        out << "synthetic tree: " << cpus << " CPUs, " << nodes << " nodes, SMT" << smt
+            << " (built in " << build.elapsed() << " ms)\n";
+    } else {
+        out << "live /sys\n";
+    }
+
+    const Result pread = run(Hardware::SysFs::BatchMode::Pread, repeat);
+    const Result uring = run(Hardware::SysFs::BatchMode::Uring, repeat);
+
+    const Hardware::Native::ProcessorFacts &f = pread.facts;
+    out << f.logicalCpus << " threads, " << f.physicalCores << " cores, " << f.sockets << " packages, "
+        << f.nodes.size() << " nodes, " << f.llcDomains << " LLC domains\n\n";
+    if (!pread.ok || !uring.ok) out << "(probeProcessor() reported failure)\n";
+
+    // Files per probe: 5 per CPU with a cache dir, plus 3 per node.
+    const double files = double(f.threads.size()) * 5 + double(f.nodes.size()) * 3;
+    out << QString("%1 %2 %3 %4 %5\n").arg("backend", -10).arg("min", 10).arg("median", 10).arg("max", 10).arg("files/s", 12);
+    for (const Result *r : { &pread, &uring }) {
+        const double median = r->ms[r->ms.size() / 2];
+        out << QString("%1 %2 %3 %4 %5\n")
+                   .arg(r->facts.reader ? r->facts.reader : "?", -10)
+                   .arg(QString::number(r->ms.front(), 'f', 2) + " ms", 10)
+                   .arg(QString::number(median, 'f', 2) + " ms", 10)
+                   .arg(QString::number(r->ms.back(), 'f', 2) + " ms", 10)
+                   .arg(QString::number(median > 0 ? files / median * 1000.0 : 0.0, 'f', 0), 12);
+    }
+    out << "\nspeedup " << QString::number(uring.ms[uring.ms.size() / 2] > 0
+                                               ? pread.ms[pread.ms.size() / 2] / uring.ms[uring.ms.size() / 2]
+                                               : 0.0, 'f', 2)
+        << "x\n";
+    return 0;
+}
@@ -0,0 +1,91 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+// Hotplug replay.
+//
+// Runs the probe engine once, then plays a recorded uevent stream through
+// UEventMonitor over a socketpair, exactly as the window wires it up, and
+// prints which rows were re-probed and what they now say:
+//
+//   udevadm monitor --kernel --property > hotplug.txt   # on a real machine
+//   ./ueventreplay --root ../bench/fixtures/sample --recording hotplug.txt
+//
+
+#include "hardware.h"
+#include "probeengine.h"
+#include "ueventmonitor.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMetaEnum>
+#include <QTextStream>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replays recorded uevents and reports which probes re-ran.");
+    parser.addHelpOption();
+    QCommandLineOption rootOption("root", "Captured tree to probe (default: this machine).", "dir");
+    QCommandLineOption recordingOption("recording", "Recorded uevent stream.", "file",
+                                       "bench/fixtures/uevents/hotplug.txt");
+    parser.addOption(rootOption);
+    parser.addOption(recordingOption);
+    parser.process(app);
+
+    if (parser.isSet(rootOption)) Hardware::setSysRoot(parser.value(rootOption));
+
+    QTextStream out(stdout);
+    const QMetaEnum probeNames = QMetaEnum::fromType<ProbeEngine::Probe>();
+
+    ProbeEngine engine;
+    engine.setCacheEnabled(false);
+    UEventMonitor monitor;
+
+    int reprobes = 0;
+    bool replaying = false;
+    bool replayDone = false;
+    QElapsedTimer clock;
+
+    auto maybeQuit = [&]() {
+        if (replayDone && engine.isAllFinished()) app.quit();
+    };
+
+    QObject::connect(&monitor, &UEventMonitor::probeInvalidated, &engine, [&](ProbeEngine::Probe probe) {
+        ++reprobes;
+        out << "invalidated " << probeNames.valueToKey(probe) << "\n";
+        engine.invalidate(probe);
+    });
+    QObject::connect(&engine, &ProbeEngine::probeFinished, &app, [&](ProbeEngine::Probe probe, const QString &value) {
+        if (!replaying) return;
+        out << "  " << probeNames.valueToKey(probe) << " -> " << QString(value).replace('\n', "; ")
+            << "  (" << clock.elapsed() << " ms)\n";
+    });
+    QObject::connect(&engine, &ProbeEngine::allFinished, &app, [&]() {
+        if (!replaying) {
+            replaying = true;
+            clock.start();
+            if (!monitor.openReplay(parser.value(recordingOption))) {
+                QTextStream(stderr) << "Can't replay " << parser.value(recordingOption) << "\n";
+                app.exit(1);
+            }
+            return;
+        }
+        maybeQuit();
+    });
+    QObject::connect(&monitor, &UEventMonitor::replayFinished, &app, [&]() {
+        replayDone = true;
+        maybeQuit();
+    });
+
+    engine.start();
+    const int rc = app.exec();
+    if (rc != 0) return rc;
+
+    out << "\n" << monitor.eventsSeen() << " events, " << reprobes << " probes re-run ("
+        << monitor.eventsSeen() * int(ProbeEngine::ProbeCount) << " for a full re-probe per event)\n";
+    return 0;
+}
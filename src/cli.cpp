@@ -0,0 +1,254 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "cli.h"
+#include "fleet.h"
+#include "hardware.h"
+#include "snapshotfile.h"
+#include "snapshotpublisher.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QSocketNotifier>
+#include <QSysInfo>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <QtConcurrent>
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace Cli {
+
+namespace {
+
+const char *const kFields[] = { "os", "cpu", "memory", "graphics", "disk", "storage" };
+
+bool isKnownField(const QString &field) {
+    for (const char *f : kFields) {
+        if (field == QLatin1String(f)) return true;
+    }
+    return false;
+}
+
+// SIGTERM/SIGINT end --publish through the event loop, so the segment is
+// marked stale and unlinked rather than left behind.
+int g_quitPipe[2] = { -1, -1 };
+
+void quitOnSignal(int) {
+    const char c = 1;
+    (void)!::write(g_quitPipe[1], &c, 1);
+}
+
+int publish(QCoreApplication &app, const QString &name) {
+    SnapshotPublisher publisher;
+    QString error;
+    if (!publisher.start(name, &error)) {
+        QTextStream(stderr) << "Can't publish: " << error << "\n";
+        return 1;
+    }
+
+    if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, g_quitPipe) == 0) {
+        QSocketNotifier *notifier = new QSocketNotifier(g_quitPipe[0], QSocketNotifier::Read, &app);
+        QObject::connect(notifier, &QSocketNotifier::activated, &app, &QCoreApplication::quit);
+        std::signal(SIGTERM, quitOnSignal);
+        std::signal(SIGINT, quitOnSignal);
+    }
+
+    const int rc = app.exec();
+    publisher.stop();
+    return rc;
+}
+
+}
+
+bool isHeadless(int argc, char *argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0) return true;
+        if (std::strncmp(argv[i], "--field", 7) == 0) return true;
+        if (std::strncmp(argv[i], "--batch", 7) == 0) return true;
+        if (std::strncmp(argv[i], "--write-snapshot", 16) == 0) return true;
+        if (std::strcmp(argv[i], "--publish") == 0) return true;
+    }
+    return false;
+}
+
+int run(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("AboutThisSyn");
+    app.setOrganizationName("Syndromatic");
+    app.setOrganizationDomain("syndromatic.com");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Prints the hardware inventory shown by About This Computer.");
+    parser.addHelpOption();
+    QCommandLineOption jsonOption("json", "Print the inventory as JSON.");
+    QCommandLineOption fieldOption("field",
+        "Only probe and print <field>: os, cpu, memory, graphics, disk or storage. May be repeated or comma-separated.",
+        "field");
+    QCommandLineOption traceOption("trace", "Write a Chrome trace of the probes to <file>.", "file");
+    QCommandLineOption batchOption("batch",
+        "Analyse every captured host under <path> (a directory or tar archive of capture-sysroot.sh trees, "
+        "or a binary snapshot file), "
+        "printing a JSON line per host and a summary.",
+        "path");
+    QCommandLineOption jobsOption("jobs", "Worker threads for --batch (default: one per CPU).", "n");
+    QCommandLineOption summaryOption("summary-only", "With --batch, print only the fleet summary.");
+    QCommandLineOption writeOption("write-snapshot",
+        "Write the probe results to <file> in the binary snapshot format; with --batch, every host's.", "file");
+    QCommandLineOption measureOption("measure",
+        "Also measure memory bandwidth and latency. Keeps every CPU busy for a few seconds.");
+    parser.addOption(jsonOption);
+    parser.addOption(fieldOption);
+    parser.addOption(traceOption);
+    parser.addOption(batchOption);
+    parser.addOption(jobsOption);
+    parser.addOption(summaryOption);
+    parser.addOption(writeOption);
+    QCommandLineOption diskBenchOption("disk-bench",
+        "Also measure startup disk read throughput with O_DIRECT reads. Raw devices usually need root.");
+    QCommandLineOption diskBenchPathOption("disk-bench-path",
+        "Benchmark <path> (a block device or a regular file) instead of the startup disk. Implies --disk-bench.",
+        "path");
+    QCommandLineOption publishOption("publish",
+        "Stay resident, publishing the probe results to shared memory for other processes "
+        "(this card included) and updating them when the hardware changes.");
+    QCommandLineOption shmNameOption("shm-name",
+        QString("Shared memory segment for --publish (default %1).").arg(Hardware::Shared::kDefaultName), "name");
+    parser.addOption(measureOption);
+    parser.addOption(diskBenchOption);
+    parser.addOption(diskBenchPathOption);
+    parser.addOption(publishOption);
+    parser.addOption(shmNameOption);
+    parser.process(app);
+
+    if (parser.isSet(publishOption)) {
+        return publish(app, parser.isSet(shmNameOption) ? parser.value(shmNameOption)
+                                                        : QString::fromLatin1(Hardware::Shared::kDefaultName));
+    }
+
+    if (parser.isSet(batchOption)) {
+        Hardware::Fleet::Options options;
+        options.input = parser.value(batchOption);
+        options.jobs = parser.value(jobsOption).toInt();
+        options.records = !parser.isSet(summaryOption);
+        options.binaryOutput = parser.value(writeOption);
+        return Hardware::Fleet::analyze(options, stdout, stderr);
+    }
+
+    if (parser.isSet(writeOption)) {
+        Hardware::Binary::Writer writer;
+        writer.add(QSysInfo::machineHostName(), Hardware::probeAll());
+        QString error;
+        if (!writer.save(parser.value(writeOption), &error)) {
+            QTextStream(stderr) << "Couldn't write " << parser.value(writeOption) << ": " << error << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    QStringList fields;
+    for (const QString &value : parser.values(fieldOption)) {
+        for (const QString &f : value.split(',')) {
+            if (f.isEmpty()) continue;
+            if (!isKnownField(f)) {
+                QTextStream(stderr) << "Unknown field: " << f << "\n";
+                return 2;
+            }
+            if (!fields.contains(f)) fields << f;
+        }
+    }
+    if (fields.isEmpty()) {
+        for (const char *f : kFields) fields << QString::fromLatin1(f);
+    }
+
+    // Only run what was asked for, all at once.
+    QFuture<Hardware::OSInfo> os;
+    QFuture<Hardware::ProcessorInfo> cpu;
+    QFuture<Hardware::MemoryInfo> mem;
+    QFuture<Hardware::GraphicsInfo> gfx;
+    QFuture<Hardware::DiskInfo> disk;
+    QFuture<Hardware::StorageInfo> storage;
+    if (fields.contains("os")) os = QtConcurrent::run(&Hardware::probeOS);
+    if (fields.contains("cpu")) cpu = QtConcurrent::run(&Hardware::probeProcessor);
+    if (fields.contains("memory")) mem = QtConcurrent::run(&Hardware::probeMemory);
+    if (fields.contains("graphics")) gfx = QtConcurrent::run(&Hardware::probeGraphics);
+    if (fields.contains("disk")) disk = QtConcurrent::run(&Hardware::probeStartupDisk);
+    if (fields.contains("storage")) storage = QtConcurrent::run(&Hardware::probeStorage);
+
+    // After the probes, so the cores it saturates don't slow them down.
+    Hardware::MemoryMeasurement measured;
+    Hardware::DiskBenchmark diskBench;
+    const bool measure = parser.isSet(measureOption) && fields.contains("memory");
+    const bool benchDisk = (parser.isSet(diskBenchOption) || parser.isSet(diskBenchPathOption))
+                           && fields.contains("disk");
+    if (measure || benchDisk) {
+        os.waitForFinished();
+        cpu.waitForFinished();
+        mem.waitForFinished();
+        gfx.waitForFinished();
+        disk.waitForFinished();
+        storage.waitForFinished();
+    }
+    if (measure) measured = Hardware::measureMemory();
+    if (benchDisk) {
+        diskBench = parser.isSet(diskBenchPathOption)
+                        ? Hardware::benchmarkDisk(parser.value(diskBenchPathOption))
+                        : Hardware::benchmarkStartupDisk();
+        if (!diskBench.error.isEmpty()) {
+            QTextStream(stderr) << "Disk benchmark of " << diskBench.target << " failed: " << diskBench.error << "\n";
+        }
+    }
+
+    QTextStream out(stdout);
+
+    if (parser.isSet(jsonOption)) {
+        QJsonObject o;
+        for (const QString &f : fields) {
+            if (f == "os") o["os"] = Hardware::toJson(os.result());
+            else if (f == "cpu") o["cpu"] = Hardware::toJson(cpu.result());
+            else if (f == "memory") {
+                QJsonObject memory = Hardware::toJson(mem.result());
+                if (measure) memory["measured"] = Hardware::toJson(measured);
+                o["memory"] = memory;
+            }
+            else if (f == "graphics") o["graphics"] = Hardware::toJson(gfx.result());
+            else if (f == "disk") {
+                QJsonObject d = Hardware::toJson(disk.result());
+                if (benchDisk) d["benchmark"] = Hardware::toJson(diskBench);
+                o["disk"] = d;
+            }
+            else if (f == "storage") o["storage"] = Hardware::toJson(storage.result());
+        }
+        out << QJsonDocument(o).toJson(QJsonDocument::Indented);
+        return 0;
+    }
+
+    // Plain mode: the card strings, one per line, in the order asked for.
+    // A single field prints bare so it can be used in shell scripts.
+    for (const QString &f : fields) {
+        QString value;
+        if (f == "os") value = Hardware::formatOSVersion(os.result());
+        else if (f == "cpu") value = Hardware::formatProcessor(cpu.result());
+        else if (f == "memory") {
+            value = Hardware::formatMemory(mem.result());
+            const QString line = Hardware::formatMeasuredMemory(measured);
+            if (!line.isEmpty()) value += '\n' + line;
+        }
+        else if (f == "graphics") value = Hardware::formatGraphics(gfx.result());
+        else if (f == "disk") {
+            value = Hardware::formatStartupDisk(disk.result());
+            const QString line = Hardware::formatDiskBenchmark(diskBench);
+            if (!line.isEmpty()) value += '\n' + line;
+        }
+        else if (f == "storage") value = Hardware::formatStorage(storage.result());
+
+        if (fields.size() == 1) out << value << "\n";
+        else out << f << ": " << value.replace('\n', "; ") << "\n";
+    }
+    return 0;
+}
+
+}
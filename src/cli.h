@@ -0,0 +1,21 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef CLI_H
+#define CLI_H
+
+// Headless inventory mode: `AboutThisSyn --json` or `--field cpu`, and fleet
+// analysis with `--batch <dir>`. Runs on a QCoreApplication so no display,
+// platform plugin or widget is ever touched.
+namespace Cli {
+
+// Cheap argv scan done before any QApplication exists.
+bool isHeadless(int argc, char *argv[]);
+
+int run(int argc, char *argv[]);
+
+}
+
+#endif // CLI_H
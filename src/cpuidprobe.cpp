@@ -0,0 +1,311 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "hardware_p.h"
+#include "sysfs.h"
+#include "textscan.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define ATS_HAVE_CPUID 1
+#endif
+
+namespace Hardware {
+namespace Native {
+
+namespace {
+
+struct IsaName {
+    uint32_t feature;
+    const char *name;           // what we show
+    const char *flag;           // what /proc/cpuinfo calls it
+};
+
+const IsaName kIsaNames[] = {
+    { IsaSse2,       "SSE2",         "sse2" },
+    { IsaSse3,       "SSE3",         "pni" },
+    { IsaSsse3,      "SSSE3",        "ssse3" },
+    { IsaSse41,      "SSE4.1",       "sse4_1" },
+    { IsaSse42,      "SSE4.2",       "sse4_2" },
+    { IsaPopcnt,     "POPCNT",       "popcnt" },
+    { IsaAes,        "AES-NI",       "aes" },
+    { IsaSha,        "SHA",          "sha_ni" },
+    { IsaBmi1,       "BMI1",         "bmi1" },
+    { IsaBmi2,       "BMI2",         "bmi2" },
+    { IsaAvx,        "AVX",          "avx" },
+    { IsaF16c,       "F16C",         "f16c" },
+    { IsaFma,        "FMA3",         "fma" },
+    { IsaAvx2,       "AVX2",         "avx2" },
+    { IsaAvxVnni,    "AVX-VNNI",     "avx_vnni" },
+    { IsaAvx512F,    "AVX-512F",     "avx512f" },
+    { IsaAvx512Cd,   "AVX-512CD",    "avx512cd" },
+    { IsaAvx512Dq,   "AVX-512DQ",    "avx512dq" },
+    { IsaAvx512Bw,   "AVX-512BW",    "avx512bw" },
+    { IsaAvx512Vl,   "AVX-512VL",    "avx512vl" },
+    { IsaAvx512Vnni, "AVX-512 VNNI", "avx512_vnni" },
+    { IsaAvx512Bf16, "AVX-512 BF16", "avx512_bf16" },
+    { IsaAmxTile,    "AMX-TILE",     "amx_tile" },
+    { IsaAmxInt8,    "AMX-INT8",     "amx_int8" },
+    { IsaAmxBf16,    "AMX-BF16",     "amx_bf16" },
+};
+
+const char *const kCpu0CacheDir = "/sys/devices/system/cpu/cpu0/cache";
+
+// Hybrid parts register one PMU per core type, each listing its CPUs.
+void readHybridCounts(IsaFacts &facts) {
+    std::string list;
+    if (SysFs::readLine("/sys/devices/cpu_core/cpus", list)) facts.performanceCpus = Text::countList(list);
+    if (SysFs::readLine("/sys/devices/cpu_atom/cpus", list)) facts.efficiencyCpus = Text::countList(list);
+    if (facts.performanceCpus > 0 && facts.efficiencyCpus > 0) facts.hybrid = true;
+}
+
+// cpu0/cache/index*: what the kernel decoded from the same cpuid leaves (or
+// from the device tree on other architectures).
+void readSysfsCaches(IsaFacts &facts) {
+    const std::string base(kCpu0CacheDir);
+    std::string path, value;
+    for (const std::string &index : SysFs::listNumbered(base, "index")) {
+        const std::string dir = base + '/' + index;
+        CacheLevel cache;
+
+        long long n = 0;
+        path = dir + "/level";
+        if (!SysFs::readLong(path, n)) continue;
+        cache.level = int(n);
+
+        path = dir + "/type";
+        if (SysFs::readLine(path, value)) {
+            if (value == "Data") cache.type = 'D';
+            else if (value == "Instruction") cache.type = 'I';
+        }
+
+        // "32K", "12288K"; a few arches say "1M"
+        path = dir + "/size";
+        if (SysFs::readLine(path, value) && Text::toLong(value, n)) {
+            cache.sizeKb = uint32_t(value.back() == 'M' ? n * 1024 : n);
+        }
+
+        path = dir + "/ways_of_associativity";
+        if (SysFs::readLong(path, n)) cache.ways = int(n);
+        path = dir + "/coherency_line_size";
+        if (SysFs::readLong(path, n)) cache.lineBytes = int(n);
+        path = dir + "/shared_cpu_list";
+        if (SysFs::readLine(path, value)) cache.sharedBy = Text::countList(value);
+
+        facts.caches.push_back(cache);
+    }
+}
+
+// vendor, family/model/stepping and flags from the first cpuinfo block.
+bool readCpuInfo(IsaFacts &facts) {
+    std::string text;
+    if (!SysFs::readFile("/proc/cpuinfo", text, 16384)) return false;
+
+    Text::LineReader lines(text);
+    std::string_view line, value;
+    long long n = 0;
+    bool sawFlags = false;
+    while (lines.next(line)) {
+        if (line.empty()) break;    // end of cpu0
+        if (Text::valueFor(line, "vendor_id", ':', value)) facts.vendor = std::string(value);
+        else if (Text::valueFor(line, "cpu family", ':', value) && Text::toLong(value, n)) facts.family = int(n);
+        else if (Text::valueFor(line, "model", ':', value) && Text::toLong(value, n)) facts.model = int(n);
+        else if (Text::valueFor(line, "stepping", ':', value) && Text::toLong(value, n)) facts.stepping = int(n);
+        else if (Text::valueFor(line, "flags", ':', value)) {
+            facts.features = isaFeaturesFromFlags(value);
+            sawFlags = true;
+        }
+    }
+    return sawFlags;
+}
+
+#ifdef ATS_HAVE_CPUID
+
+struct Regs {
+    uint32_t eax = 0, ebx = 0, ecx = 0, edx = 0;
+};
+
+Regs cpuid(uint32_t leaf, uint32_t subleaf = 0) {
+    Regs r;
+    __cpuid_count(leaf, subleaf, r.eax, r.ebx, r.ecx, r.edx);
+    return r;
+}
+
+uint64_t xgetbv0() {
+    uint32_t lo = 0, hi = 0;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (uint64_t(hi) << 32) | lo;
+}
+
+inline bool bit(uint32_t reg, int n) {
+    return (reg >> n) & 1u;
+}
+
+// Leaf 4 (Intel) and 0x8000001D (AMD) share a layout: one subleaf per cache
+// until the type field reads 0.
+void readCacheLeaf(uint32_t leaf, IsaFacts &facts) {
+    for (uint32_t i = 0; i < 16; ++i) {
+        const Regs r = cpuid(leaf, i);
+        const uint32_t type = r.eax & 0x1f;
+        if (type == 0) break;
+
+        CacheLevel cache;
+        cache.level = int((r.eax >> 5) & 0x7);
+        cache.type = type == 1 ? 'D' : type == 2 ? 'I' : 'U';
+        cache.lineBytes = int((r.ebx & 0xfff) + 1);
+        const uint32_t partitions = ((r.ebx >> 12) & 0x3ff) + 1;
+        cache.ways = int((r.ebx >> 22) + 1);
+        const uint64_t sets = uint64_t(r.ecx) + 1;
+        cache.sizeKb = uint32_t(uint64_t(cache.ways) * partitions * uint32_t(cache.lineBytes) * sets / 1024);
+        cache.sharedBy = int(((r.eax >> 14) & 0xfff) + 1);
+        facts.caches.push_back(cache);
+    }
+}
+
+// Everything cpuid says, for the CPU this happens to run on. Only the
+// hybrid core type differs between CPUs, and that's what sysfs is for.
+IsaFacts decodeCpuid() {
+    IsaFacts facts;
+    uint32_t maxLeaf = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(0, &maxLeaf, &ebx, &ecx, &edx)) return facts;
+    facts.source = IsaFacts::Cpuid;
+
+    char vendor[13] = {};
+    std::memcpy(vendor, &ebx, 4);
+    std::memcpy(vendor + 4, &edx, 4);
+    std::memcpy(vendor + 8, &ecx, 4);
+    facts.vendor = vendor;
+
+    const Regs l1 = maxLeaf >= 1 ? cpuid(1) : Regs();
+    const int baseFamily = int((l1.eax >> 8) & 0xf);
+    const int baseModel = int((l1.eax >> 4) & 0xf);
+    facts.family = baseFamily == 0xf ? baseFamily + int((l1.eax >> 20) & 0xff) : baseFamily;
+    facts.model = (baseFamily == 0x6 || baseFamily == 0xf) ? (int((l1.eax >> 16) & 0xf) << 4) | baseModel : baseModel;
+    facts.stepping = int(l1.eax & 0xf);
+
+    // Register state the kernel saves on context switch. Without it the
+    // instructions fault, whatever the feature bits claim.
+    const uint64_t xcr0 = bit(l1.ecx, 27) ? xgetbv0() : 0;     // OSXSAVE
+    const bool ymm = (xcr0 & 0x6) == 0x6;
+    const bool zmm = (xcr0 & 0xe6) == 0xe6;
+    const bool tiles = (xcr0 & 0x60000) == 0x60000;
+
+    uint32_t f = 0;
+    if (bit(l1.edx, 26)) f |= IsaSse2;
+    if (bit(l1.ecx, 0))  f |= IsaSse3;
+    if (bit(l1.ecx, 9))  f |= IsaSsse3;
+    if (bit(l1.ecx, 19)) f |= IsaSse41;
+    if (bit(l1.ecx, 20)) f |= IsaSse42;
+    if (bit(l1.ecx, 23)) f |= IsaPopcnt;
+    if (bit(l1.ecx, 25)) f |= IsaAes;
+    if (ymm && bit(l1.ecx, 28)) f |= IsaAvx;
+    if (ymm && bit(l1.ecx, 29)) f |= IsaF16c;
+    if (ymm && bit(l1.ecx, 12)) f |= IsaFma;
+
+    if (maxLeaf >= 7) {
+        const Regs l7 = cpuid(7, 0);
+        if (bit(l7.ebx, 3))  f |= IsaBmi1;
+        if (bit(l7.ebx, 8))  f |= IsaBmi2;
+        if (bit(l7.ebx, 29)) f |= IsaSha;
+        if (ymm && bit(l7.ebx, 5)) f |= IsaAvx2;
+        if (zmm) {
+            if (bit(l7.ebx, 16)) f |= IsaAvx512F;
+            if (bit(l7.ebx, 28)) f |= IsaAvx512Cd;
+            if (bit(l7.ebx, 17)) f |= IsaAvx512Dq;
+            if (bit(l7.ebx, 30)) f |= IsaAvx512Bw;
+            if (bit(l7.ebx, 31)) f |= IsaAvx512Vl;
+            if (bit(l7.ecx, 11)) f |= IsaAvx512Vnni;
+        }
+        if (tiles) {
+            if (bit(l7.edx, 24)) f |= IsaAmxTile;
+            if (bit(l7.edx, 25)) f |= IsaAmxInt8;
+            if (bit(l7.edx, 22)) f |= IsaAmxBf16;
+        }
+        facts.hybrid = bit(l7.edx, 15);
+
+        if (l7.eax >= 1) {
+            const Regs l71 = cpuid(7, 1);
+            if (ymm && bit(l71.eax, 4)) f |= IsaAvxVnni;
+            if (zmm && bit(l71.eax, 5)) f |= IsaAvx512Bf16;
+        }
+    }
+    facts.features = f;
+
+    uint32_t maxExtended = 0;
+    __get_cpuid(0x80000000, &maxExtended, &ebx, &ecx, &edx);
+    if (maxExtended >= 0x80000004) {
+        char brand[49] = {};
+        for (uint32_t i = 0; i < 3; ++i) {
+            const Regs r = cpuid(0x80000002 + i);
+            std::memcpy(brand + i * 16, &r.eax, 4);
+            std::memcpy(brand + i * 16 + 4, &r.ebx, 4);
+            std::memcpy(brand + i * 16 + 8, &r.ecx, 4);
+            std::memcpy(brand + i * 16 + 12, &r.edx, 4);
+        }
+        facts.brand = std::string(Text::trimmed(brand));
+    }
+
+    if (facts.vendor == "AuthenticAMD" || facts.vendor == "HygonGenuine") {
+        // topology extensions (0x80000001 ECX bit 22) gate the cache leaf
+        if (maxExtended >= 0x8000001d && bit(cpuid(0x80000001).ecx, 22)) readCacheLeaf(0x8000001d, facts);
+    } else if (maxLeaf >= 4) {
+        readCacheLeaf(4, facts);
+    }
+
+    return facts;
+}
+
+#endif
+
+}
+
+const char *isaFeatureName(uint32_t feature) {
+    for (const IsaName &n : kIsaNames) {
+        if (n.feature == feature) return n.name;
+    }
+    return nullptr;
+}
+
+uint32_t isaFeaturesFromFlags(std::string_view flags) {
+    uint32_t features = 0;
+    while (!flags.empty()) {
+        const size_t space = flags.find(' ');
+        const std::string_view flag = flags.substr(0, space);
+        flags = space == std::string_view::npos ? std::string_view() : flags.substr(space + 1);
+        for (const IsaName &n : kIsaNames) {
+            if (flag == n.flag) {
+                features |= n.feature;
+                break;
+            }
+        }
+    }
+    return features;
+}
+
+bool probeIsa(IsaFacts &facts) {
+    facts = IsaFacts();
+
+#ifdef ATS_HAVE_CPUID
+    // cpuid describes the machine we run on, which isn't the one in a sysroot.
+    if (SysFs::root().empty()) {
+        static const IsaFacts decoded = decodeCpuid();
+        facts = decoded;
+    }
+#endif
+
+    if (facts.source == IsaFacts::None) {
+        if (readCpuInfo(facts)) facts.source = IsaFacts::CpuInfo;
+    }
+    // Hypervisors often hide leaf 4; the kernel's view is the next best thing.
+    if (facts.caches.empty()) readSysfsCaches(facts);
+
+    if (facts.source == IsaFacts::CpuInfo || facts.hybrid) readHybridCounts(facts);
+    return facts.source != IsaFacts::None || !facts.caches.empty();
+}
+
+}
+}
@@ -0,0 +1,194 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "hardware_p.h"
+#include "sysfs.h"
+#include "textscan.h"
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace Hardware {
+namespace Native {
+
+namespace {
+
+const char *const kCpuDir = "/sys/devices/system/cpu";
+const char *const kNodeDir = "/sys/devices/system/node";
+
+// Per-CPU attributes, in the order they're queued. The last-level cache one
+// is only there if cpu0 has a cache directory.
+enum CpuFile {
+    PackageId,
+    CoreId,
+    ThreadSiblings,
+    MaxFreq,
+    LlcShared,
+    CpuFileCount
+};
+
+enum NodeFile {
+    NodeCpuList,
+    NodeMemInfo,
+    NodeDistance,
+    NodeFileCount
+};
+
+// Pulls the first "model name" out of /proc/cpuinfo. Every CPU repeats the
+// same block, so only the head of the file is read.
+std::string readModelName() {
+    std::string text;
+    if (!SysFs::readFile("/proc/cpuinfo", text, 8192)) return std::string();
+
+    // "model name\t: Intel(R) Core(TM) i5-8400 CPU @ 2.80GHz"
+    Text::LineReader lines(text);
+    std::string_view line, value;
+    while (lines.next(line)) {
+        if (Text::valueFor(line, "model name", ':', value)) return std::string(value);
+    }
+    return std::string();
+}
+
+bool longFrom(const SysFs::BatchRead &file, long long &value) {
+    return file.ok && Text::toLong(file.data, value);
+}
+
+// "Node 0 MemTotal:       32768000 kB"
+uint64_t nodeMemKb(std::string_view meminfo, std::string_view key) {
+    Text::LineReader lines(meminfo);
+    std::string_view line;
+    while (lines.next(line)) {
+        const size_t at = line.find(key);
+        if (at == std::string_view::npos || at + key.size() >= line.size() || line[at + key.size()] != ':') continue;
+        long long kb = 0;
+        if (Text::toLong(line.substr(at + key.size() + 1), kb) && kb > 0) return uint64_t(kb);
+        return 0;
+    }
+    return 0;
+}
+
+void parseNode(NumaNode &node, const SysFs::BatchRead *files) {
+    node.cpuList = std::string(Text::trimmed(files[NodeCpuList].data));
+    node.cpus = Text::countList(node.cpuList);
+    node.memTotalBytes = nodeMemKb(files[NodeMemInfo].data, "MemTotal") * 1024;
+    node.memFreeBytes = nodeMemKb(files[NodeMemInfo].data, "MemFree") * 1024;
+
+    // "10 21" on two sockets
+    std::string_view rest = Text::trimmed(files[NodeDistance].data);
+    while (!rest.empty()) {
+        long long d = 0;
+        if (!Text::toLong(rest, d)) break;
+        node.distances.push_back(int(d));
+        const size_t space = rest.find(' ');
+        rest = space == std::string_view::npos ? std::string_view() : Text::trimmed(rest.substr(space));
+    }
+}
+
+}
+
+bool probeProcessor(ProcessorFacts &facts) {
+    facts = ProcessorFacts();
+
+    const std::string base(kCpuDir);
+    const std::vector<std::string> cpus = SysFs::listNumbered(base, "cpu");
+    if (cpus.empty()) return false;
+    const std::vector<std::string> nodes = SysFs::listNumbered(kNodeDir, "node");
+
+    // The kernel lists cache indexes L1 first, so the last one is the LLC.
+    // Reading cpu0's directory once saves a listing per CPU.
+    const std::vector<std::string> cacheIndexes = SysFs::listNumbered(base + "/cpu0/cache", "index");
+    const std::string llc = cacheIndexes.empty() ? std::string() : "/cache/" + cacheIndexes.back() + "/shared_cpu_list";
+    const size_t perCpu = llc.empty() ? LlcShared : CpuFileCount;
+
+    std::vector<SysFs::BatchRead> files(cpus.size() * perCpu + nodes.size() * NodeFileCount);
+    SysFs::BatchRead *f = files.data();
+    for (const std::string &cpu : cpus) {
+        const std::string dir = base + '/' + cpu;
+        f[PackageId].path = dir + "/topology/physical_package_id";
+        f[CoreId].path = dir + "/topology/core_id";
+        f[ThreadSiblings].path = dir + "/topology/thread_siblings_list";
+        f[MaxFreq].path = dir + "/cpufreq/cpuinfo_max_freq";
+        if (!llc.empty()) f[LlcShared].path = dir + llc;
+        f += perCpu;
+    }
+    for (const std::string &node : nodes) {
+        const std::string dir = std::string(kNodeDir) + '/' + node;
+        f[NodeCpuList].path = dir + "/cpulist";
+        f[NodeMemInfo].path = dir + "/meminfo";
+        f[NodeDistance].path = dir + "/distance";
+        f += NodeFileCount;
+    }
+    facts.reader = SysFs::readBatch(files);
+
+    // Count distinct core IDs per package rather than trusting cpu0's
+    // siblings, so SMT and asymmetric packages on 256-thread boxes add up.
+    std::vector<std::pair<long long, long long>> cores;
+    std::vector<long long> packages;
+    std::vector<std::string_view> llcLists;
+    cores.reserve(cpus.size());
+    facts.threads.reserve(cpus.size());
+
+    long long maxKhz = 0;
+    f = files.data();
+    for (size_t i = 0; i < cpus.size(); ++i, f += perCpu) {
+        long long package = -1, core = -1;
+        if (!longFrom(f[PackageId], package)) continue; // offline
+        if (!longFrom(f[CoreId], core)) continue;
+
+        cores.emplace_back(package, core);
+        packages.push_back(package);
+        facts.logicalCpus++;
+
+        long long khz = 0;
+        if (longFrom(f[MaxFreq], khz) && khz > maxKhz) maxKhz = khz;
+        if (f[ThreadSiblings].ok) facts.threadsPerCore = std::max(facts.threadsPerCore, Text::countList(f[ThreadSiblings].data));
+        if (!llc.empty() && f[LlcShared].ok) llcLists.push_back(Text::trimmed(f[LlcShared].data));
+
+        CpuThread thread;
+        thread.cpu = std::atoi(cpus[i].c_str() + 3);
+        thread.package = int(package);
+        thread.core = int(core);
+        thread.maxKhz = khz;
+        facts.threads.push_back(thread);
+    }
+
+    if (cores.empty()) return false;
+
+    std::sort(cores.begin(), cores.end());
+    cores.erase(std::unique(cores.begin(), cores.end()), cores.end());
+    std::sort(packages.begin(), packages.end());
+    packages.erase(std::unique(packages.begin(), packages.end()), packages.end());
+    std::sort(llcLists.begin(), llcLists.end());
+    llcLists.erase(std::unique(llcLists.begin(), llcLists.end()), llcLists.end());
+
+    facts.physicalCores = int(cores.size());
+    facts.sockets = int(packages.size());
+    facts.llcDomains = int(llcLists.size());
+    facts.maxMhz = maxKhz / 1000.0;
+
+    // Nodes, and each thread's node from their CPU lists. Threads are in cpuN
+    // order, so a binary search finds them.
+    for (size_t i = 0; i < nodes.size(); ++i, f += NodeFileCount) {
+        if (!f[NodeCpuList].ok && !f[NodeMemInfo].ok) continue;
+        NumaNode node;
+        node.id = std::atoi(nodes[i].c_str() + 4);
+        parseNode(node, f);
+        Text::forEachRange(node.cpuList, [&facts, &node](long long first, long long last) {
+            auto it = std::lower_bound(facts.threads.begin(), facts.threads.end(), first,
+                                       [](const CpuThread &t, long long cpu) { return t.cpu < cpu; });
+            for (; it != facts.threads.end() && it->cpu <= last; ++it) it->node = node.id;
+        });
+        facts.nodes.push_back(std::move(node));
+    }
+
+    // Empty on aarch64 and others: cpuinfo has no "model name" there (lscpu
+    // names the part from its own tables). The topology still stands.
+    facts.modelName = readModelName();
+    return true;
+}
+
+}
+}
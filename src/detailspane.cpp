@@ -0,0 +1,358 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "detailspane.h"
+#include "hardware.h"
+#include "trace.h"
+#include <QFutureWatcher>
+#include <QLabel>
+#include <QLocale>
+#include <QMap>
+#include <QScrollArea>
+#include <QToolButton>
+#include <QVBoxLayout>
+#include <QtConcurrent>
+
+struct DetailsPane::Section
+{
+    ProbeEngine::Probe probe;
+    QString title;
+    QToolButton *header = nullptr;
+    QLabel *body = nullptr;
+    QFutureWatcher<QString> *watcher = nullptr;
+    bool loaded = false;    // body holds a finished table
+    bool stale = false;     // re-probe once the running load lands
+};
+
+namespace {
+
+const char kLeftOut[] = "<p><i>Some details took too long and were left out.</i></p>";
+
+QString cell(const QString &text)
+{
+    return "<td>" + text.toHtmlEscaped() + "</td>";
+}
+
+QString headerRow(const QStringList &columns)
+{
+    QString html = "<tr>";
+    for (const QString &c : columns) html += "<th align=\"left\">" + c.toHtmlEscaped() + "</th>";
+    return html + "</tr>";
+}
+
+QString table(const QString &rows)
+{
+    return "<table cellspacing=\"0\" cellpadding=\"3\">" + rows + "</table>";
+}
+
+QString memorySize(quint64 bytes)
+{
+    return QLocale::c().formattedDataSize(qint64(bytes), 0, QLocale::DataSizeTraditionalFormat);
+}
+
+QString diskSize(quint64 bytes)
+{
+    return QLocale::c().formattedDataSize(qint64(bytes), 1, QLocale::DataSizeSIFormat);
+}
+
+QString orDash(const QString &text)
+{
+    return text.isEmpty() ? QStringLiteral("—") : text;
+}
+
+QString describeProcessor(const Hardware::ProcessorInfo &info)
+{
+    QString html = QString("<p><b>%1</b><br>%2 package%3, %4 cores, %5 threads</p>")
+                       .arg(orDash(info.rawModel).toHtmlEscaped())
+                       .arg(info.sockets).arg(info.sockets == 1 ? "" : "s")
+                       .arg(info.physicalCores).arg(info.logicalCpus);
+    if (info.hybrid) {
+        html += QString("<p>%1 performance, %2 efficiency threads</p>")
+                    .arg(info.performanceCpus).arg(info.efficiencyCpus);
+    }
+    if (!info.caches.isEmpty()) {
+        QStringList caches;
+        for (const Hardware::CpuCache &c : info.caches) {
+            const QString kind = c.type == "Data" ? "d" : c.type == "Instruction" ? "i" : "";
+            caches << QString("L%1%2 %3").arg(c.level).arg(kind).arg(memorySize(quint64(c.sizeKb) * 1024));
+        }
+        html += "<p>Caches: " + caches.join(", ").toHtmlEscaped() + "</p>";
+    }
+    if (!info.isa.isEmpty()) html += "<p>Extensions: " + info.isa.join(", ").toHtmlEscaped() + "</p>";
+    if (info.llcDomains > 1) html += QString("<p>%1 last-level cache domains</p>").arg(info.llcDomains);
+
+    // Memory-only nodes (CXL, HBM) show up here with no CPUs.
+    if (!info.nodes.isEmpty()) {
+        QString rows = headerRow({ "Node", "CPUs", "Memory", "Free", "Distances" });
+        for (const Hardware::NumaNode &n : info.nodes) {
+            QStringList distances;
+            for (int d : n.distances) distances << QString::number(d);
+            rows += "<tr>" + cell(QString::number(n.id)) + cell(orDash(n.cpuList))
+                    + cell(memorySize(n.memoryBytes)) + cell(memorySize(n.freeBytes))
+                    + cell(orDash(distances.join(' '))) + "</tr>";
+        }
+        html += table(rows);
+    }
+    if (info.threads.isEmpty()) return html;
+
+    // One row per physical core, listing the logical CPUs that share it.
+    QMap<QPair<int, int>, QStringList> cpus;
+    QMap<QPair<int, int>, double> ghz;
+    for (const Hardware::CpuThread &t : info.threads) {
+        const QPair<int, int> key(t.package, t.core);
+        cpus[key] << QString::number(t.cpu);
+        ghz[key] = qMax(ghz.value(key), t.maxGhz);
+    }
+
+    QString rows = headerRow({ "Package", "Core", "CPUs", "Max clock" });
+    for (auto it = cpus.constBegin(); it != cpus.constEnd(); ++it) {
+        const double clock = ghz.value(it.key());
+        rows += "<tr>" + cell(QString::number(it.key().first)) + cell(QString::number(it.key().second))
+                + cell(it.value().join(", "))
+                + cell(clock > 0.0 ? QString::number(clock, 'f', 2) + " GHz" : QString("—")) + "</tr>";
+    }
+    return html + table(rows);
+}
+
+QString describeMemory(const Hardware::MemoryInfo &info)
+{
+    QString html = QString("<p>%1 installed</p>").arg(memorySize(info.totalBytes));
+    if (info.modules.isEmpty()) {
+        // /proc/meminfo only knows the total
+        return html + "<p>Per-module details need SMBIOS access.</p>";
+    }
+
+    QString rows = headerRow({ "Slot", "Size", "Type", "Speed", "Manufacturer", "Part" });
+    for (const Hardware::MemoryModule &m : info.modules) {
+        const int mts = m.configuredMts > 0 ? m.configuredMts : m.speedMts;
+        rows += "<tr>" + cell(orDash(m.locator)) + cell(m.sizeBytes ? memorySize(m.sizeBytes) : "Empty")
+                + cell(orDash(m.type)) + cell(mts > 0 ? QString("%1 MT/s").arg(mts) : QString("—"))
+                + cell(orDash(m.manufacturer)) + cell(orDash(m.partNumber)) + "</tr>";
+    }
+    return html + table(rows);
+}
+
+QString describeGraphics(const Hardware::GraphicsInfo &info)
+{
+    if (info.devices.isEmpty()) return "<p>No display controllers found.</p>";
+
+    QString rows = headerRow({ "Slot", "Device", "ID" });
+    for (const Hardware::GraphicsDevice &gpu : info.devices) {
+        QString id;
+        if (gpu.vendorId) id = QString("%1:%2").arg(gpu.vendorId, 4, 16, QChar('0')).arg(gpu.deviceId, 4, 16, QChar('0'));
+        QString name = gpu.name.toHtmlEscaped();
+        if (gpu.bootVga && info.devices.size() > 1) name += " <i>(boot)</i>";
+        rows += "<tr>" + cell(orDash(gpu.slot)) + "<td>" + name + "</td>" + cell(orDash(id)) + "</tr>";
+    }
+    return table(rows);
+}
+
+QString describeStorage(const Hardware::StorageInfo &info)
+{
+    QString html;
+    if (!info.devices.isEmpty()) {
+        QString rows = headerRow({ "Disk", "Model", "Size", "Kind", "Scheduler" });
+        for (const Hardware::StorageDevice &d : info.devices) {
+            QString kind = d.rotational ? "HDD" : "SSD";
+            if (d.removable) kind += ", removable";
+            rows += "<tr>" + cell(d.name) + cell(orDash(QStringList({ d.vendor, d.model }).join(' ').simplified()))
+                    + cell(diskSize(d.bytesTotal)) + cell(kind) + cell(orDash(d.scheduler)) + "</tr>";
+        }
+        html += table(rows);
+    }
+
+    if (!info.volumes.isEmpty()) {
+        QString rows = headerRow({ "Mounted on", "Device", "Type", "Free" });
+        for (const Hardware::Volume &v : info.volumes) {
+            QString free = v.timedOut ? QString("Not responding")
+                                      : QString("%1 of %2").arg(diskSize(v.bytesAvailable), diskSize(v.bytesTotal));
+            rows += "<tr>" + cell(v.mountPoint) + cell(v.device) + cell(v.fileSystem) + cell(free) + "</tr>";
+        }
+        html += "<p></p>" + table(rows);
+    }
+
+    return html.isEmpty() ? QString("<p>No disks found.</p>") : html;
+}
+
+}
+
+DetailsPane::DetailsPane(ProbeEngine *probes, QWidget *parent)
+    : QWidget(parent, Qt::Window)
+    , m_probes(probes)
+{
+    setWindowTitle("More Info");
+    resize(460, 480);
+
+    setupUi();
+
+    connect(m_probes, &ProbeEngine::probeFinished, this, &DetailsPane::applyProbeResult);
+}
+
+DetailsPane::~DetailsPane()
+{
+    // Watchers are children; a load still running finishes into nothing.
+    qDeleteAll(m_sections);
+}
+
+void DetailsPane::setupUi()
+{
+    ATS_TRACE_SPAN("DetailsPane::setupUi", "ui");
+    QVBoxLayout *NSEOuterLayout = new QVBoxLayout(this);
+    NSEOuterLayout->setContentsMargins(0, 0, 0, 0);
+
+    QScrollArea *NSEScroll = new QScrollArea(this);
+    NSEScroll->setWidgetResizable(true);
+    NSEScroll->setFrameShape(QFrame::NoFrame);
+    NSEOuterLayout->addWidget(NSEScroll);
+
+    QWidget *NSEContent = new QWidget(NSEScroll);
+    QVBoxLayout *NSESectionsLayout = new QVBoxLayout(NSEContent);
+    NSESectionsLayout->setContentsMargins(16, 16, 16, 16);
+    NSESectionsLayout->setSpacing(6);
+
+    const QList<QPair<ProbeEngine::Probe, QString>> rows = {
+        { ProbeEngine::Processor, "Processor" },
+        { ProbeEngine::Memory, "Memory" },
+        { ProbeEngine::Graphics, "Graphics" },
+        { ProbeEngine::StartupDisk, "Storage" },
+    };
+
+    for (const auto &row : rows) {
+        Section *s = new Section;
+        s->probe = row.first;
+        s->title = row.second;
+
+        s->header = new QToolButton(NSEContent);
+        s->header->setCheckable(true);
+        s->header->setAutoRaise(true);
+        s->header->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
+        s->header->setArrowType(Qt::RightArrow);
+        s->header->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+        QFont f = s->header->font();
+        f.setBold(true);
+        s->header->setFont(f);
+
+        s->body = new QLabel(NSEContent);
+        s->body->setTextFormat(Qt::RichText);
+        s->body->setTextInteractionFlags(Qt::TextSelectableByMouse);
+        s->body->setWordWrap(true);
+        s->body->setContentsMargins(20, 0, 0, 8);
+        s->body->hide();
+
+        s->watcher = new QFutureWatcher<QString>(this);
+        connect(s->watcher, &QFutureWatcher<QString>::finished, this, [this, s]() {
+            s->body->setText(s->watcher->result());
+            s->loaded = true;
+            if (s->stale) {
+                s->stale = false;
+                load(*s);
+            }
+        });
+        connect(s->header, &QToolButton::toggled, this, [this, s](bool expanded) { setExpanded(*s, expanded); });
+
+        // whatever the card already has; the engine fills in the rest
+        setHeader(*s, m_probes->result(s->probe));
+
+        NSESectionsLayout->addWidget(s->header);
+        NSESectionsLayout->addWidget(s->body);
+        m_sections.append(s);
+    }
+
+    NSESectionsLayout->addStretch();
+    NSEScroll->setWidget(NSEContent);
+}
+
+void DetailsPane::setHeader(Section &section, const QString &value)
+{
+    // the card's summary, one line; GPUs and disks come one per line
+    QString summary = QString(value).replace('\n', ", ");
+    section.header->setText(summary.isEmpty() ? section.title : section.title + ": " + summary);
+}
+
+void DetailsPane::setExpanded(Section &section, bool expanded)
+{
+    section.header->setArrowType(expanded ? Qt::DownArrow : Qt::RightArrow);
+    section.body->setVisible(expanded);
+    if (expanded && !section.loaded) load(section);
+}
+
+void DetailsPane::load(Section &section)
+{
+    const ProbeEngine::Probe probe = section.probe;
+    if (probe != ProbeEngine::StartupDisk) {
+        if (const Hardware::Snapshot *details = m_probes->details(probe)) {
+            section.body->setText(describe(probe, *details, m_probes->isPartial(probe)));
+            section.loaded = true;
+            return;
+        }
+        if (!m_probes->isFinished(probe)) {
+            // the card's probe is still out; its probeFinished brings us back
+            section.body->setText("<i>Loading…</i>");
+            return;
+        }
+    }
+
+    if (section.watcher->isRunning()) {
+        section.stale = true;
+        return;
+    }
+    if (!section.loaded) section.body->setText("<i>Loading…</i>");
+
+    const int deadlineMs = m_probes->deadline(probe);
+    section.watcher->setFuture(QtConcurrent::run([probe, deadlineMs]() { return describe(probe, deadlineMs); }));
+}
+
+DetailsPane::Section *DetailsPane::section(ProbeEngine::Probe probe)
+{
+    for (Section *s : m_sections) {
+        if (s->probe == probe) return s;
+    }
+    return nullptr;
+}
+
+void DetailsPane::applyProbeResult(ProbeEngine::Probe probe, const QString &value)
+{
+    Section *s = section(probe);
+    if (!s) return;
+    setHeader(*s, value);
+
+    // The row was (re-)probed, so the table may be out of date too.
+    if (s->header->isChecked()) load(*s);
+    else s->loaded = false;
+}
+
+QString DetailsPane::describe(ProbeEngine::Probe probe, const Hardware::Snapshot &details, bool partial)
+{
+    QString html;
+    switch (probe) {
+    case ProbeEngine::Processor:   html = describeProcessor(details.processor); break;
+    case ProbeEngine::Memory:      html = describeMemory(details.memory); break;
+    case ProbeEngine::Graphics:    html = describeGraphics(details.graphics); break;
+    default: return QString();
+    }
+    if (partial) html += kLeftOut;
+    return html;
+}
+
+QString DetailsPane::describe(ProbeEngine::Probe probe, int deadlineMs)
+{
+    ATS_TRACE_SPAN_DETAIL("DetailsPane::describe", "probe", std::to_string(int(probe)));
+    Hardware::ProbeLimits limits;
+    limits.deadline = QDeadlineTimer(deadlineMs);
+    Hardware::setProbeLimits(limits);
+
+    QString html;
+    switch (probe) {
+    case ProbeEngine::Processor:   html = describeProcessor(Hardware::probeProcessor()); break;
+    case ProbeEngine::Memory:      html = describeMemory(Hardware::probeMemory()); break;
+    case ProbeEngine::Graphics:    html = describeGraphics(Hardware::probeGraphics()); break;
+    case ProbeEngine::StartupDisk: html = describeStorage(Hardware::probeStorage()); break;
+    default: break;
+    }
+
+    if (Hardware::probeLimitReached()) html += kLeftOut;
+    Hardware::clearProbeLimits();
+    return html;
+}
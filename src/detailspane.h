@@ -0,0 +1,55 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef DETAILSPANE_H
+#define DETAILSPANE_H
+
+#include "probeengine.h"
+#include <QVector>
+#include <QWidget>
+
+class QLabel;
+class QToolButton;
+
+// The "More Info" window. One collapsible section per card row; each header
+// shows the card's own one-line answer, so opening the pane costs nothing.
+// Expanding a section renders the structured result the card's probe already
+// has (every core, every DIMM, every GPU). Only what the card never gathered
+// is probed on a worker when it's opened: the storage inventory, and rows
+// the card read back from the text-only snapshot cache.
+//
+// Follows the engine: when a row is re-probed (hotplug), its header updates
+// and an open section reloads; a closed one reloads next time it's opened.
+class DetailsPane : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit DetailsPane(ProbeEngine *probes, QWidget *parent = nullptr);
+    ~DetailsPane();
+
+private slots:
+    void applyProbeResult(ProbeEngine::Probe probe, const QString &value);
+
+private:
+    struct Section;
+
+    void setupUi();
+    void setExpanded(Section &section, bool expanded);
+    void load(Section &section);
+    void setHeader(Section &section, const QString &value);
+    Section *section(ProbeEngine::Probe probe);
+
+    // One section as an HTML table, from the engine's results; empty for
+    // storage, which the card doesn't probe.
+    static QString describe(ProbeEngine::Probe probe, const Hardware::Snapshot &details, bool partial);
+    // Worker-thread side: probe and format one section.
+    static QString describe(ProbeEngine::Probe probe, int deadlineMs);
+
+    ProbeEngine *m_probes;
+    QVector<Section *> m_sections;
+};
+
+#endif // DETAILSPANE_H
@@ -0,0 +1,355 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "hardware_p.h"
+#include "uring.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <fcntl.h>
+#include <linux/aio_abi.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace Hardware {
+namespace Native {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Completion {
+    int slot = 0;
+    int64_t result = 0;         // bytes read, or -errno
+};
+
+// The part of an async engine the benchmark loop needs: queue reads into
+// numbered slots, then send them all and wait for at least one to finish.
+class IoQueue
+{
+public:
+    virtual ~IoQueue() = default;
+    virtual const char *name() const = 0;
+    virtual void queueRead(int slot, int fd, void *buffer, uint32_t length, uint64_t offset) = 0;
+    // Submits what's queued and blocks until something completes; false on error.
+    virtual bool wait(std::vector<Completion> &done) = 0;
+};
+
+// io_uring, READV so it works back to 5.1.
+class UringQueue : public IoQueue
+{
+public:
+    bool open(unsigned entries) {
+        if (!m_ring.open(entries)) return false;
+        m_iovecs.resize(m_ring.entries());
+        return true;
+    }
+
+    const char *name() const override { return "io_uring"; }
+
+    void queueRead(int slot, int fd, void *buffer, uint32_t length, uint64_t offset) override {
+        iovec &iov = m_iovecs[size_t(slot)];
+        iov.iov_base = buffer;
+        iov.iov_len = length;
+
+        io_uring_sqe *sqe = m_ring.prepare();
+        sqe->opcode = IORING_OP_READV;
+        sqe->fd = fd;
+        sqe->off = offset;
+        sqe->addr = reinterpret_cast<uint64_t>(&iov);
+        sqe->len = 1;
+        sqe->user_data = uint64_t(slot);
+    }
+
+    bool wait(std::vector<Completion> &done) override {
+        done.clear();
+        auto collect = [&done](const io_uring_cqe &cqe) {
+            done.push_back({ int(cqe.user_data), int64_t(cqe.res) });
+        };
+        // Reap anything already there before going into the kernel.
+        if (m_ring.queued() == 0 && m_ring.reap(collect) > 0) return true;
+        for (;;) {
+            if (!m_ring.submit(1)) return false;
+            if (m_ring.reap(collect) > 0) return true;
+        }
+    }
+
+private:
+    Uring m_ring;
+    std::vector<iovec> m_iovecs;
+};
+
+// Linux native AIO (what libaio wraps), for kernels or sandboxes without
+// io_uring. Only truly asynchronous with O_DIRECT, which is what we use.
+class AioQueue : public IoQueue
+{
+public:
+    ~AioQueue() override {
+        if (m_context) syscall(__NR_io_destroy, m_context);
+    }
+
+    bool open(unsigned entries) {
+        if (syscall(__NR_io_setup, entries, &m_context) < 0) {
+            m_context = 0;
+            return false;
+        }
+        m_iocbs.resize(entries);
+        m_events.resize(entries);
+        return true;
+    }
+
+    const char *name() const override { return "aio"; }
+
+    void queueRead(int slot, int fd, void *buffer, uint32_t length, uint64_t offset) override {
+        iocb &cb = m_iocbs[size_t(slot)];
+        std::memset(&cb, 0, sizeof(cb));
+        cb.aio_lio_opcode = IOCB_CMD_PREAD;
+        cb.aio_fildes = uint32_t(fd);
+        cb.aio_buf = reinterpret_cast<uint64_t>(buffer);
+        cb.aio_nbytes = length;
+        cb.aio_offset = int64_t(offset);
+        cb.aio_data = uint64_t(slot);
+        m_pending.push_back(&cb);
+    }
+
+    bool wait(std::vector<Completion> &done) override {
+        done.clear();
+        size_t sent = 0;
+        while (sent < m_pending.size()) {
+            const long r = syscall(__NR_io_submit, m_context, long(m_pending.size() - sent), m_pending.data() + sent);
+            if (r < 0 && errno == EINTR) continue;
+            if (r <= 0) return false;
+            sent += size_t(r);
+        }
+        m_pending.clear();
+
+        long n;
+        do {
+            n = syscall(__NR_io_getevents, m_context, 1, long(m_events.size()), m_events.data(), nullptr);
+        } while (n < 0 && errno == EINTR);
+        if (n < 0) return false;
+        for (long i = 0; i < n; ++i) done.push_back({ int(m_events[size_t(i)].data), int64_t(m_events[size_t(i)].res) });
+        return true;
+    }
+
+private:
+    aio_context_t m_context = 0;
+    std::vector<iocb> m_iocbs;
+    std::vector<io_event> m_events;
+    std::vector<iocb *> m_pending;
+};
+
+std::unique_ptr<IoQueue> openQueue(unsigned entries) {
+    std::unique_ptr<UringQueue> uring(new UringQueue);
+    if (uring->open(entries)) return uring;
+    std::unique_ptr<AioQueue> aio(new AioQueue);
+    if (aio->open(entries)) return aio;
+    return nullptr;
+}
+
+bool isCancelled(const std::atomic<bool> *cancelled) {
+    return cancelled && cancelled->load(std::memory_order_relaxed);
+}
+
+double percentile(std::vector<uint32_t> &samples, double p) {
+    if (samples.empty()) return 0.0;
+    const size_t at = std::min(samples.size() - 1, size_t(p * double(samples.size())));
+    std::nth_element(samples.begin(), samples.begin() + long(at), samples.end());
+    return samples[at] / 1000.0;
+}
+
+struct Target {
+    int fd = -1;
+    uint64_t span = 0;          // bytes we may read from, aligned down
+    uint32_t alignment = 4096;
+};
+
+// One pattern at one queue depth for about runTime: keeps `depth` reads in
+// flight, refilling each slot as it completes, and records every latency.
+// False, with *error set, if anything failed. *stranded is set if reads may
+// still be in flight on return, in which case buffers must never be freed.
+bool runOne(IoQueue &queue, const Target &target, bool sequential, uint32_t blockBytes, int depth,
+            Clock::duration runTime, char *buffers, const std::atomic<bool> *cancelled,
+            DiskBenchResult &result, std::string *error, bool *stranded) {
+    const uint64_t blocks = target.span / blockBytes;
+    if (blocks == 0) {
+        if (error) *error = "target is smaller than one block";
+        return false;
+    }
+
+    uint64_t nextBlock = 0;
+    uint64_t rng = 0x9e3779b97f4a7c15ull ^ uint64_t(depth);
+    auto pickOffset = [&]() -> uint64_t {
+        if (sequential) {
+            const uint64_t block = nextBlock;
+            nextBlock = (nextBlock + 1) % blocks;
+            return block * blockBytes;
+        }
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        return (rng % blocks) * blockBytes;
+    };
+
+    std::vector<Clock::time_point> issued{ size_t(depth) };
+    std::vector<uint32_t> latencyNs;
+    latencyNs.reserve(1 << 16);
+    std::vector<Completion> done;
+    done.reserve(size_t(depth));
+
+    const Clock::time_point start = Clock::now();
+    const Clock::time_point stopAt = start + runTime;
+    for (int slot = 0; slot < depth; ++slot) {
+        issued[size_t(slot)] = Clock::now();
+        queue.queueRead(slot, target.fd, buffers + size_t(slot) * blockBytes, blockBytes, pickOffset());
+    }
+
+    int inFlight = depth;
+    uint64_t bytes = 0;
+    bool stopping = false;
+    bool failed = false;
+    int waitFailures = 0;
+    while (inFlight > 0) {
+        if (!queue.wait(done)) {
+            if (!failed && error) *error = std::string(queue.name()) + ": " + std::strerror(errno);
+            failed = stopping = true;
+            // The reads already sent land in buffers whenever they finish,
+            // so keep trying to collect them; give up only after a while.
+            if (++waitFailures < 100) {
+                usleep(1000);
+                continue;
+            }
+            *stranded = true;
+            return false;
+        }
+        const Clock::time_point now = Clock::now();
+        if (!stopping && (now >= stopAt || isCancelled(cancelled))) stopping = true;
+
+        for (const Completion &c : done) {
+            --inFlight;
+            if (c.result < 0) {
+                if (!failed && error) *error = std::strerror(int(-c.result));
+                failed = stopping = true;
+                continue;
+            }
+            bytes += uint64_t(c.result);
+            latencyNs.push_back(uint32_t(std::min<int64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(now - issued[size_t(c.slot)]).count(), UINT32_MAX)));
+            if (stopping) continue;
+            issued[size_t(c.slot)] = Clock::now();
+            queue.queueRead(c.slot, target.fd, buffers + size_t(c.slot) * blockBytes, blockBytes, pickOffset());
+            ++inFlight;
+        }
+    }
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    result.sequential = sequential;
+    result.queueDepth = depth;
+    result.blockBytes = blockBytes;
+    result.ios = latencyNs.size();
+    result.mbPerSec = seconds > 0 ? double(bytes) / 1e6 / seconds : 0.0;
+    result.iops = seconds > 0 ? double(latencyNs.size()) / seconds : 0.0;
+    result.p50Us = percentile(latencyNs, 0.50);
+    result.p99Us = percentile(latencyNs, 0.99);
+    if (!failed && latencyNs.empty() && error) *error = "no reads completed";
+    return !failed && !latencyNs.empty();
+}
+
+}
+
+bool benchmarkDisk(const std::string &path, DiskBench &bench, const DiskBenchOptions &options,
+                   const std::atomic<bool> *cancelled, std::string *error) {
+    bench = DiskBench();
+    bench.target = path;
+
+    // Read-only, always. O_DIRECT so we time the device, not the page cache;
+    // tmpfs and a few others refuse it, and then the numbers say so.
+    Target target;
+    target.fd = ::open(path.c_str(), O_RDONLY | O_DIRECT | O_CLOEXEC);
+    bench.direct = target.fd >= 0;
+    if (target.fd < 0 && errno == EINVAL) target.fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (target.fd < 0) {
+        if (error) *error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct FdCloser {
+        int fd;
+        ~FdCloser() { ::close(fd); }
+    } closer{ target.fd };
+
+    struct stat st;
+    if (fstat(target.fd, &st) != 0) {
+        if (error) *error = path + ": " + std::strerror(errno);
+        return false;
+    }
+    if (S_ISBLK(st.st_mode)) {
+        uint64_t size = 0;
+        int sector = 0;
+        if (ioctl(target.fd, BLKGETSIZE64, &size) == 0) target.span = size;
+        if (ioctl(target.fd, BLKSSZGET, &sector) == 0 && sector > 0) target.alignment = uint32_t(sector);
+    } else if (S_ISREG(st.st_mode)) {
+        target.span = uint64_t(st.st_size);
+    } else {
+        if (error) *error = path + ": not a block device or regular file";
+        return false;
+    }
+    if (options.spanBytes > 0) target.span = std::min(target.span, options.spanBytes);
+
+    const uint32_t randBlock = std::max(options.randBlockBytes, target.alignment);
+    const uint32_t seqBlock = std::max(options.seqBlockBytes, target.alignment);
+    target.span -= target.span % std::max(seqBlock, randBlock);
+
+    int maxDepth = 1;
+    for (int depth : options.queueDepths) maxDepth = std::max(maxDepth, depth);
+
+    // The buffers outlive the queue: tearing down an AIO context waits for
+    // its reads, so nothing lands in freed memory.
+    void *memory = nullptr;
+    const size_t bufferBytes = size_t(maxDepth) * std::max(seqBlock, randBlock);
+    if (posix_memalign(&memory, 4096, bufferBytes) != 0) {
+        if (error) *error = "out of memory";
+        return false;
+    }
+    std::unique_ptr<char, decltype(&std::free)> buffers(static_cast<char *>(memory), &std::free);
+
+    unsigned entries = 1;
+    while (entries < unsigned(maxDepth)) entries <<= 1;
+    std::unique_ptr<IoQueue> queue = openQueue(entries);
+    if (!queue) {
+        if (error) *error = "neither io_uring nor aio is available";
+        return false;
+    }
+    bench.engine = queue->name();
+
+    const auto runTime = std::chrono::milliseconds(std::max(10, options.msPerRun));
+    for (int pass = 0; pass < 2; ++pass) {
+        const bool sequential = pass == 0;
+        for (int depth : options.queueDepths) {
+            if (isCancelled(cancelled)) return !bench.results.empty();
+            DiskBenchResult result;
+            bool stranded = false;
+            if (!runOne(*queue, target, sequential, sequential ? seqBlock : randBlock, std::max(1, depth), runTime,
+                        buffers.get(), cancelled, result, error, &stranded)) {
+                // A ring's fd closing doesn't wait for its reads; leak the
+                // buffers rather than have the kernel write into the heap.
+                if (stranded) buffers.release();
+                return !bench.results.empty();
+            }
+            bench.results.push_back(result);
+        }
+    }
+    return true;
+}
+
+}
+}
@@ -0,0 +1,263 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "hardware_p.h"
+#include "sysfs.h"
+#include "textscan.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <sys/sysmacros.h>
+#include <system_error>
+#include <thread>
+
+namespace Hardware {
+namespace Native {
+
+namespace {
+
+const char *const kBlockDir = "/sys/block";
+
+// Filesystems worth listing that don't sit on a local block device.
+const char *const kNetworkFs[] = {
+    "nfs", "nfs4", "cifs", "smb3", "smbfs", "ceph", "glusterfs", "fuse.glusterfs",
+    "fuse.sshfs", "9p", "lustre", "beegfs", "gpfs", "afs"
+};
+
+bool isNetworkFs(std::string_view fs) {
+    for (const char *n : kNetworkFs) {
+        if (fs == n) return true;
+    }
+    return false;
+}
+
+// RAM-backed and loopback devices aren't storage anyone shopped for.
+bool isVirtualDisk(const std::string &name) {
+    return Text::startsWith(name, "loop") || Text::startsWith(name, "ram") || Text::startsWith(name, "zram");
+}
+
+// "none [mq-deadline] kyber" -> "mq-deadline"
+std::string activeScheduler(const std::string &line) {
+    const size_t open = line.find('[');
+    const size_t close = line.find(']', open);
+    if (open == std::string::npos || close == std::string::npos) return line;
+    return line.substr(open + 1, close - open - 1);
+}
+
+// Mount points escape space, tab, newline and backslash as \ooo.
+std::string unescapeOctal(std::string_view s) {
+    std::string out;
+    out.reserve(s.size());
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (s[i] == '\\' && i + 3 < s.size()
+            && s[i + 1] >= '0' && s[i + 1] <= '7' && s[i + 2] >= '0' && s[i + 2] <= '7'
+            && s[i + 3] >= '0' && s[i + 3] <= '7') {
+            out += char(((s[i + 1] - '0') << 6) | ((s[i + 2] - '0') << 3) | (s[i + 3] - '0'));
+            i += 3;
+        } else {
+            out += s[i];
+        }
+    }
+    return out;
+}
+
+// Pools whose datasets name the pool rather than a device ("rpool/ROOT"),
+// so there's no single disk to put them under.
+bool isPooledFs(std::string_view fs) {
+    return fs == "zfs" || fs == "bcachefs";
+}
+
+// btrfs subvolumes and the like sit on an anonymous 0:NN device rather than
+// the partition, so go by the source device's maj:min instead: stat it, or
+// by name under /sys/class/block when the tree has no /dev (a capture).
+std::string sourceMajorMinor(const std::string &source) {
+    if (!Text::startsWith(source, "/dev/")) return std::string();
+    struct stat st;
+    if (::stat(SysFs::resolve(source).c_str(), &st) == 0 && S_ISBLK(st.st_mode)) {
+        return std::to_string(major(st.st_rdev)) + ':' + std::to_string(minor(st.st_rdev));
+    }
+    std::string line;
+    if (SysFs::readLine("/sys/class/block/" + source.substr(source.rfind('/') + 1) + "/dev", line)) return line;
+    return std::string();
+}
+
+int readInt(const std::string &path) {
+    long long v = 0;
+    return SysFs::readLong(path, v) ? int(v) : 0;
+}
+
+// Fills devices from /sys/block and, given owner, maps every disk's and
+// partition's "maj:min" to the disk it belongs to.
+void readBlockDevices(std::vector<BlockDevice> &devices, std::map<std::string, std::string> *owner) {
+    std::vector<std::string> names = SysFs::listDir(kBlockDir);
+    std::sort(names.begin(), names.end());
+
+    std::string line;
+    for (const std::string &name : names) {
+        if (isVirtualDisk(name)) continue;
+        const std::string dir = std::string(kBlockDir) + '/' + name;
+
+        BlockDevice dev;
+        dev.name = name;
+
+        long long sectors = 0;
+        // always 512-byte units, whatever the logical block size
+        if (SysFs::readLong(dir + "/size", sectors)) dev.sizeBytes = uint64_t(sectors) * 512;
+        dev.rotational = readInt(dir + "/queue/rotational") != 0;
+        dev.removable = readInt(dir + "/removable") != 0;
+        dev.logicalBlockSize = readInt(dir + "/queue/logical_block_size");
+        dev.physicalBlockSize = readInt(dir + "/queue/physical_block_size");
+        dev.queueDepth = readInt(dir + "/queue/nr_requests");
+        if (SysFs::readLine(dir + "/queue/scheduler", line)) dev.scheduler = activeScheduler(line);
+        if (SysFs::readLine(dir + "/device/model", line)) dev.model = line;
+        if (SysFs::readLine(dir + "/device/vendor", line)) dev.vendor = line;
+
+        devices.push_back(std::move(dev));
+        if (!owner) continue;
+
+        if (SysFs::readLine(dir + "/dev", line)) (*owner)[line] = name;
+        // partitions are subdirectories with a "partition" attribute
+        for (const std::string &child : SysFs::listDir(dir)) {
+            if (!Text::startsWith(child, name)) continue;
+            if (!SysFs::exists(dir + '/' + child + "/partition")) continue;
+            if (SysFs::readLine(dir + '/' + child + "/dev", line)) (*owner)[line] = name;
+        }
+    }
+}
+
+void readVolumes(std::vector<Volume> &volumes, const std::map<std::string, std::string> &owner) {
+    std::string text;
+    if (!SysFs::readFile("/proc/self/mountinfo", text, 4 << 20)) return;
+
+    std::vector<std::string> seen;   // maj:min already listed (bind mounts)
+    Text::LineReader lines(text);
+    std::string_view line;
+    MountEntry entry;
+    while (lines.next(line)) {
+        if (!parseMountInfoLine(line, entry)) continue;
+
+        Volume v;
+        v.network = isNetworkFs(entry.fileSystem);
+        v.source = unescapeOctal(entry.source);
+        auto disk = owner.find(std::string(entry.majorMinor));
+        if (disk == owner.end() && !v.network) disk = owner.find(sourceMajorMinor(v.source));
+        if (disk != owner.end()) v.disk = disk->second;
+        else if (!v.network && !isPooledFs(entry.fileSystem)) continue;   // proc, tmpfs, overlay, loop-backed squashfs, ...
+
+        const std::string mm(entry.majorMinor);
+        v.mountPoint = unescapeOctal(entry.mountPoint);
+        auto it = std::find(seen.begin(), seen.end(), mm);
+        if (it != seen.end()) {
+            // the root filesystem wins over any earlier bind of it
+            if (v.mountPoint == "/") {
+                Volume &first = volumes[size_t(it - seen.begin())];
+                first.mountPoint = v.mountPoint;
+            }
+            continue;
+        }
+        seen.push_back(mm);
+
+        v.fileSystem = std::string(entry.fileSystem);
+        volumes.push_back(std::move(v));
+    }
+
+    std::stable_partition(volumes.begin(), volumes.end(), [](const Volume &v) { return v.mountPoint == "/"; });
+}
+
+// Shared between the waiting prober and the statvfs threads, which may
+// outlive it if a mount never answers.
+struct StatBatch {
+    struct Result {
+        bool done = false;
+        bool ok = false;
+        uint64_t total = 0;
+        uint64_t available = 0;
+    };
+
+    std::mutex lock;
+    std::condition_variable finished;
+    size_t remaining = 0;
+    std::vector<Result> results;
+};
+
+void statVolumes(std::vector<Volume> &volumes, int timeoutMs, const std::atomic<bool> *cancelled) {
+    if (volumes.empty()) return;
+
+    auto batch = std::make_shared<StatBatch>();
+    batch->results.resize(volumes.size());
+    batch->remaining = volumes.size();
+
+    for (size_t i = 0; i < volumes.size(); ++i) {
+        const std::string path = SysFs::resolve(volumes[i].mountPoint);
+        auto work = [batch, i, path]() {
+            struct statvfs st;
+            const bool ok = ::statvfs(path.c_str(), &st) == 0;
+
+            std::lock_guard<std::mutex> guard(batch->lock);
+            StatBatch::Result &r = batch->results[i];
+            r.done = true;
+            r.ok = ok;
+            if (ok) {
+                r.total = uint64_t(st.f_blocks) * st.f_frsize;
+                r.available = uint64_t(st.f_bavail) * st.f_frsize;
+            }
+            if (--batch->remaining == 0) batch->finished.notify_all();
+        };
+
+        try {
+            std::thread(work).detach();
+        } catch (const std::system_error &) {
+            // Out of threads: do it here instead. Still bounded by the
+            // other volumes' deadline, just not this one's.
+            work();
+        }
+    }
+
+    // Wait in short slices so a cancel is noticed promptly, as runTool() does.
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::unique_lock<std::mutex> guard(batch->lock);
+    while (batch->remaining > 0) {
+        if (cancelled && cancelled->load()) break;
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) break;
+        batch->finished.wait_until(guard, std::min(deadline, now + std::chrono::milliseconds(50)));
+    }
+
+    for (size_t i = 0; i < volumes.size(); ++i) {
+        const StatBatch::Result &r = batch->results[i];
+        volumes[i].timedOut = !r.done;
+        volumes[i].statted = r.ok;
+        volumes[i].bytesTotal = r.total;
+        volumes[i].bytesAvailable = r.available;
+    }
+}
+
+}
+
+bool probeStorage(StorageFacts &facts, int timeoutMs, const std::atomic<bool> *cancelled) {
+    facts = StorageFacts();
+    if (!SysFs::exists(kBlockDir)) return false;
+
+    std::map<std::string, std::string> owner;
+    readBlockDevices(facts.devices, &owner);
+    readVolumes(facts.volumes, owner);
+    statVolumes(facts.volumes, timeoutMs, cancelled);
+    return true;
+}
+
+bool probeBlockDevices(std::vector<BlockDevice> &devices) {
+    devices.clear();
+    if (!SysFs::exists(kBlockDir)) return false;
+    readBlockDevices(devices, nullptr);
+    return true;
+}
+
+}
+}
@@ -0,0 +1,95 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "embosslabel.h"
+#include <QEvent>
+#include <QPainter>
+#include <QStyle>
+
+EmbossLabel::EmbossLabel(const QString &text, QWidget *parent)
+    : QLabel(text, parent)
+{
+    setTextFormat(Qt::PlainText);
+}
+
+void EmbossLabel::setEmbossColor(const QColor &color)
+{
+    if (color == m_embossColor) return;
+    m_embossColor = color;
+    m_cache = QPixmap();
+    update();
+}
+
+QSize EmbossLabel::sizeHint() const
+{
+    return QLabel::sizeHint() + QSize(0, 1);
+}
+
+QSize EmbossLabel::minimumSizeHint() const
+{
+    return QLabel::minimumSizeHint() + QSize(0, 1);
+}
+
+int EmbossLabel::heightForWidth(int width) const
+{
+    const int h = QLabel::heightForWidth(width);
+    return h < 0 ? h : h + 1;
+}
+
+void EmbossLabel::changeEvent(QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::FontChange:
+    case QEvent::PaletteChange:
+    case QEvent::EnabledChange:
+    case QEvent::StyleChange:
+    case QEvent::LayoutDirectionChange:
+        m_cache = QPixmap();
+        break;
+    default:
+        break;
+    }
+    QLabel::changeEvent(event);
+}
+
+void EmbossLabel::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+
+    const qreal dpr = devicePixelRatioF();
+    // setText() isn't virtual, so a changed text is noticed here instead.
+    if (m_cache.isNull() || m_cacheSize != size() || m_cache.devicePixelRatioF() != dpr
+        || m_cacheText != text()) {
+        render(dpr);
+    }
+
+    QPainter painter(this);
+    painter.drawPixmap(0, 0, m_cache);
+}
+
+void EmbossLabel::render(qreal dpr)
+{
+    m_cacheText = text();
+    m_cacheSize = size();
+
+    m_cache = QPixmap(size() * dpr);
+    m_cache.setDevicePixelRatio(dpr);
+    m_cache.fill(Qt::transparent);
+
+    // Same layout QLabel::paintEvent uses for plain text, with the bottom row
+    // kept free for the highlight.
+    QRect r = contentsRect().adjusted(margin(), margin(), -margin(), -margin() - 1);
+    int flags = QStyle::visualAlignment(layoutDirection(), alignment());
+    if (wordWrap()) flags |= Qt::TextWordWrap;
+
+    QPainter p(&m_cache);
+    p.setFont(font());
+
+    // highlight first, then the text over it (blur-free drop shadow, offset 0,1)
+    QPalette highlight = palette();
+    highlight.setColor(foregroundRole(), m_embossColor);
+    style()->drawItemText(&p, r.translated(0, 1), flags, highlight, isEnabled(), m_cacheText, foregroundRole());
+    style()->drawItemText(&p, r, flags, palette(), isEnabled(), m_cacheText, foregroundRole());
+}
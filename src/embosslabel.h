@@ -0,0 +1,48 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef EMBOSSLABEL_H
+#define EMBOSSLABEL_H
+
+#include <QColor>
+#include <QLabel>
+#include <QPixmap>
+
+// A QLabel with the card's "embossed" look: a hard 1-px highlight under the
+// text. This used to be a QGraphicsDropShadowEffect per label, which renders
+// the label offscreen and composites it again on every repaint. Here both
+// passes are drawn once into a pixmap at the screen's device pixel ratio and
+// reused until the text, size, font or palette changes.
+//
+// Plain text only; rich text and pixmaps aren't what the card needs.
+class EmbossLabel : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit EmbossLabel(const QString &text, QWidget *parent = nullptr);
+
+    void setEmbossColor(const QColor &color);
+    QColor embossColor() const { return m_embossColor; }
+
+    // Room for the highlight below the last line.
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+    int heightForWidth(int width) const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void changeEvent(QEvent *event) override;
+
+private:
+    void render(qreal dpr);
+
+    QColor m_embossColor = QColor(225, 225, 225);
+    QPixmap m_cache;
+    QString m_cacheText;    // what m_cache was drawn for
+    QSize m_cacheSize;
+};
+
+#endif // EMBOSSLABEL_H
@@ -0,0 +1,356 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "fleet.h"
+#include "hardware.h"
+#include "snapshotfile.h"
+#include "sysfs.h"
+#include "trace.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QProcess>
+#include <QTemporaryDir>
+#include <QThread>
+#include <algorithm>
+#include <dirent.h>
+#include <functional>
+#include <mutex>
+#include <sys/stat.h>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Hardware {
+namespace Fleet {
+
+namespace {
+
+// Hands out host directories to the workers one readdir() at a time, so the
+// list of hosts is never held in memory; whichever worker is free takes the
+// next one.
+class HostQueue
+{
+public:
+    explicit HostQueue(const std::string &base) : m_base(base), m_dir(::opendir(base.c_str())) {}
+    ~HostQueue() { if (m_dir) ::closedir(m_dir); }
+
+    HostQueue(const HostQueue &) = delete;
+    HostQueue &operator=(const HostQueue &) = delete;
+
+    bool isOpen() const { return m_dir != nullptr; }
+    const std::string &base() const { return m_base; }
+
+    bool next(std::string &host) {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (!m_dir) return false;
+        while (const dirent *e = ::readdir(m_dir)) {
+            if (e->d_name[0] == '.') continue;
+            if (e->d_type == DT_DIR || (e->d_type == DT_UNKNOWN && isDirectory(m_base + '/' + e->d_name))) {
+                host = e->d_name;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    static bool isDirectory(const std::string &path) {
+        struct stat st;
+        return ::stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+    }
+
+    std::string m_base;
+    DIR *m_dir;
+    std::mutex m_lock;
+};
+
+// Per-worker counts, merged once at the end so workers never contend on them.
+struct Tally {
+    int hosts = 0;
+    int skipped = 0;
+    QHash<QString, int> cpuModels;      // hosts
+    QHash<QString, int> dimmTypes;      // modules
+    QHash<QString, int> gpus;           // devices
+    QHash<QString, int> osVersions;     // hosts
+
+    void merge(const Tally &other) {
+        hosts += other.hosts;
+        skipped += other.skipped;
+        mergeCounts(cpuModels, other.cpuModels);
+        mergeCounts(dimmTypes, other.dimmTypes);
+        mergeCounts(gpus, other.gpus);
+        mergeCounts(osVersions, other.osVersions);
+    }
+
+private:
+    static void mergeCounts(QHash<QString, int> &into, const QHash<QString, int> &from) {
+        for (auto it = from.constBegin(); it != from.constEnd(); ++it) into[it.key()] += it.value();
+    }
+};
+
+// Records go out as soon as they're done; the lock only covers the write.
+class Output
+{
+public:
+    Output(FILE *out, bool enabled, Binary::Writer *binary)
+        : m_out(out), m_enabled(enabled), m_binary(binary) {}
+
+    void write(const QJsonObject &record) {
+        if (!m_enabled) return;
+        QByteArray line = QJsonDocument(record).toJson(QJsonDocument::Compact);
+        line += '\n';
+        std::lock_guard<std::mutex> guard(m_lock);
+        std::fwrite(line.constData(), 1, size_t(line.size()), m_out);
+    }
+
+    void add(const QString &host, const Snapshot &snapshot) {
+        if (!m_binary) return;
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_binary->add(host, snapshot);
+    }
+
+private:
+    FILE *m_out;
+    bool m_enabled;
+    Binary::Writer *m_binary;
+    std::mutex m_lock;
+};
+
+QJsonObject hostRecord(const QString &host, const Snapshot &s) {
+    QJsonObject record;
+    record["host"] = host;
+    record["os"] = toJson(s.os);
+    record["cpu"] = toJson(s.processor);
+    record["memory"] = toJson(s.memory);
+    record["graphics"] = toJson(s.graphics);
+    record["storage"] = toJson(s.storage);
+    return record;
+}
+
+QString orUnknown(const QString &s) {
+    return s.isEmpty() ? QStringLiteral("Unknown") : s;
+}
+
+void analyzeHost(const std::string &base, const std::string &host, Output &output, Tally &tally) {
+    ATS_TRACE_SPAN_DETAIL("Fleet::analyzeHost", "fleet", host);
+    SysFs::ScopedThreadRoot root(base + '/' + host);
+
+    const QString name = QString::fromStdString(host);
+
+    if (!SysFs::exists("/proc") && !SysFs::exists("/sys")) {
+        ++tally.skipped;
+        QJsonObject record;
+        record["host"] = name;
+        record["error"] = QStringLiteral("not a captured tree");
+        output.write(record);
+        return;
+    }
+
+    // Disks only: volumes' statvfs would measure this machine.
+    Snapshot s;
+    s.os = probeOS();
+    s.processor = probeProcessor();
+    s.memory = probeMemory();
+    s.graphics = probeGraphics();
+    s.storage = probeStorageDevices();
+
+    output.write(hostRecord(name, s));
+    output.add(name, s);
+
+    ++tally.hosts;
+    tally.cpuModels[orUnknown(s.processor.model)] += 1;
+    tally.osVersions[orUnknown(s.os.prettyName)] += 1;
+    for (const MemoryModule &m : s.memory.modules) tally.dimmTypes[orUnknown(m.type)] += 1;
+    for (const GraphicsDevice &g : s.graphics.devices) tally.gpus[orUnknown(g.name)] += 1;
+}
+
+void worker(HostQueue &queue, Output &output, Tally &tally) {
+    std::string host;
+    while (queue.next(host)) analyzeHost(queue.base(), host, output, tally);
+}
+
+// Most common first, then by name, so summaries of the same fleet diff cleanly.
+QJsonArray sortedCounts(const QHash<QString, int> &counts) {
+    std::vector<std::pair<QString, int>> v;
+    v.reserve(size_t(counts.size()));
+    for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) v.emplace_back(it.key(), it.value());
+    std::sort(v.begin(), v.end(), [](const std::pair<QString, int> &a, const std::pair<QString, int> &b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+
+    QJsonArray a;
+    for (const auto &entry : v) {
+        QJsonObject o;
+        o["name"] = entry.first;
+        o["count"] = entry.second;
+        a.append(o);
+    }
+    return a;
+}
+
+bool isCapture(const QString &dir) {
+    return QFileInfo(dir + "/proc").isDir() || QFileInfo(dir + "/sys").isDir();
+}
+
+QString fromView(std::string_view v) {
+    return QString::fromUtf8(v.data(), int(v.size()));
+}
+
+// The writer stores each distinct string once, so counting by string table
+// offset is counting by value; names are only decoded for the summary.
+void tallySnapshotFile(const Binary::Reader &reader, Tally &tally) {
+    QHash<uint32_t, int> cpuModels, dimmTypes, gpus, osVersions;
+    QHash<uint32_t, Binary::StringRef> refs;
+    auto count = [&refs](QHash<uint32_t, int> &counts, Binary::StringRef ref) {
+        counts[ref.offset] += 1;
+        refs.insert(ref.offset, ref);
+    };
+
+    for (const Binary::HostRecord &host : reader.hosts()) {
+        ++tally.hosts;
+        count(osVersions, host.osPrettyName);
+        for (const Binary::CpuRecord &cpu : reader.cpus(host)) count(cpuModels, cpu.model);
+        for (const Binary::DimmRecord &dimm : reader.dimms(host)) count(dimmTypes, dimm.type);
+        for (const Binary::GpuRecord &gpu : reader.gpus(host)) count(gpus, gpu.name);
+    }
+
+    auto decode = [&](const QHash<uint32_t, int> &from, QHash<QString, int> &into) {
+        for (auto it = from.constBegin(); it != from.constEnd(); ++it) {
+            into[orUnknown(fromView(reader.string(refs.value(it.key()))))] += it.value();
+        }
+    };
+    decode(cpuModels, tally.cpuModels);
+    decode(dimmTypes, tally.dimmTypes);
+    decode(gpus, tally.gpus);
+    decode(osVersions, tally.osVersions);
+}
+
+void writeSummary(const Tally &total, bool records, FILE *out) {
+    QJsonObject summary;
+    summary["hosts"] = total.hosts;
+    summary["skipped"] = total.skipped;
+    summary["cpuModels"] = sortedCounts(total.cpuModels);
+    summary["dimmTypes"] = sortedCounts(total.dimmTypes);
+    summary["gpus"] = sortedCounts(total.gpus);
+    summary["osVersions"] = sortedCounts(total.osVersions);
+
+    QByteArray text;
+    if (records) {
+        QJsonObject o;
+        o["summary"] = summary;
+        text = QJsonDocument(o).toJson(QJsonDocument::Compact) + '\n';
+    } else {
+        text = QJsonDocument(summary).toJson(QJsonDocument::Indented);
+    }
+    std::fwrite(text.constData(), 1, size_t(text.size()), out);
+    std::fflush(out);
+}
+
+int readSnapshotFile(const Options &options, FILE *out, FILE *err) {
+    ATS_TRACE_SPAN("Fleet::readSnapshotFile", "fleet");
+
+    Binary::Reader reader;
+    std::string error;
+    if (!reader.open(options.input.toStdString(), &error)) {
+        std::fprintf(err, "Can't read %s: %s\n", qPrintable(options.input), error.c_str());
+        return 1;
+    }
+
+    if (options.records) {
+        Output output(out, true, nullptr);
+        for (const Binary::HostRecord &host : reader.hosts()) {
+            output.write(hostRecord(Binary::hostName(reader, host), Binary::toSnapshot(reader, host)));
+        }
+    }
+
+    Tally total;
+    tallySnapshotFile(reader, total);
+    writeSummary(total, options.records, out);
+    return 0;
+}
+
+// `tar czf fleet.tgz fleet/` wraps the hosts in one more directory; look
+// through it.
+QString hostsDirectory(const QString &dir) {
+    const QFileInfoList entries = QDir(dir).entryInfoList(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot);
+    if (entries.size() == 1 && entries.first().isDir() && !isCapture(entries.first().filePath())) {
+        return entries.first().filePath();
+    }
+    return dir;
+}
+
+}
+
+int analyze(const Options &options, FILE *out, FILE *err) {
+    ATS_TRACE_SPAN("Fleet::analyze", "fleet");
+
+    const QFileInfo input(options.input);
+    if (input.isFile() && Binary::Reader::isSnapshotFile(options.input.toStdString())) {
+        return readSnapshotFile(options, out, err);
+    }
+
+    QTemporaryDir unpacked;
+    QString dir = options.input;
+    if (input.isFile()) {
+        // Unpacked to disk, not memory; tar picks the compression itself.
+        if (!unpacked.isValid()) {
+            std::fprintf(err, "Can't create a directory to unpack %s into\n", qPrintable(options.input));
+            return 1;
+        }
+        const int rc = QProcess::execute("tar", QStringList() << "-xf" << input.absoluteFilePath()
+                                                              << "-C" << unpacked.path());
+        if (rc != 0) {
+            std::fprintf(err, "Couldn't unpack %s (tar exited with %d)\n", qPrintable(options.input), rc);
+            return 1;
+        }
+        dir = unpacked.path();
+    } else if (!input.isDir()) {
+        std::fprintf(err, "No such directory or archive: %s\n", qPrintable(options.input));
+        return 1;
+    }
+    dir = hostsDirectory(dir);
+
+    HostQueue queue(dir.toStdString());
+    if (!queue.isOpen()) {
+        std::fprintf(err, "Can't read %s\n", qPrintable(dir));
+        return 1;
+    }
+
+    const int jobs = options.jobs > 0 ? options.jobs : qMax(1, QThread::idealThreadCount());
+    Binary::Writer binary;
+    Output output(out, options.records, options.binaryOutput.isEmpty() ? nullptr : &binary);
+    std::vector<Tally> tallies(size_t(jobs));
+    std::vector<std::thread> threads;
+    threads.reserve(size_t(jobs));
+    for (int i = 1; i < jobs; ++i) {
+        try {
+            threads.emplace_back(worker, std::ref(queue), std::ref(output), std::ref(tallies[size_t(i)]));
+        } catch (const std::system_error &) {
+            break; // fewer workers, same result
+        }
+    }
+    worker(queue, output, tallies[0]);
+    for (std::thread &t : threads) t.join();
+
+    Tally total;
+    for (const Tally &t : tallies) total.merge(t);
+    writeSummary(total, options.records, out);
+
+    if (!options.binaryOutput.isEmpty()) {
+        QString error;
+        if (!binary.save(options.binaryOutput, &error)) {
+            std::fprintf(err, "Couldn't write %s: %s\n", qPrintable(options.binaryOutput), qPrintable(error));
+            return 1;
+        }
+    }
+    return 0;
+}
+
+}
+}
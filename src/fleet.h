@@ -0,0 +1,40 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef FLEET_H
+#define FLEET_H
+
+#include <QString>
+#include <cstdio>
+
+// Batch analysis of captured hosts: `AboutThisSyn --batch <dir|archive>`.
+//
+// Every subdirectory of the input is a tree as written by
+// bench/capture-sysroot.sh. Each one is run through the same probes the card
+// uses, with the sysroot pointed at it for that worker thread only, and comes
+// out as one JSON line. Counts of CPU models, DIMM types, GPUs and OS
+// versions are printed as a final summary.
+//
+// The input may also be a binary snapshot file (snapshotformat.h) written by
+// an earlier run, which is read in place instead of probing anything.
+namespace Hardware {
+namespace Fleet {
+
+struct Options {
+    QString input;              // directory of captures, or a tar archive of one
+    int jobs = 0;               // worker threads; 0 means one per CPU
+    bool records = true;        // print a line per host, not just the summary
+    QString binaryOutput;       // also write every host to this snapshot file
+};
+
+// Writes NDJSON to out: a record per host in completion order, then one
+// {"summary": ...} line (or just the summary, indented, without records).
+// Returns a process exit code.
+int analyze(const Options &options, FILE *out, FILE *err);
+
+}
+}
+
+#endif // FLEET_H
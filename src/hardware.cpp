@@ -4,177 +4,543 @@
  */
 
 #include "hardware.h"
+#include "hardware_p.h"
+#include "sysfs.h"
+#include "trace.h"
 #include <QFile>
-#include <QTextStream>
-#include <QRegularExpression>
 #include <QStorageInfo>
 #include <QProcess>
+#include <QtConcurrent>
 #include <cmath>
 
 namespace Hardware {
 
-QString getProcessorInfo() {
-    // Use lscpu for robust parsing
+namespace {
+
+Backend g_backend = Backend::Native;
+
+const int kDefaultToolTimeoutMs = 30000;
+
+// Per-volume statvfs budget when the caller set no tighter deadline.
+const int kVolumeTimeoutMs = 1000;
+
+thread_local ProbeLimits t_limits;
+thread_local bool t_limitReached = false;
+
+QString rootedPath(const QString &path) {
+    return QString::fromStdString(SysFs::resolve(path.toStdString()));
+}
+
+QString fromView(std::string_view v) {
+    return QString::fromUtf8(v.data(), int(v.size()));
+}
+
+// Runs a tool and returns its raw stdout. Under a sysroot the tool isn't run at
+// all: the canned output captured with the tree is returned instead, so a
+// fixture never gets mixed with facts from the machine running it.
+QByteArray runTool(const QString &program, const QStringList &args, const QString &cannedName) {
+    if (!SysFs::root().empty()) {
+        ATS_TRACE_SPAN_DETAIL("canned tool output", "process", cannedName.toStdString());
+        QFile canned(rootedPath("/tools/" + cannedName + ".txt"));
+        if (!canned.open(QIODevice::ReadOnly)) return QByteArray();
+        return canned.readAll();
+    }
+
     QProcess p;
-    p.start("lscpu", QStringList());
-    p.waitForFinished();
-    QString output = p.readAllStandardOutput();
-    
+    {
+        ATS_TRACE_SPAN_DETAIL("QProcess::start", "process", program.toStdString());
+        p.start(program, args); // forks and execs synchronously on Unix
+    }
+
+    ATS_TRACE_SPAN_DETAIL("QProcess::wait", "process", program.toStdString());
+
+    // Wait in short slices so a deadline or cancel is noticed promptly, and
+    // kill the child rather than leave it running behind us.
+    QDeadlineTimer deadline = t_limits.deadline;
+    if (deadline.isForever()) deadline.setRemainingTime(kDefaultToolTimeoutMs);
+    while (!p.waitForFinished(50)) {
+        if (p.state() == QProcess::NotRunning) break;
+        const bool cancelled = t_limits.cancelled && t_limits.cancelled->load();
+        if (cancelled || deadline.hasExpired()) {
+            p.kill();
+            p.waitForFinished(1000);
+            t_limitReached = true;
+            break;
+        }
+    }
+    return p.readAllStandardOutput();
+}
+
+// Legacy path: only used when sysfs topology isn't available (old kernels,
+// some containers), since it costs a fork+exec and a full text parse.
+void readLscpu(QString &modelName, int &totalPhysicalCores, double &speedGhz) {
+    // Use lscpu for robust parsing
+    const QByteArray output = runTool("lscpu", QStringList(), "lscpu");
+
+    Native::LscpuFacts facts;
+    Native::parseLscpu(std::string_view(output.constData(), size_t(output.size())), facts);
+
+    if (!facts.modelName.empty()) modelName = fromView(facts.modelName);
+    if (facts.maxMhz > 0) speedGhz = facts.maxMhz / 1000.0;
+    totalPhysicalCores = facts.coresPerSocket * facts.sockets;
+}
+
+// "AMD Radeon RX 580" rather than the raw pci.ids names; see namenorm.cpp.
+QString gpuDisplayName(const QString &vendor, const QString &device) {
+    const QByteArray v = vendor.toUtf8();
+    const QByteArray d = device.toUtf8();
+    Native::NameBuffer name;
+    Native::normalizeGpuName(std::string_view(v.constData(), size_t(v.size())),
+                             std::string_view(d.constData(), size_t(d.size())), name);
+    return fromView(name.view());
+}
+
+// Legacy path for systems without PCI sysfs or an uncompressed pci.ids.
+bool readLspciGraphics(GraphicsDevice &gpu) {
+    // Use `lspci -vmm` for easy parsing
+    const QByteArray output = runTool("lspci", QStringList() << "-vmm", "lspci-vmm");
+
+    Native::LspciDevice found;
+    if (!Native::parseLspciGraphics(std::string_view(output.constData(), size_t(output.size())), found)) {
+        return false;
+    }
+
+    // Example: Vendor="NVIDIA", Device="GA102 [GeForce RTX 3080]"
+    // Or Vendor="Intel", Device="Iris Xe Graphics"
+    gpu.vendor = fromView(found.vendor);
+    gpu.device = fromView(found.device);
+    gpu.name = gpuDisplayName(gpu.vendor, gpu.device);
+    gpu.bootVga = true;
+    return true; // Found primary GPU
+}
+
+void appendDevices(StorageInfo &info, const std::vector<Native::BlockDevice> &devices) {
+    for (const Native::BlockDevice &d : devices) {
+        StorageDevice dev;
+        dev.name = QString::fromStdString(d.name);
+        dev.model = QString::fromStdString(d.model);
+        dev.vendor = QString::fromStdString(d.vendor);
+        dev.bytesTotal = d.sizeBytes;
+        dev.rotational = d.rotational;
+        dev.removable = d.removable;
+        dev.logicalBlockSize = d.logicalBlockSize;
+        dev.physicalBlockSize = d.physicalBlockSize;
+        dev.queueDepth = d.queueDepth;
+        dev.scheduler = QString::fromStdString(d.scheduler);
+        info.devices.append(dev);
+    }
+}
+}
+
+void setSysRoot(const QString &root) {
+    SysFs::setRoot(root.toStdString());
+}
+
+QString sysRoot() {
+    return QString::fromStdString(SysFs::root());
+}
+
+void setBackend(Backend backend) {
+    g_backend = backend;
+}
+
+Backend backend() {
+    return g_backend;
+}
+
+void setProbeLimits(const ProbeLimits &limits) {
+    t_limits = limits;
+    t_limitReached = false;
+}
+
+void clearProbeLimits() {
+    t_limits = ProbeLimits();
+    t_limitReached = false;
+}
+
+bool probeLimitReached() {
+    return t_limitReached;
+}
+
+ProcessorInfo probeProcessor() {
+    ATS_TRACE_SPAN("Hardware::probeProcessor", "probe");
+    ProcessorInfo info;
     QString modelName;
-    int coresPerSocket = 1;
-    int sockets = 1;
+    int totalPhysicalCores = 0;
     double speedGhz = 0.0;
 
-    QStringList lines = output.split('\n');
-    for (const QString &line : lines) {
-        if (line.startsWith("Model name:")) {
-            modelName = line.section(':', 1).trimmed();
-        } else if (line.startsWith("Core(s) per socket:")) {
-            coresPerSocket = line.section(':', 1).trimmed().toInt();
-        } else if (line.startsWith("Socket(s):")) {
-            sockets = line.section(':', 1).trimmed().toInt();
-        } else if (line.startsWith("CPU max MHz:")) {
-            // Some distros have CPU max MHz
-            double mhz = line.section(':', 1).trimmed().toDouble();
-            if (mhz > 0) speedGhz = mhz / 1000.0;
+    // Native backend: /proc/cpuinfo + sysfs topology, no subprocess.
+    Native::ProcessorFacts facts;
+    const bool nativeTopology = g_backend == Backend::Native && Native::probeProcessor(facts);
+    if (nativeTopology) {
+        modelName = QString::fromStdString(facts.modelName);
+        totalPhysicalCores = facts.physicalCores;
+        speedGhz = facts.maxMhz / 1000.0;
+        info.logicalCpus = facts.logicalCpus;
+        info.sockets = facts.sockets;
+        info.threadsPerCore = facts.threadsPerCore;
+        info.llcDomains = facts.llcDomains;
+        info.numaNodes = int(facts.nodes.size());
+        info.threads.reserve(int(facts.threads.size()));
+        for (const Native::CpuThread &t : facts.threads) {
+            CpuThread thread;
+            thread.cpu = t.cpu;
+            thread.package = t.package;
+            thread.core = t.core;
+            thread.node = t.node;
+            thread.maxGhz = t.maxKhz / 1e6;
+            info.threads.append(thread);
+        }
+        for (const Native::NumaNode &n : facts.nodes) {
+            NumaNode node;
+            node.id = n.id;
+            node.cpuList = QString::fromStdString(n.cpuList);
+            node.cpus = n.cpus;
+            node.memoryBytes = n.memTotalBytes;
+            node.freeBytes = n.memFreeBytes;
+            node.distances = QVector<int>(n.distances.begin(), n.distances.end());
+            info.nodes.append(node);
         }
+    } else {
+        readLscpu(modelName, totalPhysicalCores, speedGhz);
     }
-    
-    // Fallback for speed if lscpu didn't give max MHz (often it doesn't on VMs or some kernels)
-    // Attempt extracting from model name e.g. "@ 2.40GHz"
-    if (speedGhz == 0.0) {
-        QRegularExpression speedRe("@\\s*([0-9.]+)\\s*GHz");
-        QRegularExpressionMatch match = speedRe.match(modelName);
-        if (match.hasMatch()) {
-            speedGhz = match.captured(1).toDouble();
-            // Clean the model name of the speed part
-            // modelName.remove(match.captured(0)); // Optional: user requirement "Value) Speed + Physical Core Count + Model" implies we construct it.
+
+    // ISA, caches and hybrid layout: cpuid on the live machine, cpuinfo
+    // flags and sysfs otherwise. Independent of the backend above.
+    Native::IsaFacts isa;
+    if (Native::probeIsa(isa)) {
+        info.vendor = QString::fromStdString(isa.vendor);
+        info.family = isa.family;
+        info.modelId = isa.model;
+        info.stepping = isa.stepping;
+        for (uint32_t bit = 1; bit != 0; bit <<= 1) {
+            if (isa.features & bit) info.isa << QString::fromLatin1(Native::isaFeatureName(bit));
+        }
+        for (const Native::CacheLevel &c : isa.caches) {
+            CpuCache cache;
+            cache.level = c.level;
+            cache.type = c.type == 'D' ? "Data" : c.type == 'I' ? "Instruction" : "Unified";
+            cache.sizeKb = c.sizeKb;
+            cache.ways = c.ways;
+            cache.lineBytes = c.lineBytes;
+            cache.sharedBy = c.sharedBy;
+            info.caches.append(cache);
         }
+        info.hybrid = isa.hybrid;
+        info.performanceCpus = isa.performanceCpus;
+        info.efficiencyCpus = isa.efficiencyCpus;
+        // no model name from cpuinfo or lscpu; the brand string is the same text
+        if (modelName.isEmpty()) modelName = QString::fromStdString(isa.brand);
     }
-    
+    if (modelName.isEmpty() && nativeTopology) {
+        // Topology from sysfs but no name (no cpuid, no cpuinfo "model name"):
+        // just the name from lscpu, which knows the ARM part tables.
+        int lscpuCores = 0;
+        double lscpuGhz = 0.0;
+        readLscpu(modelName, lscpuCores, lscpuGhz);
+        if (speedGhz == 0.0) speedGhz = lscpuGhz;
+    }
+    info.rawModel = modelName;
+
+    // Fallback for speed if lscpu didn't give max MHz (often it doesn't on VMs or some kernels)
+    // Attempt extracting from model name e.g. "@ 2.40GHz"
+    const std::string raw = modelName.toStdString();
+    if (speedGhz == 0.0) speedGhz = Native::ghzFromModelName(raw);
+
     // Clean Model Name
-    // Remove "Intel(R)", "Core(TM)", "CPU", "@ x.xxGHz"
-    modelName.replace(QRegularExpression("\\(R\\)"), "");
-    modelName.replace(QRegularExpression("\\(TM\\)"), "");
-    modelName.replace("CPU", "", Qt::CaseInsensitive);
-    modelName.replace(QRegularExpression("@.*"), ""); // Remove trailing speed if present
-    modelName = modelName.trimmed();
-
-    int totalPhysicalCores = coresPerSocket * sockets;
-    
+    // Remove "Intel(R)", "Core(TM)", "CPU", "@ x.xxGHz", "8-Core Processor"
+    Native::NameBuffer clean;
+    Native::normalizeCpuName(raw, clean);
+    modelName = fromView(clean.view());
+
+    info.model = modelName;
+    info.physicalCores = totalPhysicalCores;
+    info.maxGhz = speedGhz;
+    return info;
+}
+
+MemoryInfo probeMemory() {
+    ATS_TRACE_SPAN("Hardware::probeMemory", "probe");
+    // SMBIOS Type 17 records give per-DIMM size, type and speed in well under
+    // a millisecond; without root we only get MemTotal from /proc/meminfo.
+    MemoryInfo info;
+
+    Native::MemoryFacts facts;
+    Native::probeMemory(facts);
+
+    info.totalBytes = facts.totalBytes;
+    if (facts.source == Native::MemoryFacts::Smbios) info.source = "smbios";
+    else if (facts.source == Native::MemoryFacts::MemInfo) info.source = "meminfo";
+
+    for (const Native::MemoryModule &m : facts.modules) {
+        MemoryModule module;
+        module.sizeBytes = m.sizeBytes;
+        module.type = QString::fromStdString(m.type);
+        module.speedMts = m.speedMts;
+        module.configuredMts = m.configuredMts;
+        module.locator = QString::fromStdString(m.locator);
+        module.bankLocator = QString::fromStdString(m.bankLocator);
+        module.manufacturer = QString::fromStdString(m.manufacturer);
+        module.partNumber = QString::fromStdString(m.partNumber);
+
+        // the controller runs every channel at the slowest DIMM's speed
+        int mts = m.configuredMts > 0 ? m.configuredMts : m.speedMts;
+        if (mts > 0 && (info.speedMts == 0 || mts < info.speedMts)) info.speedMts = mts;
+        if (info.type.isEmpty()) info.type = module.type;
+
+        info.modules.append(module);
+    }
+    return info;
+}
+
+GraphicsInfo probeGraphics() {
+    ATS_TRACE_SPAN("Hardware::probeGraphics", "probe");
+    GraphicsInfo info;
+
+    // Native backend: display-class devices from sysfs, named via pci.ids.
+    Native::GraphicsFacts facts;
+    if (g_backend == Backend::Legacy || !Native::probeGraphics(facts)) {
+        GraphicsDevice gpu;
+        if (readLspciGraphics(gpu)) info.devices.append(gpu);
+        return info;
+    }
+
+    for (const Native::GraphicsDevice &d : facts.devices) {
+        GraphicsDevice gpu;
+        gpu.slot = QString::fromStdString(d.slot);
+        gpu.vendorId = d.vendorId;
+        gpu.deviceId = d.deviceId;
+        gpu.classCode = d.classCode;
+        gpu.bootVga = d.bootVga;
+        gpu.vendor = QString::fromStdString(d.vendorName);
+        gpu.device = QString::fromStdString(d.deviceName);
+
+        QString vendor = gpu.vendor;
+        QString device = gpu.device;
+        if (vendor.isEmpty()) vendor = QString("Vendor %1").arg(gpu.vendorId, 4, 16, QChar('0'));
+        if (device.isEmpty()) device = QString("Device %1").arg(gpu.deviceId, 4, 16, QChar('0'));
+        gpu.name = gpuDisplayName(vendor, device);
+
+        info.devices.append(gpu);
+    }
+    return info;
+}
+
+DiskInfo probeStartupDisk() {
+    ATS_TRACE_SPAN("Hardware::probeStartupDisk", "probe");
+    QStorageInfo root(rootedPath("/"));
+    DiskInfo info;
+    info.name = root.name();
+    if (info.name.isEmpty()) info.name = "Syn HD";
+    info.rootPath = root.rootPath();
+    info.device = QString::fromLocal8Bit(root.device());
+    info.fileSystem = QString::fromLocal8Bit(root.fileSystemType());
+    info.bytesTotal = quint64(qMax<qint64>(0, root.bytesTotal()));
+    info.bytesAvailable = quint64(qMax<qint64>(0, root.bytesAvailable()));
+    return info;
+}
+
+StorageInfo probeStorage() {
+    ATS_TRACE_SPAN("Hardware::probeStorage", "probe");
+    int timeoutMs = kVolumeTimeoutMs;
+    if (!t_limits.deadline.isForever()) {
+        timeoutMs = int(qBound<qint64>(0, t_limits.deadline.remainingTime(), kVolumeTimeoutMs));
+    }
+
+    Native::StorageFacts facts;
+    Native::probeStorage(facts, timeoutMs, t_limits.cancelled.get());
+
+    StorageInfo info;
+    appendDevices(info, facts.devices);
+    for (const Native::Volume &v : facts.volumes) {
+        Volume vol;
+        vol.device = QString::fromStdString(v.source);
+        vol.mountPoint = QString::fromStdString(v.mountPoint);
+        vol.fileSystem = QString::fromStdString(v.fileSystem);
+        vol.disk = QString::fromStdString(v.disk);
+        vol.network = v.network;
+        vol.timedOut = v.timedOut;
+        vol.bytesTotal = v.bytesTotal;
+        vol.bytesAvailable = v.bytesAvailable;
+        if (v.timedOut) t_limitReached = true;
+        info.volumes.append(vol);
+    }
+    return info;
+}
+
+StorageInfo probeStorageDevices() {
+    ATS_TRACE_SPAN("Hardware::probeStorageDevices", "probe");
+    std::vector<Native::BlockDevice> devices;
+    Native::probeBlockDevices(devices);
+
+    StorageInfo info;
+    appendDevices(info, devices);
+    return info;
+}
+
+OSInfo probeOS() {
+    ATS_TRACE_SPAN("Hardware::probeOS", "probe");
+    OSInfo info;
+    std::string text;
+    if (SysFs::readFile("/etc/os-release", text, 64 * 1024)) {
+        Native::OsReleaseFacts facts;
+        Native::parseOsRelease(text, facts);
+        info.name = fromView(facts.name);
+        info.version = fromView(facts.version);
+        info.versionId = fromView(facts.versionId);
+        info.prettyName = fromView(facts.prettyName);
+    }
+    return info;
+}
+
+Snapshot probeAll() {
+    ATS_TRACE_SPAN("Hardware::probeAll", "probe");
+    // Same idea as ProbeEngine, minus the signals: everything at once, and
+    // the slowest probe sets the total. The limits are per thread, so each
+    // worker gets the caller's, and any of them running out counts here.
+    const ProbeLimits limits = t_limits;
+    std::atomic<bool> reached{ false };
+    auto limited = [&limits, &reached](auto probe) {
+        return [&limits, &reached, probe]() {
+            setProbeLimits(limits);
+            auto result = probe();
+            if (t_limitReached) reached = true;
+            clearProbeLimits();
+            return result;
+        };
+    };
+    QFuture<ProcessorInfo> cpu = QtConcurrent::run(limited(&probeProcessor));
+    QFuture<MemoryInfo> mem = QtConcurrent::run(limited(&probeMemory));
+    QFuture<GraphicsInfo> gfx = QtConcurrent::run(limited(&probeGraphics));
+    QFuture<DiskInfo> disk = QtConcurrent::run(limited(&probeStartupDisk));
+    QFuture<StorageInfo> storage = QtConcurrent::run(limited(&probeStorage));
+
+    Snapshot snapshot;
+    snapshot.os = probeOS();
+    snapshot.processor = cpu.result();
+    snapshot.memory = mem.result();
+    snapshot.graphics = gfx.result();
+    snapshot.startupDisk = disk.result();
+    snapshot.storage = storage.result();
+    if (reached) t_limitReached = true;
+    return snapshot;
+}
+
+MemoryMeasurement measureMemory() {
+    ATS_TRACE_SPAN("Hardware::measureMemory", "probe");
+    Native::MemoryBenchOptions options;
+    if (!t_limits.deadline.isForever()) {
+        options.budgetMs = int(qBound<qint64>(100, t_limits.deadline.remainingTime(), options.budgetMs));
+    }
+
+    MemoryMeasurement m;
+    Native::MemoryBench bench;
+    if (!Native::measureMemory(bench, options, t_limits.cancelled.get())) return m;
+
+    m.kernel = QString::fromLatin1(bench.kernel);
+    m.threads = bench.threads;
+    m.copyGBs = bench.copyGBs;
+    m.triadGBs = bench.triadGBs;
+    m.cacheBound = bench.cacheBound;
+    for (const Native::MemoryLatency &l : bench.latency) {
+        MemoryLatencyPoint point;
+        point.level = l.level == 0 ? QString("DRAM") : l.level > 0 ? QString("L%1").arg(l.level) : QString();
+        point.bytes = l.bytes;
+        point.ns = l.ns;
+        m.latency.append(point);
+    }
+    return m;
+}
+
+DiskBenchmark benchmarkDisk(const QString &path) {
+    ATS_TRACE_SPAN("Hardware::benchmarkDisk", "probe");
+    Native::DiskBenchOptions options;
+    if (!t_limits.deadline.isForever()) {
+        // Split what's left evenly across the runs, sequential and random.
+        const int runs = int(options.queueDepths.size()) * 2;
+        options.msPerRun = int(qBound<qint64>(20, t_limits.deadline.remainingTime() / runs, options.msPerRun));
+    }
+
+    DiskBenchmark b;
+    b.target = path;
+    Native::DiskBench bench;
+    std::string error;
+    if (!Native::benchmarkDisk(path.toStdString(), bench, options, t_limits.cancelled.get(), &error)) {
+        b.error = QString::fromStdString(error);
+        return b;
+    }
+
+    b.engine = QString::fromLatin1(bench.engine);
+    b.direct = bench.direct;
+    for (const Native::DiskBenchResult &r : bench.results) {
+        DiskThroughput run;
+        run.pattern = r.sequential ? QString("sequential") : QString("random");
+        run.queueDepth = r.queueDepth;
+        run.blockBytes = int(r.blockBytes);
+        run.mbPerSec = r.mbPerSec;
+        run.iops = r.iops;
+        run.p50Us = r.p50Us;
+        run.p99Us = r.p99Us;
+        b.runs.append(run);
+    }
+    return b;
+}
+
+DiskBenchmark benchmarkStartupDisk() {
+    const DiskInfo disk = probeStartupDisk();
+    DiskBenchmark b;
+    b.target = disk.device;
+    // A captured tree's startup disk isn't this machine's.
+    if (!SysFs::root().empty()) {
+        b.error = "not benchmarking under a sysroot";
+        return b;
+    }
+    if (!disk.device.startsWith("/dev/")) {
+        b.error = "startup volume isn't on a local block device";
+        return b;
+    }
+    return benchmarkDisk(disk.device);
+}
+
+QString formatProcessor(const ProcessorInfo &info) {
     QString speedStr;
-    if (speedGhz > 0.0) {
-        speedStr = QString::number(speedGhz, 'f', 1) + " GHz";
+    if (info.maxGhz > 0.0) {
+        speedStr = QString::number(info.maxGhz, 'f', 1) + " GHz";
     } else {
         // Just empty if unknown
-        speedStr = ""; 
+        speedStr = "";
     }
-    
+
+    // "2 × 96-core" when the packages split the cores evenly
     QString coreStr;
-    if (totalPhysicalCores > 0) {
-        coreStr = QString("%1-core").arg(totalPhysicalCores);
+    if (info.sockets > 1 && info.physicalCores % info.sockets == 0) {
+        coreStr = QString("%1 × %2-core").arg(info.sockets).arg(info.physicalCores / info.sockets);
+    } else if (info.physicalCores > 0) {
+        coreStr = QString("%1-core").arg(info.physicalCores);
     }
-    
-    // Format: [Speed] [Cores] [Model]
+
+    // Format: [Speed] [Cores] [Model][, N NUMA nodes]
     QStringList parts;
     if (!speedStr.isEmpty()) parts << speedStr;
     if (!coreStr.isEmpty()) parts << coreStr;
-    if (!modelName.isEmpty()) parts << modelName;
-    
-    return parts.join(" ");
+    if (!info.model.isEmpty()) parts << info.model;
+
+    QString text = parts.join(" ");
+    if (info.numaNodes > 1) text += QString(", %1 NUMA nodes").arg(info.numaNodes);
+    return text;
 }
 
-QString getMemoryInfo() {
-    // try to get detailed memory info using lshw.
-    // this provides type and speed which free -m does not.
-    QProcess p;
-    p.start("lshw", QStringList() << "-C" << "memory");
-    p.waitForFinished();
-    QString output = p.readAllStandardOutput();
-
-    // in vm/wsl environments, output might be sparse.
-    // we need to handle "*-memory" blocks carefully.
-    // key fields: "size:", "clock:", "description:"
-    
+QString formatMemory(const MemoryInfo &info) {
     QString sizeStr;
     QString speedStr = "Unknown MHz";
     QString typeStr = "Unknown Type";
-    
-    long long totalBytes = 0;
-    bool foundAnySize = false;
-
-    QStringList lines = output.split('\n');
-    for (const QString &line : lines) {
-        QString trimmed = line.trimmed();
-
-        // size parsing
-        // can appear as "size: 24GiB" or "size: 512MiB"
-        if (trimmed.startsWith("size:")) {
-            QString s = trimmed.section(':', 1).trimmed();
-            
-            // if this is the first size we see, it might be the system total
-            // usually grouped under *-memory
-            if (!s.isEmpty()) {
-                double val = 0.0;
-                long long currentBytes = 0;
-                
-                // naive parsing for GiB/MiB/KB
-                if (s.endsWith("GiB")) {
-                    val = s.left(s.length() - 3).toDouble();
-                    currentBytes = (long long)(val * 1024 * 1024 * 1024);
-                } else if (s.endsWith("MiB")) {
-                    val = s.left(s.length() - 3).toDouble();
-                    currentBytes = (long long)(val * 1024 * 1024);
-                } else if (s.endsWith("KiB")) { // rare for main memory
-                    val = s.left(s.length() - 3).toDouble();
-                    currentBytes = (long long)(val * 1024);
-                } else if (s.endsWith("B")) {
-                    currentBytes = s.left(s.length() - 1).toLongLong();
-                }
-
-                if (currentBytes > 0) {
-                    // if we found a "system memory" bank size before, maybe we should stop?
-                    // for now let's just take the first valid size we see as it's typically the total
-                    // when running without sudo.
-                    if (!foundAnySize) {
-                        totalBytes = currentBytes;
-                        foundAnySize = true;
-                    }
-                }
-            }
-        }
-
-        // clock speed
-        // "clock: 2400MHz"
-        if (trimmed.startsWith("clock:")) {
-            QString c = trimmed.section(':', 1).trimmed();
-            if (speedStr == "Unknown MHz" && !c.isEmpty()) {
-                speedStr = c;
-                // add space if missing (e.g. 2400MHz -> 2400 MHz)
-                if (speedStr.endsWith("MHz") && !speedStr.contains(" ")) {
-                     speedStr.insert(speedStr.length() - 3, " ");
-                }
-            }
-        }
 
-        // type from description
-        // "description: System Memory" isn't useful for type
-        // look for "DDR"
-        if (trimmed.startsWith("description:")) {
-            QString d = trimmed.section(':', 1).trimmed();
-            if (d.contains("DDR")) {
-                QRegularExpression ddrRe("(DDR\\d+)");
-                QRegularExpressionMatch match = ddrRe.match(d);
-                if (match.hasMatch()) {
-                    typeStr = match.captured(1);
-                }
-            }
-        }
-    }
+    if (info.speedMts > 0) speedStr = QString("%1 MHz").arg(info.speedMts);
+    if (!info.type.isEmpty()) typeStr = info.type;
 
-    // if parsing failed entirely, fallback to a sensible "0 GB"
-    if (foundAnySize && totalBytes > 0) {
-        double gb = totalBytes / 1024.0 / 1024.0 / 1024.0;
+    // if probing failed entirely, fallback to a sensible "0 GB"
+    if (info.totalBytes > 0) {
+        double gb = info.totalBytes / 1024.0 / 1024.0 / 1024.0;
         int gbInt = std::round(gb);
         sizeStr = QString::number(gbInt) + " GB";
     } else {
@@ -184,59 +550,18 @@ QString getMemoryInfo() {
     return QString("%1 %2 %3").arg(sizeStr, speedStr, typeStr);
 }
 
-QString getGraphicsInfo() {
-    // Use `lspci -vmm` for easy parsing
-    QProcess p;
-    p.start("lspci", QStringList() << "-vmm");
-    p.waitForFinished();
-    QString output = p.readAllStandardOutput();
-    
-    // Blocks separated by newlines.
-    // Class: VGA compatible controller
-    // Vendor: ...
-    // Device: ...
-    
-    QStringList blocks = output.split("\n\n"); // Split by empty line
-    QString deviceName;
-    
-    for (const QString &block : blocks) {
-        if (block.contains("VGA compatible controller") || block.contains("3D controller")) {
-            QString vendor;
-            QString device;
-            
-            QStringList lines = block.split('\n');
-            for (const QString &line : lines) {
-                if (line.startsWith("Vendor:")) vendor = line.section(':', 1).trimmed();
-                if (line.startsWith("Device:")) device = line.section(':', 1).trimmed();
-            }
-            
-            if (!vendor.isEmpty() && !device.isEmpty()) {
-                // Heuristic: If device already contains vendor, don't repeat it?
-                // Example: Vendor="NVIDIA", Device="GA102 [GeForce RTX 3080]"
-                // Or Vendor="Intel", Device="Iris Xe Graphics"
-                
-                // Clean Device string (often contains bracketed info in -vmm output if it resolved names?)
-                // Actually -vmm normally resolves names if database is present.
-                
-                // Let's construct "[Vendor] [Device]" but avoid redundant "Intel Intel..."
-                if (device.startsWith(vendor, Qt::CaseInsensitive)) {
-                    deviceName = device;
-                } else {
-                    deviceName = vendor + " " + device;
-                }
-                break; // Found primary GPU
-            }
-        }
-    }
-    
-    if (deviceName.isEmpty()) return "Graphics Controller";
-    
-    return deviceName;
+QString formatGraphics(const GraphicsInfo &info) {
+    // One line per GPU, boot GPU first; the value label wraps anyway.
+    QStringList names;
+    for (const GraphicsDevice &gpu : info.devices) names << gpu.name;
+
+    if (names.isEmpty()) return "Graphics Controller";
+
+    return names.join('\n');
 }
 
-QString getStartupDiskInfo() {
-    QStorageInfo root("/");
-    double total = root.bytesTotal() / 1000.0 / 1000.0 / 1000.0; // GB decimal
+QString formatStartupDisk(const DiskInfo &info) {
+    double total = info.bytesTotal / 1000.0 / 1000.0 / 1000.0; // GB decimal
     QString sizeStr;
     if (total >= 1000) {
         sizeStr = QString::number(total / 1000.0, 'f', 2) + " TB";
@@ -246,27 +571,86 @@ QString getStartupDiskInfo() {
 
     // "Volume Name + Capacity".
     // "Syn HD (2 TB)"
-    QString name = root.name();
-    if (name.isEmpty()) name = "Syn HD"; 
-    
-    return QString("%1 (%2)").arg(name, sizeStr);
+    return QString("%1 (%2)").arg(info.name, sizeStr);
 }
 
-QString getOSVersion() {
-    QFile file("/etc/os-release");
-    if (file.open(QIODevice::ReadOnly)) {
-        QTextStream in(&file);
-        while (!in.atEnd()) {
-            QString line = in.readLine();
-            if (line.startsWith("VERSION=")) {
-                // VERSION="1.0 Canora (Beta 2)"
-                QString v = line.section('=', 1);
-                v.remove('"');
-                return v;
-            }
-        }
+QString formatStorage(const StorageInfo &info) {
+    // One line per disk: "nvme0n1 Samsung SSD 980 PRO 1TB (1 TB SSD)"
+    QStringList lines;
+    for (const StorageDevice &dev : info.devices) {
+        QString model = QStringList({ dev.vendor, dev.model }).join(' ').simplified();
+        DiskInfo sized;
+        sized.name = model.isEmpty() ? dev.name : dev.name + " " + model;
+        sized.bytesTotal = dev.bytesTotal;
+        QString line = formatStartupDisk(sized);
+        line.insert(line.size() - 1, dev.rotational ? " HDD" : " SSD");
+        lines << line;
+    }
+    int network = 0;
+    for (const Volume &v : info.volumes) {
+        if (v.network) ++network;
+    }
+    if (network > 0) lines << QString("%1 network volume%2").arg(network).arg(network == 1 ? "" : "s");
+    return lines.join('\n');
+}
+
+QString formatOSVersion(const OSInfo &info) {
+    if (info.version.isEmpty()) return "Unknown Version";
+    return info.version;
+}
+
+QString formatMeasuredMemory(const MemoryMeasurement &m) {
+    // Triad is the STREAM headline; DRAM latency is the last chase point.
+    QStringList parts;
+    if (m.triadGBs > 0.0) parts << QString::number(m.triadGBs, 'f', 1) + " GB/s";
+    if (!m.latency.isEmpty() && m.latency.last().level == "DRAM") {
+        parts << QString::number(qRound(m.latency.last().ns)) + " ns";
     }
-    return "Unknown Version";
+    if (parts.isEmpty()) return QString();
+    return "Measured " + parts.join(", ") + (m.cacheBound ? " (partly cache)" : "");
+}
+
+QString formatDiskBenchmark(const DiskBenchmark &b) {
+    // Best sequential bandwidth and best random IOPS, whatever depth got them.
+    const DiskThroughput *seq = nullptr;
+    const DiskThroughput *rand = nullptr;
+    for (const DiskThroughput &r : b.runs) {
+        if (r.pattern == "sequential" && (!seq || r.mbPerSec > seq->mbPerSec)) seq = &r;
+        if (r.pattern == "random" && (!rand || r.iops > rand->iops)) rand = &r;
+    }
+
+    QStringList parts;
+    if (seq) {
+        parts << (seq->mbPerSec >= 1000.0 ? QString::number(seq->mbPerSec / 1000.0, 'f', 1) + " GB/s"
+                                          : QString::number(qRound(seq->mbPerSec)) + " MB/s");
+    }
+    if (rand) {
+        const QString iops = rand->iops >= 1000.0 ? QString::number(qRound(rand->iops / 1000.0)) + "K"
+                                                  : QString::number(qRound(rand->iops));
+        parts << QString("%1 IOPS (p99 %2 µs)").arg(iops).arg(qRound(rand->p99Us));
+    }
+    if (parts.isEmpty()) return QString();
+    return "Measured " + parts.join(", ");
+}
+
+QString getProcessorInfo() {
+    return formatProcessor(probeProcessor());
+}
+
+QString getMemoryInfo() {
+    return formatMemory(probeMemory());
+}
+
+QString getGraphicsInfo() {
+    return formatGraphics(probeGraphics());
+}
+
+QString getStartupDiskInfo() {
+    return formatStartupDisk(probeStartupDisk());
+}
+
+QString getOSVersion() {
+    return formatOSVersion(probeOS());
 }
 
 }
@@ -6,17 +6,291 @@
 #ifndef HARDWARE_H
 #define HARDWARE_H
 
+#include <QDeadlineTimer>
+#include <QJsonObject>
 #include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include <memory>
 
+// The Hardware namespace is built as the standalone hwprobe library, which
+// only depends on Qt Core (and Qt Concurrent for parallel probing). Nothing
+// in here may pull in Gui or Widgets: the headless --json mode relies on it.
 namespace Hardware {
 
-// Returns e.g. "3.2 GHz 6-core Intel Core i5"
+// Probe configuration
+// -------------------
+
+// Points every probe at a captured tree instead of the live machine: /proc,
+// /sys and /etc are read from below root, and external tools are replaced by
+// their canned output in root/tools/<tool>.txt (lscpu.txt, lspci-vmm.txt).
+// An empty root (the default) means the running system. Set before probing.
+void setSysRoot(const QString &root);
+QString sysRoot();
+
+enum class Backend {
+    Native,     // /proc, sysfs, SMBIOS and pci.ids, with tools as fallback
+    Legacy      // always go through lscpu / lspci (for comparisons)
+};
+void setBackend(Backend backend);
+Backend backend();
+
+// Time budget for the probes running on the calling thread. An external tool
+// still running when the deadline passes, or once *cancelled turns true, is
+// killed and its output so far is parsed as-is. Without limits a tool gets
+// 30 seconds, as QProcess always allowed.
+struct ProbeLimits {
+    QDeadlineTimer deadline = QDeadlineTimer(QDeadlineTimer::Forever);
+    std::shared_ptr<const std::atomic<bool>> cancelled;
+};
+void setProbeLimits(const ProbeLimits &limits);
+void clearProbeLimits();
+
+// True if a tool was cut short on this thread since the last setProbeLimits(),
+// i.e. the result just returned may be missing fields.
+bool probeLimitReached();
+
+// Structured results
+// ------------------
+// Each probe*() returns everything it found; the get*Info() helpers below
+// format these into the one-line strings the card shows.
+
+struct CpuThread {
+    int cpu = 0;                // logical CPU number
+    int package = 0;
+    int core = 0;               // core_id, unique within its package
+    int node = -1;              // NUMA node, -1 if unknown
+    double maxGhz = 0.0;
+};
+
+struct NumaNode {
+    int id = 0;
+    QString cpuList;            // "0-95,192-287"; empty for memory-only nodes
+    int cpus = 0;
+    quint64 memoryBytes = 0;
+    quint64 freeBytes = 0;
+    QVector<int> distances;     // to node 0, 1, ...; 10 is local
+};
+
+struct CpuCache {
+    int level = 0;
+    QString type;               // "Data", "Instruction" or "Unified"
+    quint32 sizeKb = 0;         // one instance
+    int ways = 0;
+    int lineBytes = 0;
+    int sharedBy = 0;           // logical CPUs per instance
+};
+
+struct ProcessorInfo {
+    QString model;              // cleaned, e.g. "Intel Core i5-8400"
+    QString rawModel;           // as reported by the kernel / lscpu
+    int physicalCores = 0;
+    int logicalCpus = 0;
+    int sockets = 0;
+    int threadsPerCore = 0;     // 0 if unknown
+    int llcDomains = 0;         // last-level cache instances, e.g. one per CCX
+    int numaNodes = 0;          // 0 if unknown; nodes may be empty when known from a snapshot
+    double maxGhz = 0.0;
+    QVector<CpuThread> threads; // online CPUs; empty when lscpu answered
+    QVector<NumaNode> nodes;
+    QString vendor;             // "GenuineIntel", "AuthenticAMD", empty if unknown
+    int family = 0;
+    int modelId = 0;
+    int stepping = 0;
+    QStringList isa;            // usable extensions, e.g. "SSE4.2", "AVX2", "AMX-TILE"
+    QVector<CpuCache> caches;   // as seen from CPU 0, L1 first
+    bool hybrid = false;
+    int performanceCpus = 0;    // logical CPUs per core type, hybrid parts only
+    int efficiencyCpus = 0;
+};
+
+struct MemoryModule {
+    quint64 sizeBytes = 0;
+    QString type;
+    int speedMts = 0;
+    int configuredMts = 0;
+    QString locator;
+    QString bankLocator;
+    QString manufacturer;
+    QString partNumber;
+};
+
+struct MemoryInfo {
+    quint64 totalBytes = 0;
+    int speedMts = 0;           // slowest configured speed across DIMMs
+    QString type;               // e.g. "DDR4", empty if unknown
+    QString source;             // "smbios" or "meminfo"
+    QVector<MemoryModule> modules;
+};
+
+struct GraphicsDevice {
+    QString slot;               // PCI address, empty when it came from lspci
+    quint16 vendorId = 0;
+    quint16 deviceId = 0;
+    quint32 classCode = 0;
+    bool bootVga = false;
+    QString vendor;
+    QString device;
+    QString name;               // "[Vendor] [Device]" without the repetition
+};
+
+struct GraphicsInfo {
+    QVector<GraphicsDevice> devices;    // boot GPU first
+};
+
+struct DiskInfo {
+    QString name;               // volume name, "Syn HD" if it has none
+    QString rootPath;
+    QString device;
+    QString fileSystem;
+    quint64 bytesTotal = 0;
+    quint64 bytesAvailable = 0;
+};
+
+struct StorageDevice {
+    QString name;               // kernel name, "nvme0n1"
+    QString model;
+    QString vendor;
+    quint64 bytesTotal = 0;
+    bool rotational = false;
+    bool removable = false;
+    int logicalBlockSize = 0;
+    int physicalBlockSize = 0;
+    int queueDepth = 0;
+    QString scheduler;
+};
+
+struct Volume {
+    QString device;             // "/dev/nvme0n1p2", "server:/export"
+    QString mountPoint;
+    QString fileSystem;
+    QString disk;               // StorageDevice::name it lives on, empty for network
+    bool network = false;
+    bool timedOut = false;      // statvfs didn't answer in time; sizes are 0
+    quint64 bytesTotal = 0;
+    quint64 bytesAvailable = 0;
+};
+
+// What the memory actually delivers, as opposed to what SMBIOS says it is.
+struct MemoryLatencyPoint {
+    QString level;              // "L1", "L2", "L3" or "DRAM"
+    quint64 bytes = 0;          // working set it was measured at
+    double ns = 0.0;
+};
+
+struct MemoryMeasurement {
+    QString kernel;             // "avx512", "avx2", "sse2", "scalar"; empty if nothing ran
+    int threads = 0;
+    double copyGBs = 0.0;
+    double triadGBs = 0.0;
+    QVector<MemoryLatencyPoint> latency;    // L1 first, DRAM last
+    bool cacheBound = false;    // not enough free memory to get past the caches; partly cache speed
+};
+
+// Read throughput the startup disk delivers, one run per pattern and depth.
+struct DiskThroughput {
+    QString pattern;            // "sequential" or "random"
+    int queueDepth = 0;
+    int blockBytes = 0;
+    double mbPerSec = 0.0;
+    double iops = 0.0;
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+};
+
+struct DiskBenchmark {
+    QString target;             // "/dev/nvme0n1p2" or a file
+    QString engine;             // "io_uring" or "aio"; empty if nothing ran
+    QString error;              // why nothing ran, e.g. permission denied
+    bool direct = false;        // false: the page cache may be in the numbers
+    QVector<DiskThroughput> runs;   // sequential first, each by queue depth
+};
+
+struct StorageInfo {
+    QVector<StorageDevice> devices;
+    QVector<Volume> volumes;    // startup volume ("/") first
+};
+
+struct OSInfo {
+    QString name;               // NAME=
+    QString version;            // VERSION=, e.g. "1.0 Canora (Beta 2)"
+    QString versionId;          // VERSION_ID=
+    QString prettyName;         // PRETTY_NAME=
+};
+
+struct Snapshot {
+    OSInfo os;
+    ProcessorInfo processor;
+    MemoryInfo memory;
+    GraphicsInfo graphics;
+    DiskInfo startupDisk;
+    StorageInfo storage;
+};
+
+ProcessorInfo probeProcessor();
+MemoryInfo probeMemory();
+GraphicsInfo probeGraphics();
+DiskInfo probeStartupDisk();
+
+// Every disk in /sys/block and every mounted local or network volume. The
+// statvfs calls run in parallel, each bounded by the probe deadline (one
+// second at most), so a hung NFS mount only costs its own row.
+StorageInfo probeStorage();
+// The disks only, volumes left empty; what the fleet reads from a sysroot.
+StorageInfo probeStorageDevices();
+OSInfo probeOS();
+
+// Runs every probe concurrently and waits for all of them. Every probe gets
+// the calling thread's limits, and probeLimitReached() afterwards says
+// whether any of them ran out.
+Snapshot probeAll();
+
+// STREAM copy/triad bandwidth on every core plus pointer-chase latency per
+// cache level and DRAM. Keeps all CPUs busy for a couple of seconds, so it's
+// opt-in (--measure) and never part of probeAll() or the card's first paint.
+// The calling thread's probe limits bound it: the deadline caps the run and
+// cancellation stops it between repetitions. Empty under a sysroot.
+MemoryMeasurement measureMemory();
+
+// Sequential and random O_DIRECT reads at queue depths 1, 4 and 32 through
+// io_uring (or Linux AIO). Read-only, but raw block devices usually need root;
+// a regular file works too. Bounded by the probe limits like measureMemory().
+DiskBenchmark benchmarkDisk(const QString &path);
+DiskBenchmark benchmarkStartupDisk();
+
+QString formatProcessor(const ProcessorInfo &info);
+QString formatMemory(const MemoryInfo &info);
+QString formatGraphics(const GraphicsInfo &info);
+QString formatStartupDisk(const DiskInfo &info);
+QString formatStorage(const StorageInfo &info);
+QString formatOSVersion(const OSInfo &info);
+// "Measured 38.2 GB/s, 91 ns"; empty if nothing was measured
+QString formatMeasuredMemory(const MemoryMeasurement &m);
+// "Measured 2.1 GB/s, 350K IOPS (p99 120 µs)"; empty if nothing was measured
+QString formatDiskBenchmark(const DiskBenchmark &b);
+
+QJsonObject toJson(const ProcessorInfo &info);
+QJsonObject toJson(const MemoryInfo &info);
+QJsonObject toJson(const GraphicsInfo &info);
+QJsonObject toJson(const DiskInfo &info);
+QJsonObject toJson(const StorageInfo &info);
+QJsonObject toJson(const OSInfo &info);
+QJsonObject toJson(const MemoryMeasurement &m);
+QJsonObject toJson(const DiskBenchmark &b);
+QJsonObject toJson(const Snapshot &snapshot);
+
+// Card strings
+// ------------
+
+// Returns e.g. "3.2 GHz 6-core Intel Core i5", or on bigger iron
+// "2.4 GHz 2 × 96-core AMD EPYC 9654, 2 NUMA nodes"
 QString getProcessorInfo();
 
 // Returns e.g. "16 GB 2400 MHz DDR4" or just "16 GB" if details unavailable
 QString getMemoryInfo();
 
-// Returns e.g. "AMD Radeon RX 580 8 GB"
+// Returns e.g. "AMD Radeon RX 580 8 GB", one line per GPU with the boot GPU first
 QString getGraphicsInfo();
 
 // Returns e.g. "Macintosh HD (500 GB)" - Volume name + Capacity
@@ -0,0 +1,359 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef HARDWARE_P_H
+#define HARDWARE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the public Hardware API. It holds the native
+// (fork-free) probe backends that hardware.cpp dispatches to, and may change
+// from one commit to the next.
+//
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Hardware {
+namespace Native {
+
+struct CpuThread {
+    int cpu = 0;                // N in cpuN
+    int package = 0;
+    int core = 0;
+    int node = -1;              // NUMA node, -1 if the kernel has no node directory
+    long long maxKhz = 0;
+};
+
+struct NumaNode {
+    int id = 0;                 // N in nodeN
+    std::string cpuList;        // "0-95,192-287"; empty for memory-only nodes
+    int cpus = 0;
+    uint64_t memTotalBytes = 0;
+    uint64_t memFreeBytes = 0;
+    std::vector<int> distances; // SLIT row, to node 0, 1, ... in order
+};
+
+struct ProcessorFacts {
+    std::string modelName;      // raw, uncleaned "model name" from /proc/cpuinfo
+    int physicalCores = 0;      // distinct (package, core) pairs
+    int sockets = 0;            // distinct packages
+    int logicalCpus = 0;        // online CPUs with a topology directory
+    int threadsPerCore = 0;     // widest thread_siblings_list, 1 without SMT
+    int llcDomains = 0;         // distinct last-level cache shared_cpu_lists
+    double maxMhz = 0.0;        // highest cpuinfo_max_freq across CPUs
+    std::vector<CpuThread> threads; // online CPUs, in cpuN order
+    std::vector<NumaNode> nodes;    // in nodeN order; empty on non-NUMA kernels
+    const char *reader = "";    // how the sysfs batch was read: "io_uring" or "pread"
+};
+
+// Reads /proc/cpuinfo, /sys/devices/system/cpu and /sys/devices/system/node
+// directly. Every per-CPU and per-node attribute goes through one
+// SysFs::readBatch(), which on a 384-thread box is a couple of thousand
+// files. Returns false if sysfs topology isn't there (old kernels, some
+// containers) so the caller can fall back to lscpu. modelName can be empty
+// when the rest succeeded; cpuinfo has no "model name" on most ARM boxes.
+bool probeProcessor(ProcessorFacts &facts);
+
+// Instruction set extensions worth scheduling on. A bit is only set when the
+// CPU has it and, for the AVX/AVX-512/AMX families, the kernel has enabled
+// the register state for it (XCR0), i.e. when code can actually use it.
+enum IsaFeature : uint32_t {
+    IsaSse2         = 1u << 0,
+    IsaSse3         = 1u << 1,
+    IsaSsse3        = 1u << 2,
+    IsaSse41        = 1u << 3,
+    IsaSse42        = 1u << 4,
+    IsaPopcnt       = 1u << 5,
+    IsaAes          = 1u << 6,
+    IsaSha          = 1u << 7,
+    IsaBmi1         = 1u << 8,
+    IsaBmi2         = 1u << 9,
+    IsaAvx          = 1u << 10,
+    IsaF16c         = 1u << 11,
+    IsaFma          = 1u << 12,
+    IsaAvx2         = 1u << 13,
+    IsaAvxVnni      = 1u << 14,
+    IsaAvx512F      = 1u << 15,
+    IsaAvx512Cd     = 1u << 16,
+    IsaAvx512Dq     = 1u << 17,
+    IsaAvx512Bw     = 1u << 18,
+    IsaAvx512Vl     = 1u << 19,
+    IsaAvx512Vnni   = 1u << 20,
+    IsaAvx512Bf16   = 1u << 21,
+    IsaAmxTile      = 1u << 22,
+    IsaAmxInt8      = 1u << 23,
+    IsaAmxBf16      = 1u << 24,
+};
+
+// "AVX-512F", "SSE4.2", ... for a single bit; nullptr for anything else.
+const char *isaFeatureName(uint32_t feature);
+
+// Bits for the names in a /proc/cpuinfo "flags" line ("sse4_2 avx2 ...").
+// The kernel already leaves out what it hasn't enabled.
+uint32_t isaFeaturesFromFlags(std::string_view flags);
+
+struct CacheLevel {
+    int level = 0;              // 1, 2, 3
+    char type = 'U';            // 'D'ata, 'I'nstruction or 'U'nified
+    uint32_t sizeKb = 0;        // one instance
+    int ways = 0;
+    int lineBytes = 0;
+    int sharedBy = 0;           // logical CPUs per instance (cpuid: upper bound)
+};
+
+struct IsaFacts {
+    enum Source { None, Cpuid, CpuInfo };
+
+    Source source = None;
+    std::string vendor;         // "GenuineIntel", "AuthenticAMD"
+    std::string brand;          // cpuid brand string, untrimmed
+    int family = 0;             // display family/model, extended fields folded in
+    int model = 0;
+    int stepping = 0;
+    uint32_t features = 0;      // IsaFeature bits
+    std::vector<CacheLevel> caches;     // cpu0's view, L1 first
+    bool hybrid = false;        // P-cores and E-cores in one package
+    int performanceCpus = 0;    // logical CPUs of each kind, hybrid parts only
+    int efficiencyCpus = 0;
+};
+
+// On the live x86 machine this is the cpuid instruction (leaves 0x0, 0x1,
+// 0x7, 0x4 or AMD's 0x8000001D and the brand string), decoded once and kept,
+// so repeat calls make no syscalls at all. Leaf 0x7 only says the part is
+// hybrid; its P/E counts come from the cpu_core and cpu_atom CPU lists in
+// sysfs. Under a sysroot, or without cpuid, it falls back to the cpuinfo
+// flags and sysfs cache/index*. Returns false if neither worked.
+bool probeIsa(IsaFacts &facts);
+
+struct MemoryModule {
+    uint64_t sizeBytes = 0;
+    std::string type;           // "DDR4", "LPDDR5", ... empty if unknown
+    int speedMts = 0;           // rated speed
+    int configuredMts = 0;      // speed the controller actually runs it at
+    std::string locator;        // "DIMM_A1"
+    std::string bankLocator;
+    std::string manufacturer;
+    std::string partNumber;
+};
+
+struct MemoryFacts {
+    enum Source { None, Smbios, MemInfo };
+
+    Source source = None;
+    uint64_t totalBytes = 0;
+    std::vector<MemoryModule> modules;  // populated DIMMs only; empty for MemInfo
+};
+
+// Decodes SMBIOS Type 16/17 records from a raw structure table (the contents
+// of /sys/firmware/dmi/tables/DMI). Only devices hanging off a "system memory"
+// array are counted. Returns false if no populated DIMM was found.
+bool decodeSmbiosMemory(const unsigned char *data, size_t length, MemoryFacts &facts);
+
+// Reads the DMI table if it's readable (usually root only) and falls back to
+// MemTotal from /proc/meminfo otherwise.
+bool probeMemory(MemoryFacts &facts);
+
+struct GraphicsDevice {
+    std::string slot;           // "0000:01:00.0"
+    uint16_t vendorId = 0;
+    uint16_t deviceId = 0;
+    uint32_t classCode = 0;     // 0x030000 VGA, 0x030200 3D, ...
+    bool bootVga = false;       // the one the firmware console came up on
+    std::string vendorName;     // from pci.ids, empty if unknown
+    std::string deviceName;
+};
+
+struct GraphicsFacts {
+    std::vector<GraphicsDevice> devices;    // boot VGA first, then by slot
+};
+
+// Walks /sys/bus/pci/devices for display controllers (class 0x03) and names
+// them from pci.ids. Returns false if there's no PCI sysfs or no usable
+// pci.ids, in which case lspci is the better bet.
+bool probeGraphics(GraphicsFacts &facts);
+
+struct MemoryLatency {
+    int level = 0;              // cache level the working set fits in; 0 = DRAM
+    uint64_t bytes = 0;         // working set
+    double ns = 0.0;            // per dependent load
+};
+
+struct MemoryBench {
+    const char *kernel = "";    // "avx512", "avx2", "sse2" or "scalar"
+    int threads = 0;            // one per allowed CPU, each pinned
+    uint64_t bytesPerThread = 0;
+    double copyGBs = 0.0;       // STREAM accounting: 16 bytes per element
+    double triadGBs = 0.0;      // 24 bytes per element
+    std::vector<MemoryLatency> latency;     // L1 first, DRAM last
+    bool cacheBound = false;    // free memory held a working set under its LLC multiple
+};
+
+struct MemoryBenchOptions {
+    int threads = 0;            // 0: every CPU we're allowed on
+    int budgetMs = 2000;        // rough wall-clock cap for the whole run
+};
+
+// Measures delivered bandwidth (STREAM copy and triad with non-temporal
+// stores, widest SIMD the CPU and kernel allow, one pinned thread per CPU on
+// its own first-touched arrays) and load latency (a random pointer chase at
+// half of each cache level from probeIsa(), then well past the LLC). Both
+// size "past the LLC" from every LLC instance on the machine. Busy
+// for about budgetMs plus the time it takes to fault the working sets in;
+// stops between repetitions once *cancelled turns true.
+// Live machine only: returns false under a sysroot or if it was cancelled
+// before a single repetition finished.
+bool measureMemory(MemoryBench &bench, const MemoryBenchOptions &options, const std::atomic<bool> *cancelled);
+
+struct DiskBenchResult {
+    bool sequential = false;    // else random
+    int queueDepth = 0;
+    uint32_t blockBytes = 0;
+    uint64_t ios = 0;
+    double mbPerSec = 0.0;
+    double iops = 0.0;
+    double p50Us = 0.0;         // submit to completion
+    double p99Us = 0.0;
+};
+
+struct DiskBench {
+    const char *engine = "";    // "io_uring" or "aio"
+    bool direct = false;        // O_DIRECT was accepted; if not, the page cache is in the numbers
+    std::string target;
+    std::vector<DiskBenchResult> results;   // sequential runs first, each by queue depth
+};
+
+struct DiskBenchOptions {
+    std::vector<int> queueDepths = { 1, 4, 32 };
+    int msPerRun = 300;
+    uint32_t seqBlockBytes = 1u << 20;
+    uint32_t randBlockBytes = 4096;
+    uint64_t spanBytes = 0;     // 0: the whole device or file
+};
+
+// Read-only throughput of a block device or a regular file: sequential and
+// random reads at each queue depth, msPerRun apiece, through io_uring (raw
+// syscalls) or, where that's unavailable, Linux AIO. Reads are O_DIRECT with
+// sector-aligned buffers and offsets. Nothing is ever written. Stops after the
+// current run once *cancelled turns true. Returns false if nothing could be
+// measured, with the reason in *error.
+bool benchmarkDisk(const std::string &path, DiskBench &bench, const DiskBenchOptions &options,
+                   const std::atomic<bool> *cancelled, std::string *error);
+
+struct BlockDevice {
+    std::string name;           // "nvme0n1", "sda"
+    std::string model;          // device/model, trimmed
+    std::string vendor;         // device/vendor (SCSI/SATA only)
+    uint64_t sizeBytes = 0;
+    bool rotational = false;
+    bool removable = false;
+    int logicalBlockSize = 0;
+    int physicalBlockSize = 0;
+    int queueDepth = 0;         // queue/nr_requests
+    std::string scheduler;      // the active one, "none" for most NVMe
+};
+
+struct Volume {
+    std::string source;         // "/dev/nvme0n1p2", "server:/export"
+    std::string mountPoint;
+    std::string fileSystem;
+    std::string disk;           // owning entry in /sys/block, empty for network and ZFS
+    bool network = false;
+    bool statted = false;       // statvfs answered in time
+    bool timedOut = false;      // ... or didn't: a hung NFS server, say
+    uint64_t bytesTotal = 0;
+    uint64_t bytesAvailable = 0;
+};
+
+struct StorageFacts {
+    std::vector<BlockDevice> devices;   // by name; loop/ram/zram left out
+    std::vector<Volume> volumes;        // "/" first, then in mount order
+};
+
+// Enumerates /sys/block and the block-backed and network mounts in
+// /proc/self/mountinfo (bind mounts of the same filesystem counted once),
+// then runs statvfs on every volume at the same time, each on its own
+// thread. Volumes that haven't answered after timeoutMs, or when *cancelled
+// turns true, are reported with timedOut set; their threads are left to
+// finish (or not) on their own. Returns false if /sys/block is missing.
+bool probeStorage(StorageFacts &facts, int timeoutMs, const std::atomic<bool> *cancelled);
+
+// Just the /sys/block walk: no mountinfo, no statvfs, no threads. For
+// captured trees, where volumes would describe this machine anyway.
+bool probeBlockDevices(std::vector<BlockDevice> &devices);
+
+// Text parsers
+// ------------
+// For tool output and /etc files. They take the raw bytes and hand back
+// views into them, so a parse allocates nothing; see textscan.h.
+
+struct MountEntry {
+    std::string_view majorMinor;    // "259:2"
+    std::string_view mountPoint;    // still octal-escaped ("\040" for a space)
+    std::string_view fileSystem;
+    std::string_view source;
+};
+
+// One line of /proc/self/mountinfo; false if it's malformed.
+bool parseMountInfoLine(std::string_view line, MountEntry &entry);
+
+struct LscpuFacts {
+    std::string_view modelName;
+    int coresPerSocket = 1;
+    int sockets = 1;
+    double maxMhz = 0.0;        // 0 if lscpu didn't say
+};
+void parseLscpu(std::string_view text, LscpuFacts &facts);
+
+struct LspciDevice {
+    std::string_view vendor;
+    std::string_view device;
+};
+
+// First VGA or 3D controller in `lspci -vmm` output with both names set.
+bool parseLspciGraphics(std::string_view text, LspciDevice &gpu);
+
+struct OsReleaseFacts {
+    std::string_view name;
+    std::string_view version;
+    std::string_view versionId;
+    std::string_view prettyName;
+};
+void parseOsRelease(std::string_view text, OsReleaseFacts &facts);
+
+// "... @ 2.80GHz" -> 2.8; 0 if the model name doesn't carry a clock.
+double ghzFromModelName(std::string_view model);
+
+// Display names (namenorm.cpp), written into a fixed buffer so normalising
+// never touches the heap. Anything past the buffer is cut off.
+struct NameBuffer {
+    char data[128];
+    size_t size = 0;
+    std::string_view view() const { return std::string_view(data, size); }
+};
+
+// "Intel(R) Core(TM) i5-8400 CPU @ 2.80GHz" -> "Intel Core i5-8400",
+// "AMD Ryzen 7 5800X 8-Core Processor" -> "AMD Ryzen 7 5800X".
+void normalizeCpuName(std::string_view model, NameBuffer &out);
+
+// "Advanced Micro Devices, Inc. [AMD/ATI]" -> "AMD", "NVIDIA Corporation"
+// -> "NVIDIA". A slice of vendor or of a static table.
+std::string_view shortVendorName(std::string_view vendor);
+
+// pci.ids or lspci vendor and device names to what goes on the card:
+// "Advanced Micro Devices, Inc. [AMD/ATI]" + "Ellesmere [Radeon RX 580]"
+// -> "AMD Radeon RX 580".
+void normalizeGpuName(std::string_view vendor, std::string_view device, NameBuffer &out);
+
+}
+}
+
+#endif // HARDWARE_P_H
@@ -0,0 +1,249 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "hardware.h"
+#include <QJsonArray>
+
+// JSON views of the structured probe results, used by the headless
+// --json mode. Key names are part of the CLI contract: add, don't rename.
+
+namespace Hardware {
+
+namespace {
+
+QString hex4(quint16 v) {
+    return QString("%1").arg(v, 4, 16, QChar('0'));
+}
+
+}
+
+QJsonObject toJson(const ProcessorInfo &info) {
+    QJsonArray threads;
+    for (const CpuThread &t : info.threads) {
+        QJsonObject to;
+        to["cpu"] = t.cpu;
+        to["package"] = t.package;
+        to["core"] = t.core;
+        to["node"] = t.node;
+        to["maxGhz"] = t.maxGhz;
+        threads.append(to);
+    }
+
+    QJsonArray nodes;
+    for (const NumaNode &n : info.nodes) {
+        QJsonArray distances;
+        for (int d : n.distances) distances.append(d);
+        QJsonObject no;
+        no["id"] = n.id;
+        no["cpuList"] = n.cpuList;
+        no["cpus"] = n.cpus;
+        no["memoryBytes"] = double(n.memoryBytes);
+        no["freeBytes"] = double(n.freeBytes);
+        no["distances"] = distances;
+        nodes.append(no);
+    }
+
+    QJsonArray caches;
+    for (const CpuCache &c : info.caches) {
+        QJsonObject co;
+        co["level"] = c.level;
+        co["type"] = c.type;
+        co["sizeKb"] = qint64(c.sizeKb);
+        co["ways"] = c.ways;
+        co["lineBytes"] = c.lineBytes;
+        co["sharedBy"] = c.sharedBy;
+        caches.append(co);
+    }
+
+    QJsonObject o;
+    o["model"] = info.model;
+    o["rawModel"] = info.rawModel;
+    o["physicalCores"] = info.physicalCores;
+    o["logicalCpus"] = info.logicalCpus;
+    o["sockets"] = info.sockets;
+    o["threadsPerCore"] = info.threadsPerCore;
+    o["llcDomains"] = info.llcDomains;
+    o["numaNodes"] = info.numaNodes;
+    o["maxGhz"] = info.maxGhz;
+    o["threads"] = threads;
+    o["nodes"] = nodes;
+    o["vendor"] = info.vendor;
+    o["family"] = info.family;
+    o["modelId"] = info.modelId;
+    o["stepping"] = info.stepping;
+    o["isa"] = QJsonArray::fromStringList(info.isa);
+    o["caches"] = caches;
+    o["hybrid"] = info.hybrid;
+    if (info.hybrid) {
+        o["performanceCpus"] = info.performanceCpus;
+        o["efficiencyCpus"] = info.efficiencyCpus;
+    }
+    o["summary"] = formatProcessor(info);
+    return o;
+}
+
+QJsonObject toJson(const MemoryInfo &info) {
+    QJsonArray modules;
+    for (const MemoryModule &m : info.modules) {
+        QJsonObject mo;
+        mo["sizeBytes"] = double(m.sizeBytes);
+        mo["type"] = m.type;
+        mo["speedMts"] = m.speedMts;
+        mo["configuredMts"] = m.configuredMts;
+        mo["locator"] = m.locator;
+        mo["bankLocator"] = m.bankLocator;
+        mo["manufacturer"] = m.manufacturer;
+        mo["partNumber"] = m.partNumber;
+        modules.append(mo);
+    }
+
+    QJsonObject o;
+    o["totalBytes"] = double(info.totalBytes);
+    o["speedMts"] = info.speedMts;
+    o["type"] = info.type;
+    o["source"] = info.source;
+    o["modules"] = modules;
+    o["summary"] = formatMemory(info);
+    return o;
+}
+
+QJsonObject toJson(const GraphicsInfo &info) {
+    QJsonArray devices;
+    for (const GraphicsDevice &gpu : info.devices) {
+        QJsonObject d;
+        d["slot"] = gpu.slot;
+        d["vendorId"] = hex4(gpu.vendorId);
+        d["deviceId"] = hex4(gpu.deviceId);
+        d["classCode"] = QString("%1").arg(gpu.classCode, 6, 16, QChar('0'));
+        d["bootVga"] = gpu.bootVga;
+        d["vendor"] = gpu.vendor;
+        d["device"] = gpu.device;
+        d["name"] = gpu.name;
+        devices.append(d);
+    }
+
+    QJsonObject o;
+    o["devices"] = devices;
+    o["summary"] = formatGraphics(info);
+    return o;
+}
+
+QJsonObject toJson(const DiskInfo &info) {
+    QJsonObject o;
+    o["name"] = info.name;
+    o["rootPath"] = info.rootPath;
+    o["device"] = info.device;
+    o["fileSystem"] = info.fileSystem;
+    o["bytesTotal"] = double(info.bytesTotal);
+    o["bytesAvailable"] = double(info.bytesAvailable);
+    o["summary"] = formatStartupDisk(info);
+    return o;
+}
+
+QJsonObject toJson(const StorageInfo &info) {
+    QJsonArray devices;
+    for (const StorageDevice &dev : info.devices) {
+        QJsonObject d;
+        d["name"] = dev.name;
+        d["model"] = dev.model;
+        d["vendor"] = dev.vendor;
+        d["bytesTotal"] = double(dev.bytesTotal);
+        d["rotational"] = dev.rotational;
+        d["removable"] = dev.removable;
+        d["logicalBlockSize"] = dev.logicalBlockSize;
+        d["physicalBlockSize"] = dev.physicalBlockSize;
+        d["queueDepth"] = dev.queueDepth;
+        d["scheduler"] = dev.scheduler;
+        devices.append(d);
+    }
+
+    QJsonArray volumes;
+    for (const Volume &vol : info.volumes) {
+        QJsonObject v;
+        v["device"] = vol.device;
+        v["mountPoint"] = vol.mountPoint;
+        v["fileSystem"] = vol.fileSystem;
+        v["disk"] = vol.disk;
+        v["network"] = vol.network;
+        v["timedOut"] = vol.timedOut;
+        v["bytesTotal"] = double(vol.bytesTotal);
+        v["bytesAvailable"] = double(vol.bytesAvailable);
+        volumes.append(v);
+    }
+
+    QJsonObject o;
+    o["devices"] = devices;
+    o["volumes"] = volumes;
+    o["summary"] = formatStorage(info);
+    return o;
+}
+
+QJsonObject toJson(const OSInfo &info) {
+    QJsonObject o;
+    o["name"] = info.name;
+    o["version"] = info.version;
+    o["versionId"] = info.versionId;
+    o["prettyName"] = info.prettyName;
+    o["summary"] = formatOSVersion(info);
+    return o;
+}
+
+QJsonObject toJson(const MemoryMeasurement &m) {
+    QJsonArray latency;
+    for (const MemoryLatencyPoint &p : m.latency) {
+        QJsonObject lo;
+        lo["level"] = p.level;
+        lo["bytes"] = qint64(p.bytes);
+        lo["ns"] = p.ns;
+        latency.append(lo);
+    }
+
+    QJsonObject o;
+    o["kernel"] = m.kernel;
+    o["threads"] = m.threads;
+    o["copyGBs"] = m.copyGBs;
+    o["triadGBs"] = m.triadGBs;
+    o["latency"] = latency;
+    o["cacheBound"] = m.cacheBound;
+    o["summary"] = formatMeasuredMemory(m);
+    return o;
+}
+
+QJsonObject toJson(const DiskBenchmark &b) {
+    QJsonArray runs;
+    for (const DiskThroughput &r : b.runs) {
+        QJsonObject ro;
+        ro["pattern"] = r.pattern;
+        ro["queueDepth"] = r.queueDepth;
+        ro["blockBytes"] = r.blockBytes;
+        ro["mbPerSec"] = r.mbPerSec;
+        ro["iops"] = r.iops;
+        ro["p50Us"] = r.p50Us;
+        ro["p99Us"] = r.p99Us;
+        runs.append(ro);
+    }
+
+    QJsonObject o;
+    o["target"] = b.target;
+    o["engine"] = b.engine;
+    o["direct"] = b.direct;
+    if (!b.error.isEmpty()) o["error"] = b.error;
+    o["runs"] = runs;
+    o["summary"] = formatDiskBenchmark(b);
+    return o;
+}
+
+QJsonObject toJson(const Snapshot &snapshot) {
+    QJsonObject o;
+    o["os"] = toJson(snapshot.os);
+    o["cpu"] = toJson(snapshot.processor);
+    o["memory"] = toJson(snapshot.memory);
+    o["graphics"] = toJson(snapshot.graphics);
+    o["disk"] = toJson(snapshot.startupDisk);
+    o["storage"] = toJson(snapshot.storage);
+    return o;
+}
+
+}
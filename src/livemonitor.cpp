@@ -0,0 +1,193 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "livemonitor.h"
+#include "sysfs.h"
+#include "textscan.h"
+#include <QTimer>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+ssize_t preadAll(int fd, char *buf, size_t size) {
+    ssize_t n;
+    do {
+        n = ::pread(fd, buf, size, 0);
+    } while (n < 0 && errno == EINTR);
+    return n;
+}
+
+// Value of "Key:   1234 kB" in a /proc/meminfo buffer, in kB; -1 if missing.
+long long meminfoField(std::string_view text, std::string_view key) {
+    Hardware::Text::LineReader lines(text);
+    std::string_view line, value;
+    long long kb = 0;
+    while (lines.next(line)) {
+        if (Hardware::Text::valueFor(line, key, ':', value)) {
+            return Hardware::Text::toLong(value, kb) ? kb : -1;
+        }
+    }
+    return -1;
+}
+
+// value in tenths of unit, rounded, so it compares the way it's printed
+long long tenths(double value, double unit) {
+    return (long long)(value * 10.0 / unit + 0.5);
+}
+
+QString formatTenths(long long tenths, const char *suffix) {
+    return QString::number(tenths / 10.0, 'f', 1) + suffix;
+}
+
+}
+
+// Every fd is opened once, up front; a missing file just drops that value.
+struct LiveMonitor::Sampler {
+    int meminfo = -1;
+    int rootDir = -1;
+    std::vector<int> cpuFreq;   // cpuN/cpufreq/scaling_cur_freq, kMaxSampledCpus at most
+
+    Sampler() {
+        using namespace Hardware;
+        meminfo = ::open(SysFs::resolve("/proc/meminfo").c_str(), O_RDONLY | O_CLOEXEC);
+        rootDir = ::open(SysFs::resolve("/").c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        // Evenly spaced CPUs, so both sockets and both kinds of core on a
+        // hybrid part are in the average, without waking all 384 of them.
+        const std::string cpuDir = "/sys/devices/system/cpu";
+        const std::vector<std::string> cpus = SysFs::listNumbered(cpuDir, "cpu");
+        const size_t step = std::max<size_t>(1, (cpus.size() + kMaxSampledCpus - 1) / kMaxSampledCpus);
+        for (size_t i = 0; i < cpus.size(); i += step) {
+            const std::string path = SysFs::resolve(cpuDir + "/" + cpus[i] + "/cpufreq/scaling_cur_freq");
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd >= 0) cpuFreq.push_back(fd);
+        }
+    }
+
+    ~Sampler() {
+        if (meminfo >= 0) ::close(meminfo);
+        if (rootDir >= 0) ::close(rootDir);
+        for (int fd : cpuFreq) ::close(fd);
+    }
+
+    // Average current clock across CPUs, in kHz; 0 if unknown.
+    long long cpuKhz() const {
+        long long total = 0;
+        int count = 0;
+        char buf[32];
+        for (int fd : cpuFreq) {
+            ssize_t n = preadAll(fd, buf, sizeof(buf) - 1);
+            if (n <= 0) continue;
+            buf[n] = '\0';
+            total += std::strtoll(buf, nullptr, 10);
+            ++count;
+        }
+        return count ? total / count : 0;
+    }
+
+    bool memory(long long &totalKb, long long &availableKb) const {
+        if (meminfo < 0) return false;
+        char buf[4096];  // MemTotal and MemAvailable are in the first few lines
+        ssize_t n = preadAll(meminfo, buf, sizeof(buf));
+        if (n <= 0) return false;
+        const std::string_view text(buf, size_t(n));
+        totalKb = meminfoField(text, "MemTotal");
+        availableKb = meminfoField(text, "MemAvailable");
+        return totalKb > 0 && availableKb >= 0;
+    }
+
+    bool disk(unsigned long long &available) const {
+        if (rootDir < 0) return false;
+        struct statvfs st;
+        if (::fstatvfs(rootDir, &st) != 0) return false;
+        available = (unsigned long long)st.f_bavail * st.f_frsize;
+        return true;
+    }
+};
+
+LiveMonitor::LiveMonitor(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_text(ProbeEngine::ProbeCount)
+    , m_value(ProbeEngine::ProbeCount, -1)
+{
+    m_timer->setSingleShot(true);
+    m_timer->setTimerType(Qt::CoarseTimer);
+    connect(m_timer, &QTimer::timeout, this, &LiveMonitor::tick);
+}
+
+LiveMonitor::~LiveMonitor()
+{
+}
+
+void LiveMonitor::start()
+{
+    if (!m_sampler) m_sampler.reset(new Sampler);
+    m_intervalMs = kMinIntervalMs;
+    tick();
+}
+
+void LiveMonitor::stop()
+{
+    m_timer->stop();
+}
+
+bool LiveMonitor::isActive() const
+{
+    return m_timer->isActive();
+}
+
+QString LiveMonitor::text(ProbeEngine::Probe probe) const
+{
+    return m_text.at(probe);
+}
+
+bool LiveMonitor::changedTo(ProbeEngine::Probe probe, long long value)
+{
+    if (m_value[probe] == value) return false;
+    m_value[probe] = value;
+    return true;
+}
+
+void LiveMonitor::update(ProbeEngine::Probe probe, const QString &text)
+{
+    m_text[probe] = text;
+    emit valueChanged(probe, text);
+}
+
+void LiveMonitor::tick()
+{
+    bool changed = false;
+
+    const long long khz = m_sampler->cpuKhz();
+    if (khz > 0 && changedTo(ProbeEngine::Processor, tenths(double(khz), 1e6))) {
+        update(ProbeEngine::Processor, "Running at " + formatTenths(m_value[ProbeEngine::Processor], " GHz"));
+        changed = true;
+    }
+
+    long long totalKb = 0, availableKb = 0;
+    // Same binary GB as the memory row itself.
+    if (m_sampler->memory(totalKb, availableKb)
+        && changedTo(ProbeEngine::Memory, tenths((totalKb - availableKb) * 1024.0, 1024.0 * 1024.0 * 1024.0))) {
+        update(ProbeEngine::Memory, formatTenths(m_value[ProbeEngine::Memory], " GB in use"));
+        changed = true;
+    }
+
+    unsigned long long available = 0;
+    // and decimal GB, like the disk row
+    if (m_sampler->disk(available) && changedTo(ProbeEngine::StartupDisk, tenths(double(available), 1e9))) {
+        update(ProbeEngine::StartupDisk, formatTenths(m_value[ProbeEngine::StartupDisk], " GB available"));
+        changed = true;
+    }
+
+    // Back off while nothing moves; snap back as soon as something does.
+    m_intervalMs = changed ? kMinIntervalMs : qMin(m_intervalMs * 2, kMaxIntervalMs);
+    m_timer->start(m_intervalMs);
+}
@@ -0,0 +1,66 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef LIVEMONITOR_H
+#define LIVEMONITOR_H
+
+#include "probeengine.h"
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <memory>
+
+class QTimer;
+
+// Keeps an eye on the few values that move while the card is open: current
+// CPU clock, memory in use and free space on the startup disk.
+//
+// The files are opened once and re-read with pread() each tick, so a tick is
+// a handful of syscalls with no forks. The clock is read from a few CPUs
+// spread across the machine, not all of them. Values are compared in the
+// units they're shown in (0.1 GHz, 0.1 GB) and text is only built for one
+// that changed, so a quiet tick allocates nothing. /proc and sysfs don't
+// deliver inotify events for these, so it polls instead: every second while
+// things are changing, backing off to every few seconds while they aren't.
+class LiveMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LiveMonitor(QObject *parent = nullptr);
+    ~LiveMonitor();
+
+    // start() samples straight away, then keeps going until stop().
+    void start();
+    void stop();
+    bool isActive() const;
+
+    // Last text sent for a row, empty if there isn't one (or never will be,
+    // e.g. no cpufreq on this machine). Rows: Processor, Memory, StartupDisk.
+    QString text(ProbeEngine::Probe probe) const;
+
+    static constexpr int kMinIntervalMs = 1000;
+    static constexpr int kMaxIntervalMs = 4000;
+    // scaling_cur_freq can cost an IPI to the CPU read on older x86 kernels
+    static constexpr int kMaxSampledCpus = 8;
+
+signals:
+    void valueChanged(ProbeEngine::Probe probe, const QString &text);
+
+private:
+    struct Sampler;
+
+    void tick();
+    bool changedTo(ProbeEngine::Probe probe, long long value);
+    void update(ProbeEngine::Probe probe, const QString &text);
+
+    std::unique_ptr<Sampler> m_sampler;
+    QTimer *m_timer;
+    QVector<QString> m_text;
+    QVector<long long> m_value;     // what m_text shows, in tenths; -1 for none yet
+    int m_intervalMs = kMinIntervalMs;
+};
+
+#endif // LIVEMONITOR_H
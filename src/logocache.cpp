@@ -0,0 +1,140 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "logocache.h"
+#include "snapshotcache.h"
+#include "trace.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QFont>
+#include <QPainter>
+#include <QSaveFile>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const quint32 kMagic = 0x4154534C; // "ATSL"
+const quint16 kFormatVersion = 1;
+
+}
+
+LogoCache::LogoCache(const QString &sourcePath, int logicalSize, qreal devicePixelRatio)
+    : m_source(sourcePath)
+    , m_logicalSize(logicalSize)
+    , m_dpr(devicePixelRatio > 0 ? devicePixelRatio : 1.0)
+{
+    // The one stat of the source per launch: it keys the cache and tells
+    // build() whether there's a logo at all.
+    QFileInfo info(m_source);
+    if (info.exists()) {
+        m_sourceMtime = info.lastModified().toMSecsSinceEpoch();
+        m_sourceSize = info.size();
+    }
+
+    // e.g. ~/.cache/AboutThisSyn/logo-96@2.raw
+    const QString dir = QFileInfo(SnapshotCache().fileName()).absolutePath();
+    m_path = QString("%1/logo-%2@%3.raw").arg(dir).arg(m_logicalSize).arg(m_dpr);
+}
+
+bool LogoCache::load(Logo &logo) const
+{
+    ATS_TRACE_SPAN("LogoCache::load", "ui");
+    QFile f(m_path);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&f);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    QString source;
+    qint64 mtime = 0, size = 0;
+    bool fallback = false;
+    qint32 width = 0, height = 0;
+    QByteArray pixels;
+    in >> magic >> version;
+    if (magic != kMagic || version != kFormatVersion) return false;
+    in >> source >> mtime >> size >> fallback >> width >> height >> pixels;
+    if (in.status() != QDataStream::Ok) return false;
+    if (source != m_source || mtime != m_sourceMtime || size != m_sourceSize) return false;
+    if (width <= 0 || height <= 0 || pixels.size() != width * height * 4) return false;
+
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < height; ++y) {
+        std::memcpy(image.scanLine(y), pixels.constData() + y * width * 4, size_t(width) * 4);
+    }
+    image.setDevicePixelRatio(m_dpr);
+
+    logo.image = image;
+    logo.fallback = fallback;
+    return true;
+}
+
+LogoCache::Logo LogoCache::build() const
+{
+    ATS_TRACE_SPAN("LogoCache::build", "ui");
+    const int px = int(std::lround(m_logicalSize * m_dpr));
+
+    Logo logo;
+    if (m_sourceSize > 0) {
+        QImage source(m_source);
+        if (!source.isNull()) {
+            if (source.width() > px || source.height() > px) {
+                source = source.scaled(px, px, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+            }
+            logo.image = source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        }
+    }
+
+    if (logo.image.isNull()) {
+        // Fallback
+        logo.fallback = true;
+        logo.image = QImage(px, px, QImage::Format_ARGB32_Premultiplied);
+        logo.image.fill(Qt::transparent);
+        QPainter p(&logo.image);
+        p.setRenderHint(QPainter::Antialiasing);
+
+        QFont f;
+        f.setPixelSize(int(std::lround(72 * m_dpr)));
+        f.setBold(true);
+        p.setFont(f);
+        p.setPen(QColor(180, 180, 180));
+        p.drawText(logo.image.rect(), Qt::AlignCenter, "?");
+    }
+
+    logo.image.setDevicePixelRatio(m_dpr);
+    save(logo);
+    return logo;
+}
+
+bool LogoCache::save(const Logo &logo) const
+{
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+
+    QSaveFile f(m_path);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+
+    const QImage &image = logo.image;
+    QByteArray pixels;
+    pixels.reserve(image.width() * image.height() * 4);
+    for (int y = 0; y < image.height(); ++y) {
+        pixels.append(reinterpret_cast<const char *>(image.constScanLine(y)), image.width() * 4);
+    }
+
+    QDataStream out(&f);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << kMagic << kFormatVersion << m_source << m_sourceMtime << m_sourceSize << logo.fallback
+        << qint32(image.width()) << qint32(image.height()) << pixels;
+
+    if (out.status() != QDataStream::Ok) {
+        f.cancelWriting();
+        return false;
+    }
+    return f.commit();
+}
@@ -0,0 +1,48 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef LOGOCACHE_H
+#define LOGOCACHE_H
+
+#include <QImage>
+#include <QString>
+
+// The card's logo, already scaled to its on-screen size at a given device
+// pixel ratio. Stored raw (premultiplied ARGB32) next to the snapshot cache
+// so a warm start just reads ~150 KB and never decodes or scales anything;
+// the entry is rebuilt when the source PNG's size or mtime changes.
+//
+// build() decodes the PNG (or draws the fallback glyph when there isn't one)
+// using QImage only, so it's safe to run off the GUI thread.
+class LogoCache
+{
+public:
+    struct Logo {
+        QImage image;           // physical pixels, devicePixelRatio set
+        bool fallback = false;  // the "?" glyph rather than the real logo
+    };
+
+    LogoCache(const QString &sourcePath, int logicalSize, qreal devicePixelRatio);
+
+    QString fileName() const { return m_path; }
+
+    // Reads the pre-scaled logo if the cached copy is current.
+    bool load(Logo &logo) const;
+
+    // Decodes, scales and writes the cache. Returns the logo either way.
+    Logo build() const;
+
+private:
+    bool save(const Logo &logo) const;
+
+    QString m_source;
+    int m_logicalSize;
+    qreal m_dpr;
+    QString m_path;
+    qint64 m_sourceMtime = 0;   // both 0 if the source doesn't exist
+    qint64 m_sourceSize = 0;
+};
+
+#endif // LOGOCACHE_H
@@ -8,14 +8,36 @@
  * version 2 of the License, or (at your option) any later version.
  */
 
+#include "cli.h"
 #include "mainwindow.h"
+#include "singleinstance.h"
+#include "trace.h"
 #include <QApplication>
 #include <QIcon>
 #include <QDebug>
+#include <cstring>
 
 int main(int argc, char *argv[])
 {
+    // ABOUTTHISSYN_TRACE=file.json or --trace=file.json
+    Trace::enableFromEnvironment(argc, argv);
+
+    // --json / --field: print the inventory and exit before any GUI exists.
+    if (Cli::isHeadless(argc, argv)) {
+        int rc = Cli::run(argc, argv);
+        Trace::flush();
+        return rc;
+    }
+
+    // Already open (or fading out)? Let that instance raise its window and
+    // reuse its results. A trace wants a cold launch, so never hand it over.
+    if (!Trace::isEnabled() && SingleInstance::forwardToRunning(argc, argv)) {
+        return 0;
+    }
+
+    ATS_TRACE_BEGIN(appSpan, "QApplication", "ui");
     QApplication app(argc, argv);
+    ATS_TRACE_END(appSpan);
     
     // Icon (hwinfo)
     app.setWindowIcon(QIcon::fromTheme("hwinfo"));
@@ -29,8 +51,25 @@ int main(int argc, char *argv[])
     // We rely on platform theme, or QStyleFactory if needed.
     // Since we are "CoreServices", looking native is key.
 
+    // Listen before the window exists so near-simultaneous launches still
+    // find us; requests are only handled once the event loop runs.
+    SingleInstance instance;
+    instance.listen();
+
+    ATS_TRACE_BEGIN(windowSpan, "MainWindow", "ui");
     MainWindow win;
+    MainWindow::Measurements measure;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--live") == 0) win.setLiveUpdates(true);
+        if (std::strcmp(argv[i], "--measure") == 0) measure |= MainWindow::MeasureMemory;
+        if (std::strcmp(argv[i], "--disk-bench") == 0) measure |= MainWindow::MeasureDisk;
+    }
+    win.setMeasurements(measure);
     win.show();
+    ATS_TRACE_END(windowSpan);
+    QObject::connect(&instance, &SingleInstance::activationRequested, &win, &MainWindow::activate);
 
-    return app.exec();
+    int rc = app.exec();
+    Trace::flush();
+    return rc;
 }
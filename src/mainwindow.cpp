@@ -4,14 +4,19 @@
  */
 
 #include "mainwindow.h"
+#include "detailspane.h"
+#include "embosslabel.h"
 #include "hardware.h"
+#include "livemonitor.h"
+#include "probeengine.h"
+#include "trace.h"
+#include "ueventmonitor.h"
 #include <QVBoxLayout>
 #include <QFile>
 #include <QHBoxLayout>
 #include <QGridLayout>
 #include <QLabel>
 #include <QPushButton>
-#include <QProcess>
 #include <QPixmap>
 #include <QApplication>
 #include <QPainter>
@@ -24,9 +29,13 @@
 #include <QLinearGradient>
 #include <QPropertyAnimation>
 #include <QCloseEvent>
+#include <QFutureWatcher>
+#include <QtConcurrent>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
+    , m_probes(new ProbeEngine(this))
+    , m_uevents(new UEventMonitor(this))
 {
     // Window Frame Constraints
     // Fixed size, strictly locked. 
@@ -38,6 +47,17 @@ MainWindow::MainWindow(QWidget *parent)
     setMaximumSize(320, 480);
     
     setupUi();
+
+    // Probes run in the background; the card paints with placeholders first.
+    connect(m_probes, &ProbeEngine::probeFinished, this, &MainWindow::applyProbeResult);
+    m_probes->start();
+
+    // Hotplug re-probes just the row it affects, for as long as we're open.
+    // ABOUTTHISSYN_UEVENT_REPLAY feeds a recorded stream in instead.
+    connect(m_uevents, &UEventMonitor::probeInvalidated, m_probes, &ProbeEngine::invalidate);
+    const QString replay = QString::fromLocal8Bit(qgetenv("ABOUTTHISSYN_UEVENT_REPLAY"));
+    if (!replay.isEmpty()) m_uevents->openReplay(replay);
+    else if (Hardware::sysRoot().isEmpty()) m_uevents->open();
 }
 
 MainWindow::~MainWindow()
@@ -46,6 +66,7 @@ MainWindow::~MainWindow()
 
 void MainWindow::setupUi()
 {
+    ATS_TRACE_SPAN("MainWindow::setupUi", "ui");
     QWidget *NSECentralWidget = new QWidget(this);
     setCentralWidget(NSECentralWidget);
 
@@ -56,42 +77,30 @@ void MainWindow::setupUi()
     NSEMainLayout->setSpacing(10);
     
     // 1. Logo and Header Block
+    ATS_TRACE_BEGIN(headerSpan, "setupUi: logo and header", "ui");
     
-    // Logo
+    // Logo: pre-scaled for this screen and cached on disk, so a warm start
+    // never decodes or scales the PNG. On a miss it's built on a worker
+    // thread and the card paints without it for a frame or two.
     NSELogoLabel = new QLabel(this);
     NSELogoLabel->setAlignment(Qt::AlignCenter);
-    QString logoPath = "/usr/share/synos/icons/syn-chrome.png";
-    QPixmap logoPix(logoPath);
-    
-    if (logoPix.isNull()) {
-        // Fallback
-        logoPix = QPixmap(96, 96); // Slightly smaller for 320px width
-        logoPix.fill(Qt::transparent);
-        QPainter p(&logoPix);
-        p.setRenderHint(QPainter::Antialiasing);
-        
-        QFont f = QApplication::font();
-        f.setPixelSize(72);
-        f.setBold(true);
-        p.setFont(f);
-        p.setPen(QColor(180, 180, 180));
-        p.drawText(logoPix.rect(), Qt::AlignCenter, "?");
+    NSELogoLabel->setMinimumHeight(kLogoSize); // don't jump when it arrives
+    LogoCache logoCache("/usr/share/synos/icons/syn-chrome.png", kLogoSize, devicePixelRatioF());
+    LogoCache::Logo logo;
+    if (qgetenv("ABOUTTHISSYN_NO_CACHE").isEmpty() && logoCache.load(logo)) {
+        setLogo(logo);
     } else {
-        if (logoPix.width() > 96) logoPix = logoPix.scaled(96, 96, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-    }
-    
-    NSELogoLabel->setPixmap(logoPix);
-    if (!QFile::exists(logoPath)) {
-        QGraphicsDropShadowEffect *eff = new QGraphicsDropShadowEffect(this);
-        eff->setBlurRadius(10);
-        eff->setOffset(0, 2);
-        eff->setColor(QColor(0, 0, 0, 50));
-        NSELogoLabel->setGraphicsEffect(eff);
+        QFutureWatcher<LogoCache::Logo> *watcher = new QFutureWatcher<LogoCache::Logo>(this);
+        connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+            setLogo(watcher->result());
+            watcher->deleteLater();
+        });
+        watcher->setFuture(QtConcurrent::run([logoCache]() { return logoCache.build(); }));
     }
     NSEMainLayout->addWidget(NSELogoLabel);
     
     // Title: "SynOS"
-    NSETitleLabel = new QLabel("SynOS", this);
+    NSETitleLabel = new EmbossLabel("SynOS", this);
     NSETitleLabel->setAlignment(Qt::AlignCenter);
     QFont titleFont = QApplication::font();
     titleFont.setPixelSize(24);
@@ -102,12 +111,8 @@ void MainWindow::setupUi()
     NSETitleLabel->setPalette(pal);
     NSEMainLayout->addWidget(NSETitleLabel);
     
-    // Version
-    QString ver = Hardware::getOSVersion();
-    // Wrap version if super long, but usually it fits.
-    // "Version X.Y"
-    QString shortVer = ver.split(' ').first(); 
-    NSEVersionLabel = new QLabel(QString("Version %1").arg(shortVer), this);
+    // Version (filled in by applyProbeResult once os-release has been read)
+    NSEVersionLabel = new EmbossLabel(QString("Version %1").arg(placeholderText()), this);
     NSEVersionLabel->setAlignment(Qt::AlignCenter);
     QFont verFont = QApplication::font();
     verFont.setBold(true);
@@ -116,9 +121,12 @@ void MainWindow::setupUi()
     NSEVersionLabel->setPalette(pal);
     NSEMainLayout->addWidget(NSEVersionLabel);
     
+    ATS_TRACE_END(headerSpan);
+    
     NSEMainLayout->addSpacing(15);
     
     // 2. Hardware Specs Grid
+    ATS_TRACE_BEGIN(specsSpan, "setupUi: specs grid", "ui");
     QGridLayout *NSESpecsLayout = new QGridLayout();
     NSESpecsLayout->setHorizontalSpacing(10);
     NSESpecsLayout->setVerticalSpacing(12); // slightly more breathing room for wrapped lines
@@ -127,8 +135,8 @@ void MainWindow::setupUi()
     
     int row = 0;
     
-    auto addSpec = [&](const QString &label, const QString &value) {
-        QLabel *NSELabel = new QLabel(label, this);
+    auto addSpec = [&](const QString &label, const QString &value) -> QLabel * {
+        QLabel *NSELabel = new EmbossLabel(label, this);
         QFont f = QApplication::font();
         f.setBold(true);
         NSELabel->setFont(f);
@@ -136,25 +144,29 @@ void MainWindow::setupUi()
         NSELabel->setAlignment(Qt::AlignRight | Qt::AlignTop);
         // Prevent label from taking too much space? Natural size is usually fine.
         
-        QLabel *NSEValue = new QLabel(value, this);
+        QLabel *NSEValue = new EmbossLabel(value, this);
         NSEValue->setAlignment(Qt::AlignLeft | Qt::AlignTop);
         NSEValue->setWordWrap(true); // Crucial for long CPU names
         
         NSESpecsLayout->addWidget(NSELabel, row, 0);
         NSESpecsLayout->addWidget(NSEValue, row, 1);
         row++;
+        return NSEValue;
     };
     
-    addSpec("Processor", Hardware::getProcessorInfo());
-    addSpec("Memory", Hardware::getMemoryInfo());
-    addSpec("Graphics", Hardware::getGraphicsInfo());
-    addSpec("Startup Disk", Hardware::getStartupDiskInfo());
+    // Placeholder rows; each one is replaced as soon as its probe finishes.
+    NSEProcValue = addSpec("Processor", placeholderText());
+    NSEMemValue = addSpec("Memory", placeholderText());
+    NSEGfxValue = addSpec("Graphics", placeholderText());
+    NSEDiskValue = addSpec("Startup Disk", placeholderText());
     
     NSEMainLayout->addLayout(NSESpecsLayout);
+    ATS_TRACE_END(specsSpan);
     
     NSEMainLayout->addSpacing(15);
     
     // 3. More Info Button
+    ATS_TRACE_BEGIN(footerSpan, "setupUi: button and footer", "ui");
     NSEMoreInfoButton = new QPushButton("More Info...", this);
     NSEMoreInfoButton->setFixedWidth(120);
     connect(NSEMoreInfoButton, &QPushButton::clicked, this, &MainWindow::openMoreInfo);
@@ -168,7 +180,7 @@ void MainWindow::setupUi()
     NSEMainLayout->addStretch(); 
     
     // 4. Footer
-    NSECopyrightLabel = new QLabel("™ and © 2025 Syndromatic Ltd. All rights reserved.", this);
+    NSECopyrightLabel = new EmbossLabel("™ and © 2025 Syndromatic Ltd. All rights reserved.", this);
     NSECopyrightLabel->setAlignment(Qt::AlignCenter);
     QFont footerFont = QApplication::font();
     footerFont.setPixelSize(10); 
@@ -176,7 +188,7 @@ void MainWindow::setupUi()
     pal.setColor(QPalette::WindowText, QColor(100, 100, 100));
     NSECopyrightLabel->setPalette(pal);
     
-    NSEDesignedLabel = new QLabel("Designed by Syndromatic in Manchester", this);
+    NSEDesignedLabel = new EmbossLabel("Designed by Syndromatic in Manchester", this);
     NSEDesignedLabel->setAlignment(Qt::AlignCenter);
     NSEDesignedLabel->setFont(footerFont);
     NSEDesignedLabel->setPalette(pal);
@@ -184,38 +196,181 @@ void MainWindow::setupUi()
     NSEMainLayout->addWidget(NSECopyrightLabel);
     NSEMainLayout->addWidget(NSEDesignedLabel);
     
-    // Helper to add 'embossed' text effect (light grey shadow)
-    auto addEmboss = [this](QLabel *lbl) {
+    ATS_TRACE_END(footerSpan);
+
+    // Every text label above is an EmbossLabel, which draws the light grey
+    // 1px highlight itself; no graphics effects needed.
+}
+
+void MainWindow::setLogo(const LogoCache::Logo &logo)
+{
+    NSELogoLabel->setPixmap(QPixmap::fromImage(logo.image));
+    if (logo.fallback) {
         QGraphicsDropShadowEffect *eff = new QGraphicsDropShadowEffect(this);
-        eff->setBlurRadius(0); // Sharp shadow
-        eff->setOffset(0, 1);
-        eff->setColor(QColor(225, 225, 225)); // Light grey shadow
-        lbl->setGraphicsEffect(eff);
-    };
-    
-    // Apply effect to all text labels
-    addEmboss(NSETitleLabel);
-    addEmboss(NSEVersionLabel);
-    addEmboss(NSECopyrightLabel);
-    addEmboss(NSEDesignedLabel);
-    
-    // Note: The specs created inside the lambda above need the effect too.
-    // Since we created them in a loop before defining this helper, we can't easily retro-apply without iterating children.
-    // However, we can just iterate the Specs Layout items.
-    
-    for (int i = 0; i < NSESpecsLayout->count(); ++i) {
-        QWidget *w = NSESpecsLayout->itemAt(i)->widget();
-        if (QLabel *lbl = qobject_cast<QLabel*>(w)) {
-            addEmboss(lbl);
+        eff->setBlurRadius(10);
+        eff->setOffset(0, 2);
+        eff->setColor(QColor(0, 0, 0, 50));
+        NSELogoLabel->setGraphicsEffect(eff);
+    }
+}
+
+QString MainWindow::placeholderText()
+{
+    return QStringLiteral("\u2026");
+}
+
+void MainWindow::applyProbeResult(ProbeEngine::Probe probe, const QString &value)
+{
+    if (probe == ProbeEngine::OSVersion) {
+        // Wrap version if super long, but usually it fits.
+        // "Version X.Y"
+        QString shortVer = value.split(' ').first();
+        NSEVersionLabel->setText(QString("Version %1").arg(shortVer));
+        return;
+    }
+    Q_UNUSED(value);
+    updateRow(probe);
+}
+
+void MainWindow::applyLiveValue(ProbeEngine::Probe probe, const QString &value)
+{
+    Q_UNUSED(value);
+    updateRow(probe);
+}
+
+QLabel *MainWindow::valueLabel(ProbeEngine::Probe probe) const
+{
+    switch (probe) {
+    case ProbeEngine::Processor:   return NSEProcValue;
+    case ProbeEngine::Memory:      return NSEMemValue;
+    case ProbeEngine::Graphics:    return NSEGfxValue;
+    case ProbeEngine::StartupDisk: return NSEDiskValue;
+    default:                       return nullptr;
+    }
+}
+
+void MainWindow::updateRow(ProbeEngine::Probe probe)
+{
+    QLabel *label = valueLabel(probe);
+    if (!label) return;
+
+    QString text = m_probes->isFinished(probe) ? m_probes->result(probe) : placeholderText();
+    if (m_live && !m_live->text(probe).isEmpty()) text += '\n' + m_live->text(probe);
+    const QString measured = m_measured.value(probe);
+    if (!measured.isEmpty()) text += '\n' + measured;
+
+    // Skip the relayout and repaint when a tick didn't change what we show.
+    if (label->text() != text) label->setText(text);
+}
+
+void MainWindow::setLiveUpdates(bool enabled)
+{
+    if (enabled == liveUpdates()) return;
+
+    if (enabled) {
+        m_live = new LiveMonitor(this);
+        connect(m_live, &LiveMonitor::valueChanged, this, &MainWindow::applyLiveValue);
+        m_live->start();
+    } else {
+        delete m_live;
+        m_live = nullptr;
+        updateRow(ProbeEngine::Processor);
+        updateRow(ProbeEngine::Memory);
+        updateRow(ProbeEngine::StartupDisk);
+    }
+}
+
+void MainWindow::setMeasurements(Measurements measurements)
+{
+    if (measurements == m_measure) return;
+    m_measure = measurements;
+
+    // Whatever is in flight stops; startMeasurement() picks up what's left.
+    if (m_measureCancel) *m_measureCancel = true;
+    m_measureCancel.reset();
+    if (!(measurements & MeasureMemory) && m_measured.remove(ProbeEngine::Memory)) {
+        updateRow(ProbeEngine::Memory);
+    }
+    if (!(measurements & MeasureDisk) && m_measured.remove(ProbeEngine::StartupDisk)) {
+        updateRow(ProbeEngine::StartupDisk);
+    }
+    if (!measurements) return;
+
+    // Never while the card is still filling in: memory saturates every core
+    // and the disk run would compete with the probes' own reads.
+    if (m_probes->isAllFinished()) startMeasurement();
+    else connect(m_probes, &ProbeEngine::allFinished, this, &MainWindow::startMeasurement,
+                 Qt::UniqueConnection);
+}
+
+void MainWindow::startMeasurement()
+{
+    disconnect(m_probes, &ProbeEngine::allFinished, this, &MainWindow::startMeasurement);
+    if (m_measureCancel) return;    // one at a time; the next starts when it's done
+
+    ProbeEngine::Probe probe;
+    if ((m_measure & MeasureMemory) && !m_measured.contains(ProbeEngine::Memory)) probe = ProbeEngine::Memory;
+    else if ((m_measure & MeasureDisk) && !m_measured.contains(ProbeEngine::StartupDisk)) probe = ProbeEngine::StartupDisk;
+    else return;
+
+    m_measureCancel = std::make_shared<std::atomic<bool>>(false);
+    Hardware::ProbeLimits limits;
+    limits.cancelled = m_measureCancel;
+
+    QFutureWatcher<QString> *watcher = new QFutureWatcher<QString>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, probe, cancel = m_measureCancel]() {
+        watcher->deleteLater();
+        if (*cancel) return;
+        m_measureCancel.reset();
+        m_measured.insert(probe, watcher->result());
+        updateRow(probe);
+        startMeasurement();
+    });
+    watcher->setFuture(QtConcurrent::run([limits, probe]() {
+        Hardware::setProbeLimits(limits);
+        const QString line = probe == ProbeEngine::Memory
+                                 ? Hardware::formatMeasuredMemory(Hardware::measureMemory())
+                                 : Hardware::formatDiskBenchmark(Hardware::benchmarkStartupDisk());
+        Hardware::clearProbeLimits();
+        return line;
+    }));
+}
+
+void MainWindow::activate()
+{
+    if (m_fade) {
+        // stop() deletes it (DeleteWhenStopped) without emitting finished,
+        // so the quit never happens.
+        m_fade->stop();
+        setWindowOpacity(1.0);
+        m_probes->resume();
+        if (m_live) m_live->start();
+        // a measurement the close cut short starts over once the rows are in
+        if (m_measureCancel && *m_measureCancel) {
+            m_measureCancel.reset();
+            if (m_probes->isAllFinished()) startMeasurement();
+            else connect(m_probes, &ProbeEngine::allFinished, this, &MainWindow::startMeasurement,
+                         Qt::UniqueConnection);
         }
     }
+
+    if (isMinimized()) showNormal();
+    else show();
+    raise();
+    activateWindow();
 }
 
 void MainWindow::openMoreInfo()
 {
-    QProcess::startDetached("kinfocenter", QStringList());
-    // Close the app when "More Info" is launched, triggering the fade out.
-    close();
+    // Built on first use; nothing in it is probed until a section is opened.
+    if (!m_details) {
+        ATS_TRACE_SPAN("MainWindow::openMoreInfo: build pane", "ui");
+        m_details = new DetailsPane(m_probes, this);
+        m_details->move(frameGeometry().topRight() + QPoint(12, 0));
+    }
+    m_details->show();
+    m_details->raise();
+    m_details->activateWindow();
 }
 
 void MainWindow::closeEvent(QCloseEvent *event)
@@ -224,8 +379,17 @@ void MainWindow::closeEvent(QCloseEvent *event)
     if (windowOpacity() > 0.0) {
         // Prevent recursive generic close events or instant closing
         event->ignore();
+        if (m_fade) return; // already on its way out
+
+        // Nothing still probing should hold up the exit: kill any tools
+        // and stop listening for results.
+        m_probes->cancel();
+        if (m_live) m_live->stop();
+        if (m_measureCancel) *m_measureCancel = true;
+        if (m_details) m_details->hide();
         
         QPropertyAnimation *anim = new QPropertyAnimation(this, "windowOpacity");
+        m_fade = anim;
         anim->setDuration(300); // 300ms smooth fade
         anim->setStartValue(1.0);
         anim->setEndValue(0.0);
@@ -7,9 +7,19 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QMap>
+#include <QPointer>
+#include "logocache.h"
+#include "probeengine.h"
+#include <atomic>
+#include <memory>
 
+class DetailsPane;
+class LiveMonitor;
 class QLabel;
+class QPropertyAnimation;
 class QPushButton;
+class UEventMonitor;
 
 class MainWindow : public QMainWindow
 {
@@ -19,14 +29,55 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    ProbeEngine *probeEngine() const { return m_probes; }
+
+    // Live mode (--live): keeps CPU clock, memory in use and free disk space
+    // current under their rows while the window is open.
+    void setLiveUpdates(bool enabled);
+    bool liveUpdates() const { return m_live != nullptr; }
+
+    // --measure / --disk-bench: once every row is in, measures memory
+    // bandwidth and latency and/or startup disk throughput on a worker, one
+    // after the other, and adds a "Measured" line under that row. Cancelled
+    // on close.
+    enum Measurement {
+        MeasureMemory = 0x1,
+        MeasureDisk   = 0x2,
+    };
+    Q_DECLARE_FLAGS(Measurements, Measurement)
+    void setMeasurements(Measurements measurements);
+
+public slots:
+    // Another launch wants a window: bring this one forward, and if it was
+    // fading out, keep it open and finish any rows the close cut short.
+    void activate();
+
 private slots:
     void openMoreInfo();
+    void applyProbeResult(ProbeEngine::Probe probe, const QString &value);
+    void applyLiveValue(ProbeEngine::Probe probe, const QString &value);
 
 protected:
     void closeEvent(QCloseEvent *event) override;
 
 private:
     void setupUi();
+    void setLogo(const LogoCache::Logo &logo);
+    static QString placeholderText();
+    QLabel *valueLabel(ProbeEngine::Probe probe) const;
+    void updateRow(ProbeEngine::Probe probe);
+    void startMeasurement();
+
+    static const int kLogoSize = 96; // Slightly smaller for 320px width
+
+    ProbeEngine *m_probes;
+    QPointer<QPropertyAnimation> m_fade;
+    LiveMonitor *m_live = nullptr;
+    UEventMonitor *m_uevents;
+    DetailsPane *m_details = nullptr;
+    Measurements m_measure;
+    std::shared_ptr<std::atomic<bool>> m_measureCancel;   // set while one runs
+    QMap<ProbeEngine::Probe, QString> m_measured;           // finished ones, even if empty
     
     // UI Elements
     QLabel *NSELogoLabel;
@@ -51,4 +102,6 @@ private:
     QLabel *NSEDesignedLabel;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(MainWindow::Measurements)
+
 #endif // MAINWINDOW_H
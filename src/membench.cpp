@@ -0,0 +1,450 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "hardware_p.h"
+#include "sysfs.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <system_error>
+#include <thread>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ATS_HAVE_X86_SIMD 1
+#endif
+
+namespace Hardware {
+namespace Native {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Arrays are a multiple of this many doubles, so every kernel can run
+// without a tail loop, and 64-byte aligned for the widest stores.
+const size_t kChunk = 64;
+const uint64_t kMinArrayBytes = 4ull << 20;
+// Floors: both grow to a multiple of the machine's total LLC.
+const uint64_t kMaxWorkingSet = 1ull << 30;
+const uint64_t kDramChaseBytes = 256ull << 20;
+const size_t kLine = 64;
+
+using CopyFn = void (*)(double *a, const double *b, size_t n);
+using TriadFn = void (*)(double *a, const double *b, const double *c, double s, size_t n);
+
+void copyScalar(double *a, const double *b, size_t n) {
+    for (size_t i = 0; i < n; ++i) a[i] = b[i];
+}
+
+void triadScalar(double *a, const double *b, const double *c, double s, size_t n) {
+    for (size_t i = 0; i < n; ++i) a[i] = b[i] + s * c[i];
+}
+
+#ifdef ATS_HAVE_X86_SIMD
+
+// Streaming stores skip the read-for-ownership of a, so the traffic is what
+// STREAM counts and the number reflects DRAM rather than the LLC.
+
+__attribute__((target("sse2")))
+void copySse2(double *a, const double *b, size_t n) {
+    for (size_t i = 0; i < n; i += 2) _mm_stream_pd(a + i, _mm_load_pd(b + i));
+    _mm_sfence();
+}
+
+__attribute__((target("sse2")))
+void triadSse2(double *a, const double *b, const double *c, double s, size_t n) {
+    const __m128d vs = _mm_set1_pd(s);
+    for (size_t i = 0; i < n; i += 2) {
+        _mm_stream_pd(a + i, _mm_add_pd(_mm_load_pd(b + i), _mm_mul_pd(vs, _mm_load_pd(c + i))));
+    }
+    _mm_sfence();
+}
+
+__attribute__((target("avx2,fma")))
+void copyAvx2(double *a, const double *b, size_t n) {
+    for (size_t i = 0; i < n; i += 4) _mm256_stream_pd(a + i, _mm256_load_pd(b + i));
+    _mm_sfence();
+}
+
+__attribute__((target("avx2,fma")))
+void triadAvx2(double *a, const double *b, const double *c, double s, size_t n) {
+    const __m256d vs = _mm256_set1_pd(s);
+    for (size_t i = 0; i < n; i += 4) {
+        _mm256_stream_pd(a + i, _mm256_fmadd_pd(vs, _mm256_load_pd(c + i), _mm256_load_pd(b + i)));
+    }
+    _mm_sfence();
+}
+
+__attribute__((target("avx512f")))
+void copyAvx512(double *a, const double *b, size_t n) {
+    for (size_t i = 0; i < n; i += 8) _mm512_stream_pd(a + i, _mm512_load_pd(b + i));
+    _mm_sfence();
+}
+
+__attribute__((target("avx512f")))
+void triadAvx512(double *a, const double *b, const double *c, double s, size_t n) {
+    const __m512d vs = _mm512_set1_pd(s);
+    for (size_t i = 0; i < n; i += 8) {
+        _mm512_stream_pd(a + i, _mm512_fmadd_pd(vs, _mm512_load_pd(c + i), _mm512_load_pd(b + i)));
+    }
+    _mm_sfence();
+}
+
+#endif
+
+struct Kernels {
+    const char *name = "scalar";
+    CopyFn copy = copyScalar;
+    TriadFn triad = triadScalar;
+};
+
+// Widest kernel the CPU has and the kernel has enabled state for.
+Kernels pickKernels(uint32_t features) {
+    Kernels k;
+#ifdef ATS_HAVE_X86_SIMD
+    if (features & IsaAvx512F) {
+        k = { "avx512", copyAvx512, triadAvx512 };
+    } else if ((features & IsaAvx2) && (features & IsaFma)) {
+        k = { "avx2", copyAvx2, triadAvx2 };
+    } else if (features & IsaSse2) {
+        k = { "sse2", copySse2, triadSse2 };
+    }
+#else
+    (void)features;
+#endif
+    return k;
+}
+
+// Everyone waits here until the last thread arrives; spinning, since the
+// threads are pinned one per CPU and a futex wake would blur the start.
+class SpinBarrier
+{
+public:
+    explicit SpinBarrier(int count) : m_count(count) {}
+
+    void wait() {
+        if (m_released.load(std::memory_order_acquire)) return;
+        const int generation = m_generation.load(std::memory_order_acquire);
+        if (m_waiting.fetch_add(1, std::memory_order_acq_rel) + 1 == m_count) {
+            m_waiting.store(0, std::memory_order_relaxed);
+            m_generation.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        while (m_generation.load(std::memory_order_acquire) == generation
+               && !m_released.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Lets everyone through from now on, for when fewer than count threads
+    // could be started and the rest would otherwise wait forever.
+    void release() { m_released.store(true, std::memory_order_release); }
+
+private:
+    const int m_count;
+    std::atomic<bool> m_released{false};
+    std::atomic<int> m_waiting{0};
+    std::atomic<int> m_generation{0};
+};
+
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+void pinTo(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+double *allocDoubles(size_t n) {
+    return static_cast<double *>(std::aligned_alloc(64, n * sizeof(double)));
+}
+
+bool isCancelled(const std::atomic<bool> *cancelled) {
+    return cancelled && cancelled->load(std::memory_order_relaxed);
+}
+
+// Shared between the bandwidth workers. Each rep, every thread times its own
+// pass; the rep's aggregate rate is all the bytes over the slowest thread.
+struct BandwidthRun {
+    Kernels kernels;
+    size_t elements = 0;
+    int reps = 0;
+    std::vector<double> copySeconds;    // [rep * threads + thread]
+    std::vector<double> triadSeconds;
+    std::atomic<int> completedReps{0};
+    std::atomic<bool> stop{false};
+    Clock::time_point deadline;
+};
+
+void bandwidthWorker(BandwidthRun &run, SpinBarrier &barrier, int index, int threads, int cpu,
+                     const std::atomic<bool> *cancelled) {
+    pinTo(cpu);
+
+    // First touch from the pinned thread puts the pages on its NUMA node.
+    double *a = allocDoubles(run.elements);
+    double *b = allocDoubles(run.elements);
+    double *c = allocDoubles(run.elements);
+    const bool ok = a && b && c;
+    if (!ok) run.stop = true;
+    // in slices, since faulting a gigabyte in takes a while to cancel
+    for (size_t i = 0; ok && i < run.elements && !run.stop; ) {
+        const size_t end = std::min(run.elements, i + (size_t(1) << 20));
+        for (; i < end; ++i) {
+            a[i] = 0.0;
+            b[i] = 1.0;
+            c[i] = 2.0;
+        }
+        if (isCancelled(cancelled)) run.stop = true;
+    }
+
+    for (int rep = 0; rep < run.reps; ++rep) {
+        barrier.wait();
+        // One thread decides for everyone, so nobody is left at a barrier.
+        // The first two always run (rep 0 only warms up) however long faulting
+        // the arrays in took.
+        if (index == 0 && (isCancelled(cancelled) || (rep >= 2 && Clock::now() > run.deadline))) run.stop = true;
+        barrier.wait();
+        if (run.stop) break;
+
+        Clock::time_point t0 = Clock::now();
+        run.kernels.copy(a, b, run.elements);
+        Clock::time_point t1 = Clock::now();
+        run.copySeconds[size_t(rep * threads + index)] = std::chrono::duration<double>(t1 - t0).count();
+
+        barrier.wait();
+        t0 = Clock::now();
+        run.kernels.triad(a, b, c, 3.0, run.elements);
+        t1 = Clock::now();
+        run.triadSeconds[size_t(rep * threads + index)] = std::chrono::duration<double>(t1 - t0).count();
+
+        if (index == 0) run.completedReps = rep + 1;
+    }
+
+    std::free(a);
+    std::free(b);
+    std::free(c);
+}
+
+// Every LLC instance on the machine, not just cpu0's: a CCX's 32 MB is one
+// of 24 on a 2-socket Genoa. Instances are online CPUs over sharedBy,
+// rounded up since cpuid's sharedBy is an upper bound.
+uint64_t totalLastLevelCacheBytes(const IsaFacts &isa) {
+    const CacheLevel *llc = nullptr;
+    for (const CacheLevel &c : isa.caches) {
+        if (!llc || c.sizeKb > llc->sizeKb) llc = &c;
+    }
+    if (!llc) return 0;
+    const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    const uint64_t shared = uint64_t(std::max(llc->sharedBy, 1));
+    const uint64_t instances = cpus > 0 ? (uint64_t(cpus) + shared - 1) / shared : 1;
+    return uint64_t(llc->sizeKb) * 1024 * instances;
+}
+
+// Never more than kMaxWorkingSet (or four times the LLC, if that's more),
+// nor a quarter of what's free right now.
+uint64_t capWorkingSet(uint64_t bytes, uint64_t llcBytes) {
+    const long pages = sysconf(_SC_AVPHYS_PAGES);
+    const long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages > 0 && pageSize > 0) bytes = std::min<uint64_t>(bytes, uint64_t(pages) * uint64_t(pageSize) / 4);
+    return std::min(bytes, std::max(kMaxWorkingSet, 4 * llcBytes));
+}
+
+void measureBandwidth(MemoryBench &bench, const Kernels &kernels, const std::vector<int> &cpus,
+                      uint64_t llcBytes, Clock::time_point deadline, const std::atomic<bool> *cancelled) {
+    const int threads = int(cpus.size());
+
+    // Three arrays between them several times the LLC, so the caches can't
+    // hold a pass. If free memory won't stretch that far the rate is partly
+    // cache, and says so.
+    const uint64_t workingSet = capWorkingSet(std::max<uint64_t>(4 * llcBytes, uint64_t(threads) * 3 * kMinArrayBytes), llcBytes);
+
+    size_t elements = size_t(workingSet / 3 / uint64_t(threads) / sizeof(double));
+    elements -= elements % kChunk;
+    if (elements == 0) return;
+
+    BandwidthRun run;
+    run.kernels = kernels;
+    run.elements = elements;
+    run.reps = 10;
+    run.copySeconds.assign(size_t(run.reps * threads), 0.0);
+    run.triadSeconds.assign(size_t(run.reps * threads), 0.0);
+    run.deadline = deadline;
+
+    SpinBarrier barrier(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(size_t(threads));
+    try {
+        for (int i = 0; i < threads; ++i) {
+            workers.emplace_back(bandwidthWorker, std::ref(run), std::ref(barrier), i, threads, cpus[size_t(i)], cancelled);
+        }
+    } catch (const std::system_error &) {
+        // Out of threads (pids.max on a big host, say). A rate from fewer
+        // threads than planned isn't the machine's, so stop the ones that
+        // started and report nothing.
+        run.stop = true;
+        barrier.release();
+        for (std::thread &t : workers) t.join();
+        return;
+    }
+    for (std::thread &t : workers) t.join();
+
+    // Rep 0 warms the TLBs and page tables; drop it when there's more.
+    const int reps = run.completedReps;
+    if (reps == 0) return;
+    const double bytes = double(elements) * sizeof(double) * threads;
+    for (int rep = reps > 1 ? 1 : 0; rep < reps; ++rep) {
+        double copy = 0.0, triad = 0.0;
+        for (int i = 0; i < threads; ++i) {
+            copy = std::max(copy, run.copySeconds[size_t(rep * threads + i)]);
+            triad = std::max(triad, run.triadSeconds[size_t(rep * threads + i)]);
+        }
+        if (copy > 0.0) bench.copyGBs = std::max(bench.copyGBs, 2 * bytes / copy / 1e9);
+        if (triad > 0.0) bench.triadGBs = std::max(bench.triadGBs, 3 * bytes / triad / 1e9);
+    }
+
+    bench.kernel = kernels.name;
+    bench.threads = threads;
+    bench.bytesPerThread = uint64_t(elements) * sizeof(double) * 3;
+    if (workingSet < 4 * llcBytes) bench.cacheBound = true;
+}
+
+// Average time per load of a pointer chase through a random cyclic
+// permutation of cache lines: each load depends on the one before, so
+// nothing overlaps and the prefetchers have no pattern to follow.
+double chaseNs(uint64_t bytes, Clock::duration slice, const std::atomic<bool> *cancelled) {
+    const size_t lines = std::max<size_t>(size_t(bytes / kLine), 2);
+    const size_t length = lines * kLine;
+    void *mem = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) return 0.0;
+    // Huge pages where available, so DRAM numbers aren't mostly page walks.
+    madvise(mem, length, MADV_HUGEPAGE);
+
+    char *base = static_cast<char *>(mem);
+    std::vector<uint32_t> order(lines);
+    for (size_t i = 0; i < lines; ++i) order[i] = uint32_t(i);
+    // Sattolo: a single cycle through every line. xorshift and a multiply
+    // instead of mt19937 and a divide; it's millions of lines for DRAM.
+    uint64_t x = 0x9e3779b97f4a7c15ull;
+    for (size_t i = lines - 1; i > 0; --i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        std::swap(order[i], order[size_t(((x >> 32) * uint64_t(i)) >> 32)]);
+    }
+    for (size_t i = 0; i < lines; ++i) {
+        *reinterpret_cast<void **>(base + size_t(order[i]) * kLine) = base + size_t(order[(i + 1) % lines]) * kLine;
+    }
+
+    void *p = base;
+    for (size_t i = 0; i < lines; ++i) p = *static_cast<void **>(p);    // warm up
+
+    const size_t batch = 1 << 16;
+    size_t steps = 0;
+    // timed from here: building a big permutation can take longer than the chase
+    const Clock::time_point t0 = Clock::now();
+    const Clock::time_point until = t0 + slice;
+    Clock::time_point now = t0;
+    do {
+        for (size_t i = 0; i < batch; ++i) p = *static_cast<void **>(p);
+        steps += batch;
+        now = Clock::now();
+    } while (now < until && steps < (size_t(64) << 20) && !isCancelled(cancelled));
+
+    // keep the chase from being optimised away
+    void *volatile sink = p;
+    (void)sink;
+    munmap(mem, length);
+    return std::chrono::duration<double, std::nano>(now - t0).count() / double(steps);
+}
+
+void measureLatency(MemoryBench &bench, const IsaFacts &isa, uint64_t llcBytes, int cpu, Clock::time_point deadline,
+                    const std::atomic<bool> *cancelled) {
+    std::vector<MemoryLatency> points;
+    for (const CacheLevel &c : isa.caches) {
+        if (c.type == 'I' || c.sizeKb == 0) continue;
+        MemoryLatency point;
+        point.level = c.level;
+        point.bytes = uint64_t(c.sizeKb) * 1024 / 2;
+        points.push_back(point);
+    }
+    if (points.empty()) {
+        // no cache sizes to go by: a few typical ones, unlabelled
+        for (uint64_t kb : { 16, 256, 4096 }) {
+            MemoryLatency point;
+            point.level = -1;
+            point.bytes = kb * 1024;
+            points.push_back(point);
+        }
+    }
+    MemoryLatency dram;
+    dram.bytes = capWorkingSet(std::max(kDramChaseBytes, 2 * llcBytes), llcBytes);
+    if (dram.bytes < 2 * llcBytes) bench.cacheBound = true;
+    points.push_back(dram);
+
+    // The chase runs on its own pinned thread so it doesn't share a core
+    // with whatever this thread was doing.
+    try {
+        std::thread worker([&]() {
+            pinTo(cpu);
+            const Clock::duration slice = std::max<Clock::duration>(deadline - Clock::now(), std::chrono::milliseconds(100))
+                                          / int(points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                if (isCancelled(cancelled)) break;
+                points[i].ns = chaseNs(points[i].bytes, slice, cancelled);
+                if (points[i].ns > 0.0) bench.latency.push_back(points[i]);
+            }
+        });
+        worker.join();
+    } catch (const std::system_error &) {
+        // no thread to pin: no latency line
+    }
+}
+
+}
+
+bool measureMemory(MemoryBench &bench, const MemoryBenchOptions &options, const std::atomic<bool> *cancelled) {
+    bench = MemoryBench();
+    // Timing this machine says nothing about a captured one.
+    if (!SysFs::root().empty()) return false;
+
+    IsaFacts isa;
+    probeIsa(isa);
+
+    std::vector<int> cpus = allowedCpus();
+    if (cpus.empty()) cpus.push_back(0);
+    if (options.threads > 0 && size_t(options.threads) < cpus.size()) cpus.resize(size_t(options.threads));
+
+    // Bandwidth gets the larger share: it has more setup (page faults).
+    const Clock::time_point start = Clock::now();
+    const auto budget = std::chrono::milliseconds(std::max(100, options.budgetMs));
+    const uint64_t llcBytes = totalLastLevelCacheBytes(isa);
+    measureBandwidth(bench, pickKernels(isa.features), cpus, llcBytes, start + budget * 6 / 10, cancelled);
+    if (isCancelled(cancelled)) return bench.threads > 0;
+
+    // The rest of the budget, but never less than its share: faulting in a
+    // big working set can eat well into the bandwidth half.
+    measureLatency(bench, isa, llcBytes, cpus.front(), std::max(start + budget, Clock::now() + budget * 4 / 10), cancelled);
+    return bench.threads > 0 || !bench.latency.empty();
+}
+
+}
+}
@@ -0,0 +1,193 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "hardware_p.h"
+#include "sysfs.h"
+#include "textscan.h"
+#include <cstdlib>
+#include <cstring>
+
+namespace Hardware {
+namespace Native {
+
+namespace {
+
+const char *const kDmiTable = "/sys/firmware/dmi/tables/DMI";
+
+// SMBIOS structure types we care about (DSP0134).
+enum : uint8_t {
+    kTypePhysicalMemoryArray = 16,
+    kTypeMemoryDevice = 17,
+    kTypeEndOfTable = 127
+};
+
+// Type 16 "Use" field.
+const uint8_t kArrayUseSystemMemory = 0x03;
+
+uint16_t word(const unsigned char *p) { return uint16_t(p[0] | (p[1] << 8)); }
+uint32_t dword(const unsigned char *p) { return uint32_t(word(p)) | (uint32_t(word(p + 2)) << 16); }
+
+// Type 17 "Memory Type" byte. Anything not listed is reported as unknown.
+const char *memoryTypeName(uint8_t t) {
+    switch (t) {
+    case 0x0F: return "SDRAM";
+    case 0x12: return "DDR";
+    case 0x13: return "DDR2";
+    case 0x14: return "DDR2 FB-DIMM";
+    case 0x18: return "DDR3";
+    case 0x1A: return "DDR4";
+    case 0x1B: return "LPDDR";
+    case 0x1C: return "LPDDR2";
+    case 0x1D: return "LPDDR3";
+    case 0x1E: return "LPDDR4";
+    case 0x20: return "HBM";
+    case 0x21: return "HBM2";
+    case 0x22: return "DDR5";
+    case 0x23: return "LPDDR5";
+    case 0x24: return "HBM3";
+    default:   return "";
+    }
+}
+
+// Strings are numbered from 1 and live after the formatted area, each one
+// NUL-terminated, with the set ending in a double NUL.
+std::string dmiString(const unsigned char *strings, const unsigned char *end, uint8_t index) {
+    if (index == 0) return std::string();
+    const unsigned char *p = strings;
+    for (uint8_t i = 1; p < end && *p; ++i) {
+        const unsigned char *s = p;
+        while (p < end && *p) ++p;
+        if (i == index) {
+            std::string v(reinterpret_cast<const char *>(s), size_t(p - s));
+            while (!v.empty() && v.back() == ' ') v.pop_back();
+            return v;
+        }
+        ++p;
+    }
+    return std::string();
+}
+
+uint64_t moduleSize(const unsigned char *rec, uint8_t len) {
+    if (len < 0x0E) return 0;
+    uint16_t size = word(rec + 0x0C);
+    if (size == 0 || size == 0xFFFF) return 0;   // empty slot / unknown
+    if (size == 0x7FFF && len >= 0x20) {
+        // Extended Size, in MB, bits 0..30
+        return uint64_t(dword(rec + 0x1C) & 0x7FFFFFFFu) << 20;
+    }
+    if (size & 0x8000) return uint64_t(size & 0x7FFF) << 10; // KB granularity
+    return uint64_t(size) << 20;
+}
+
+int speedField(const unsigned char *rec, uint8_t len, uint8_t off, uint8_t extOff) {
+    if (len < off + 2) return 0;
+    uint16_t v = word(rec + off);
+    if (v == 0xFFFF && len >= extOff + 4) return int(dword(rec + extOff) & 0x7FFFFFFFu);
+    if (v == 0xFFFF) return 0;
+    return v;
+}
+
+bool readMemTotal(uint64_t &bytes) {
+    std::string text;
+    if (!SysFs::readFile("/proc/meminfo", text, 4096)) return false;
+
+    // "MemTotal:       16318412 kB" is always the first line.
+    Text::LineReader lines(text);
+    std::string_view line, value;
+    long long kb = 0;
+    while (lines.next(line)) {
+        if (Text::valueFor(line, "MemTotal", ':', value)) break;
+    }
+    if (!Text::toLong(value, kb) || kb <= 0) return false;
+    bytes = uint64_t(kb) << 10;
+    return true;
+}
+
+}
+
+bool decodeSmbiosMemory(const unsigned char *data, size_t length, MemoryFacts &facts) {
+    facts = MemoryFacts();
+
+    // First pass: find the handles of arrays that hold system memory, so
+    // cache and flash "memory devices" don't get added to the total.
+    std::vector<uint16_t> systemArrays;
+    bool sawArray = false;
+
+    auto walk = [&](auto &&visit) {
+        size_t off = 0;
+        while (off + 4 <= length) {
+            const unsigned char *rec = data + off;
+            const uint8_t type = rec[0];
+            const uint8_t len = rec[1];
+            if (len < 4 || off + len > length) break;
+
+            // Skip the string set: scan for the double NUL.
+            size_t next = off + len;
+            while (next + 1 < length && (data[next] || data[next + 1])) ++next;
+            const unsigned char *strings = data + off + len;
+            const unsigned char *stringsEnd = data + next;
+            next += 2;
+
+            if (type == kTypeEndOfTable) break;
+            visit(type, rec, len, strings, stringsEnd);
+            off = next;
+        }
+    };
+
+    walk([&](uint8_t type, const unsigned char *rec, uint8_t len, const unsigned char *, const unsigned char *) {
+        if (type != kTypePhysicalMemoryArray || len < 0x07) return;
+        sawArray = true;
+        if (rec[0x05] == kArrayUseSystemMemory) systemArrays.push_back(word(rec + 0x02));
+    });
+
+    walk([&](uint8_t type, const unsigned char *rec, uint8_t len, const unsigned char *strings, const unsigned char *stringsEnd) {
+        if (type != kTypeMemoryDevice || len < 0x15) return;
+
+        // Some firmware skips Type 16 entirely; take every device then.
+        if (sawArray) {
+            const uint16_t array = word(rec + 0x04);
+            bool system = false;
+            for (uint16_t h : systemArrays) system |= (h == array);
+            if (!system) return;
+        }
+
+        MemoryModule m;
+        m.sizeBytes = moduleSize(rec, len);
+        if (m.sizeBytes == 0) return;
+
+        m.type = memoryTypeName(rec[0x12]);
+        m.speedMts = speedField(rec, len, 0x15, 0x54);
+        m.configuredMts = speedField(rec, len, 0x20, 0x58);
+        m.locator = dmiString(strings, stringsEnd, rec[0x10]);
+        m.bankLocator = dmiString(strings, stringsEnd, rec[0x11]);
+        if (len > 0x17) m.manufacturer = dmiString(strings, stringsEnd, rec[0x17]);
+        if (len > 0x1A) m.partNumber = dmiString(strings, stringsEnd, rec[0x1A]);
+
+        facts.totalBytes += m.sizeBytes;
+        facts.modules.push_back(std::move(m));
+    });
+
+    if (facts.modules.empty()) return false;
+    facts.source = MemoryFacts::Smbios;
+    return true;
+}
+
+bool probeMemory(MemoryFacts &facts) {
+    std::string table;
+    if (SysFs::readFile(kDmiTable, table, 1 << 20) && !table.empty()) {
+        if (decodeSmbiosMemory(reinterpret_cast<const unsigned char *>(table.data()), table.size(), facts))
+            return true;
+    }
+
+    // No root (or no SMBIOS at all, e.g. most VMs on ARM): MemTotal at least
+    // gets the size right to the nearest GB.
+    facts = MemoryFacts();
+    if (!readMemTotal(facts.totalBytes)) return false;
+    facts.source = MemoryFacts::MemInfo;
+    return true;
+}
+
+}
+}
@@ -0,0 +1,393 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "hardware_p.h"
+#include "textscan.h"
+
+// Display-name cleanup for CPU model names and PCI vendor/device names. The
+// rules are data: sorted constexpr tables, checked and indexed by first byte
+// at compile time, so a lookup is a handful of compares and a name is
+// normalised in one pass into a stack buffer. To teach it a new name, add a
+// row (keep them sorted, lower case compares equal to upper) and run
+// parsebench, which checks bench/fixtures/names.tsv and the larger
+// hand-checked bench/fixtures/names-corpus.tsv.
+
+namespace Hardware {
+namespace Native {
+
+namespace {
+
+constexpr char lower(char c) {
+    return c >= 'A' && c <= 'Z' ? char(c - 'A' + 'a') : c;
+}
+
+// ASCII case-insensitive ordering, which is what the tables are sorted by.
+constexpr int compareFolded(std::string_view a, std::string_view b) {
+    const size_t n = a.size() < b.size() ? a.size() : b.size();
+    for (size_t i = 0; i < n; ++i) {
+        const char x = lower(a[i]), y = lower(b[i]);
+        if (x != y) return (unsigned char)x < (unsigned char)y ? -1 : 1;
+    }
+    return a.size() == b.size() ? 0 : a.size() < b.size() ? -1 : 1;
+}
+
+constexpr bool startsWithFolded(std::string_view s, size_t at, std::string_view prefix) {
+    return s.size() - at >= prefix.size() && compareFolded(s.substr(at, prefix.size()), prefix) == 0;
+}
+
+bool isWordChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-';
+}
+
+enum class Action : uint8_t {
+    Drop,        // remove wherever it appears: "(R)"
+    DropWord,    // remove when it's a whole word: "CPU"
+    DropLast,    // remove when it's the last word: "Processor"
+    Cut,         // remove it and everything after: "@ 2.80GHz"
+    Rewrite,     // whole word replaced with `to`: "Core2" -> "Core 2"
+};
+
+struct Rule {
+    std::string_view from;
+    Action action;
+    std::string_view to;
+};
+
+// Model name rules. "N-Core" before a trailing "Processor" is handled in
+// code, since N is any number or number word.
+constexpr Rule kCpuRules[] = {
+    { "(r)", Action::Drop, {} },
+    { "(tm)", Action::Drop, {} },
+    { "@", Action::Cut, {} },
+    { "athlon(tm) 64 processor", Action::Rewrite, "Athlon 64" },
+    { "athlon(tm) 64 x2 dual core processor", Action::Rewrite, "Athlon 64 X2" },
+    { "athlon(tm) dual core processor", Action::Rewrite, "Athlon Dual Core" },
+    { "atom(tm) processor", Action::Rewrite, "Atom" },
+    { "core(tm)2", Action::Rewrite, "Core 2" },
+    { "core2", Action::Rewrite, "Core 2" },
+    { "cpu", Action::DropWord, {} },
+    { "dual-core amd", Action::Rewrite, "AMD" },
+    { "genuine intel", Action::Rewrite, "Intel" },
+    { "nano processor", Action::Rewrite, "Nano" },
+    { "opteron(tm) processor", Action::Rewrite, "Opteron" },
+    { "processor", Action::DropLast, {} },
+    { "quad core processor", Action::DropLast, {} },
+    { "quad-core amd", Action::Rewrite, "AMD" },
+    { "sempron(tm) processor", Action::Rewrite, "Sempron" },
+    { "six-core amd", Action::Rewrite, "AMD" },
+    { "turion(tm) 64 x2 mobile technology", Action::Rewrite, "Turion 64 X2" },
+    { "w/ radeon", Action::Cut, {} },
+    { "with amd radeon", Action::Cut, {} },
+    { "with radeon", Action::Cut, {} },
+    { "\xc2\xae", Action::Drop, {} },      // ®
+    { "\xe2\x84\xa2", Action::Drop, {} },  // ™
+};
+
+// pci.ids and lspci vendor names that the generic suffix stripping below
+// gets wrong or can't shorten.
+struct Alias {
+    std::string_view from;
+    std::string_view to;
+};
+
+constexpr Alias kVendorAliases[] = {
+    { "3Dfx Interactive, Inc.", "3dfx" },
+    { "Advanced Micro Devices, Inc. [AMD/ATI]", "AMD" },
+    { "Advanced Micro Devices, Inc. [AMD]", "AMD" },
+    { "ASPEED Technology, Inc.", "ASPEED" },
+    { "ATI Technologies Inc", "ATI" },
+    { "Broadcom Inc. and subsidiaries", "Broadcom" },
+    { "Huawei Technologies Co., Ltd.", "Huawei" },
+    { "InnoTek Systemberatung GmbH", "VirtualBox" },
+    { "Matrox Electronics Systems Ltd.", "Matrox" },
+    { "Moore Threads Technology Co.,Ltd", "Moore Threads" },
+    { "NVIDIA Corporation", "NVIDIA" },  // and old pci.ids' "nVidia Corporation"
+    { "S3 Graphics Ltd.", "S3" },
+    { "Technical Corp.", "QEMU" },  // 1234, QEMU's standard VGA
+    { "Trident Microsystems", "Trident" },
+    { "XGI Technology Inc. (eXtreme Graphics Innovation)", "XGI" },
+};
+
+// Corporate suffixes, stripped from the end of a vendor name repeatedly:
+// "Foo Technology Co., Ltd." -> "Foo".
+constexpr std::string_view kVendorSuffixes[] = {
+    " Co., Ltd.", " Co.,Ltd", " Co Ltd", ", Inc.", ", Inc", ", Ltd.", " Corp.", " Corporation",
+    " GmbH", " Inc.", " Inc", " Limited", " LLC", " Ltd.", " Technologies", " Technology",
+};
+
+// Device names (after taking the bracketed marketing name) that read badly
+// after the vendor, mostly virtual adapters.
+constexpr Alias kDeviceAliases[] = {
+    { "AMD Custom GPU 0405", "Radeon Van Gogh" },  // Steam Deck
+    { "Hyper-V virtual VGA", "Hyper-V Video" },
+    { "QXL paravirtual graphic card", "QXL" },
+    { "SVGA II Adapter", "SVGA II" },
+    { "Virtio 1.0 GPU", "Virtio GPU" },
+    { "VMware SVGA II Adapter", "SVGA II" },
+};
+
+template <typename T, size_t N>
+constexpr bool sortedByFrom(const T (&table)[N]) {
+    for (size_t i = 1; i < N; ++i) {
+        if (compareFolded(table[i - 1].from, table[i].from) >= 0) return false;
+    }
+    return true;
+}
+
+static_assert(sortedByFrom(kCpuRules), "kCpuRules must be sorted, case-insensitively");
+static_assert(sortedByFrom(kVendorAliases), "kVendorAliases must be sorted, case-insensitively");
+static_assert(sortedByFrom(kDeviceAliases), "kDeviceAliases must be sorted, case-insensitively");
+
+// Rules starting with each (folded) byte are kCpuRules[begin[c], begin[c + 1]).
+struct FirstByteIndex {
+    uint8_t begin[257] = {};
+};
+
+template <size_t N>
+constexpr FirstByteIndex indexRules(const Rule (&rules)[N]) {
+    static_assert(N < 256, "rule index is 8-bit");
+    FirstByteIndex index;
+    size_t r = 0;
+    for (size_t c = 0; c < 256; ++c) {
+        while (r < N && (unsigned char)lower(rules[r].from[0]) < c) ++r;
+        index.begin[c] = uint8_t(r);
+    }
+    index.begin[256] = uint8_t(N);
+    return index;
+}
+
+constexpr FirstByteIndex kCpuIndex = indexRules(kCpuRules);
+
+// Exact case-insensitive match in a sorted alias table.
+template <size_t N>
+std::string_view lookup(const Alias (&table)[N], std::string_view key) {
+    size_t lo = 0, hi = N;
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        const int c = compareFolded(table[mid].from, key);
+        if (c == 0) return table[mid].to;
+        if (c < 0) lo = mid + 1;
+        else hi = mid;
+    }
+    return std::string_view();
+}
+
+// Appends with runs of whitespace collapsed to one space, none leading or
+// trailing. Anything past the buffer is dropped.
+class Appender
+{
+public:
+    explicit Appender(NameBuffer &out) : m_out(out) { m_out.size = 0; }
+    ~Appender() { m_out.data[m_out.size] = '\0'; }
+
+    void space() { m_pendingSpace = m_out.size > 0; }
+    void put(char c) {
+        if (Text::isSpace(c)) {
+            space();
+            return;
+        }
+        if (m_pendingSpace) {
+            m_pendingSpace = false;
+            push(' ');
+        }
+        push(c);
+    }
+    void put(std::string_view s) {
+        for (char c : s) put(c);
+    }
+
+private:
+    void push(char c) {
+        if (m_out.size + 1 < sizeof(m_out.data)) m_out.data[m_out.size++] = c;
+    }
+
+    NameBuffer &m_out;
+    bool m_pendingSpace = false;
+};
+
+size_t wordEnd(std::string_view s, size_t at) {
+    while (at < s.size() && !Text::isSpace(s[at])) ++at;
+    return at;
+}
+
+size_t skipSpace(std::string_view s, size_t at) {
+    while (at < s.size() && Text::isSpace(s[at])) ++at;
+    return at;
+}
+
+// "3.00GHz", "1200MHz", "(1.6GHz": a clock speed without the "@" in front,
+// as old Pentium and VIA model names have it. Treated like a Cut rule.
+bool isClockWord(std::string_view s, size_t at) {
+    if (at < s.size() && s[at] == '(') ++at;
+    const size_t digits = at;
+    while (at < s.size() && ((s[at] >= '0' && s[at] <= '9') || s[at] == '.')) ++at;
+    if (at == digits || s.size() - at < 3) return false;
+    if (!startsWithFolded(s, at, "ghz") && !startsWithFolded(s, at, "mhz")) return false;
+    at += 3;
+    return at == s.size() || !isWordChar(s[at]);
+}
+
+// Whether everything from `at` is whitespace, a parenthetical ("Processor
+// (Skylake, IBRS)" from QEMU) or starts with a Cut rule, i.e. the word
+// before it is the last one that will be printed.
+bool atNameEnd(std::string_view s, size_t at) {
+    at = skipSpace(s, at);
+    if (at == s.size() || isClockWord(s, at)) return true;
+    if (s[at] == '(') return true;
+    const unsigned char c = (unsigned char)lower(s[at]);
+    for (size_t r = kCpuIndex.begin[c]; r < kCpuIndex.begin[c + 1]; ++r) {
+        if (kCpuRules[r].action == Action::Cut && startsWithFolded(s, at, kCpuRules[r].from)) return true;
+    }
+    return false;
+}
+
+// The longest rule matching at `at` whose boundary conditions hold, or null.
+const Rule *matchCpuRule(std::string_view s, size_t at, bool wordStart) {
+    const unsigned char c = (unsigned char)lower(s[at]);
+    const Rule *best = nullptr;
+    for (size_t r = kCpuIndex.begin[c]; r < kCpuIndex.begin[c + 1]; ++r) {
+        const Rule &rule = kCpuRules[r];
+        if (!startsWithFolded(s, at, rule.from)) continue;
+        if (best && best->from.size() >= rule.from.size()) continue;
+
+        const size_t end = at + rule.from.size();
+        const bool wordEnds = end == s.size() || !isWordChar(s[end]);
+        switch (rule.action) {
+        case Action::Drop:
+        case Action::Cut:
+            break;
+        case Action::DropWord:
+        case Action::Rewrite:
+            if (!wordStart || !wordEnds) continue;
+            break;
+        case Action::DropLast:
+            if (!wordStart || !wordEnds || !atNameEnd(s, end)) continue;
+            break;
+        }
+        best = &rule;
+    }
+    return best;
+}
+
+// "8-Core", "Eight-Core", "64-core" directly before a trailing "Processor",
+// or "64-Cores" ending the name: AMD's habit, and the card already says how
+// many cores there are.
+size_t coreCountEnd(std::string_view s, size_t at) {
+    const size_t end = wordEnd(s, at);
+    const bool plural = end - at > 6 && startsWithFolded(s, end - 6, "-cores");
+    if (!plural && (end - at <= 5 || !startsWithFolded(s, end - 5, "-core"))) return 0;
+    if (atNameEnd(s, end)) return end;
+    const size_t next = skipSpace(s, end);
+    const Rule *rule = matchCpuRule(s, next, true);
+    return rule && rule->action == Action::DropLast ? end : 0;
+}
+
+// "Ellesmere [Radeon RX 580]" -> "Radeon RX 580": pci.ids puts the marketing
+// name in a trailing bracket after the chip's codename.
+std::string_view marketingName(std::string_view device) {
+    device = Text::trimmed(device);
+    if (device.size() < 3 || device.back() != ']') return device;
+    const size_t open = device.rfind('[');
+    if (open == std::string_view::npos) return device;
+    const std::string_view inside = Text::trimmed(device.substr(open + 1, device.size() - open - 2));
+    return inside.empty() ? device : inside;
+}
+
+// Whether word appears in s as a whole word (or run of words).
+bool containsWordFolded(std::string_view s, std::string_view word) {
+    if (word.empty() || word.size() > s.size()) return false;
+    for (size_t at = 0; at + word.size() <= s.size(); ++at) {
+        if (at > 0 && isWordChar(s[at - 1])) continue;
+        const size_t end = at + word.size();
+        if (startsWithFolded(s, at, word) && (end == s.size() || !isWordChar(s[end]))) return true;
+    }
+    return false;
+}
+
+}
+
+void normalizeCpuName(std::string_view model, NameBuffer &out) {
+    Appender append(out);
+    model = Text::trimmed(model);
+
+    bool wordStart = true;
+    for (size_t i = 0; i < model.size(); ) {
+        const char c = model[i];
+        if (Text::isSpace(c)) {
+            append.space();
+            wordStart = true;
+            ++i;
+            continue;
+        }
+
+        if (wordStart) {
+            if (isClockWord(model, i)) break;
+            const size_t end = coreCountEnd(model, i);
+            if (end) {
+                i = end;
+                continue;
+            }
+        }
+
+        if (const Rule *rule = matchCpuRule(model, i, wordStart)) {
+            if (rule->action == Action::Cut) break;
+            if (rule->action == Action::Rewrite) append.put(rule->to);
+            i += rule->from.size();
+            // "Core(TM)2": what follows a dropped mark continues the word
+            if (rule->action != Action::Drop) wordStart = false;
+            continue;
+        }
+
+        append.put(c);
+        wordStart = !isWordChar(c);
+        ++i;
+    }
+}
+
+std::string_view shortVendorName(std::string_view vendor) {
+    vendor = Text::trimmed(vendor);
+    const std::string_view alias = lookup(kVendorAliases, vendor);
+    if (!alias.empty()) return alias;
+
+    // "Silicon Integrated Systems [SiS]" -> "SiS", "[AMD/ATI]" -> "AMD"
+    if (vendor.size() > 2 && vendor.back() == ']') {
+        const size_t open = vendor.rfind('[');
+        if (open != std::string_view::npos && open + 2 < vendor.size()) {
+            std::string_view inside = vendor.substr(open + 1, vendor.size() - open - 2);
+            inside = Text::trimmed(inside.substr(0, inside.find('/')));
+            if (!inside.empty()) return inside;
+        }
+    }
+
+    for (bool stripped = true; stripped; ) {
+        stripped = false;
+        for (std::string_view suffix : kVendorSuffixes) {
+            if (vendor.size() > suffix.size() && startsWithFolded(vendor, vendor.size() - suffix.size(), suffix)) {
+                vendor = Text::trimmed(vendor.substr(0, vendor.size() - suffix.size()));
+                stripped = true;
+            }
+        }
+    }
+    return vendor;
+}
+
+void normalizeGpuName(std::string_view vendor, std::string_view device, NameBuffer &out) {
+    Appender append(out);
+    const std::string_view shortVendor = shortVendorName(vendor);
+    std::string_view name = marketingName(device);
+    const std::string_view alias = lookup(kDeviceAliases, name);
+    if (!alias.empty()) name = alias;
+
+    // avoid "Intel Intel ...", "VMware VMware SVGA II" and "Matrox
+    // Integrated Matrox G200eW3 ..."
+    if (!containsWordFolded(name, shortVendor) && !containsWordFolded(name, Text::trimmed(vendor))) {
+        append.put(shortVendor);
+        append.space();
+    }
+    append.put(name);
+}
+
+}
+}
@@ -0,0 +1,249 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "hardware_p.h"
+#include "sysfs.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <fcntl.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Hardware {
+namespace Native {
+
+namespace {
+
+const char *const kPciDevices = "/sys/bus/pci/devices";
+
+const char *const kPciIdsPaths[] = {
+    "/usr/share/hwdata/pci.ids",
+    "/usr/share/misc/pci.ids",
+    "/usr/share/pci.ids",
+};
+
+int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Parses exactly four hex digits followed by whitespace, as used for vendor
+// and device IDs in pci.ids. Returns -1 if p doesn't start like that.
+int parseId(const char *p, const char *end) {
+    if (end - p < 5) return -1;
+    int v = 0;
+    for (int i = 0; i < 4; ++i) {
+        int d = hexDigit(p[i]);
+        if (d < 0) return -1;
+        v = (v << 4) | d;
+    }
+    return (p[4] == ' ' || p[4] == '\t') ? v : -1;
+}
+
+std::string_view nameAfterId(const char *p, const char *end) {
+    // "8086  Intel Corporation\n": skip id and the two-space separator.
+    p += 4;
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    const char *e = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)));
+    if (!e) e = end;
+    return std::string_view(p, size_t(e - p));
+}
+
+// pci.ids, mapped read-only once per distinct file. Rather than parsing the
+// file, one memchr sweep records where each vendor block starts and ends;
+// names are then sliced straight out of the mapping on demand.
+//
+// Sysroots may carry their own copy. Copies are told apart by size and a hash
+// of the header (which carries the database version) rather than by path or
+// mtime, so thousands of captures sharing a handful of pci.ids versions map a
+// handful of files.
+class PciIds
+{
+public:
+    static const PciIds &forCurrentRoot() {
+        static std::mutex lock;
+        static std::map<std::pair<off_t, size_t>, std::unique_ptr<PciIds>> byFile;
+        static PciIds missing;
+
+        int fd = -1;
+        struct stat st;
+        for (const char *path : kPciIdsPaths) {
+            fd = ::open(SysFs::resolve(path).c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) continue;
+            if (::fstat(fd, &st) == 0 && st.st_size > 0 && uint64_t(st.st_size) < UINT32_MAX) break;
+            ::close(fd);
+            fd = -1;
+        }
+        if (fd < 0) return missing;
+
+        char head[4096];
+        const ssize_t n = ::pread(fd, head, sizeof(head), 0);
+        const size_t hash = std::hash<std::string_view>()(std::string_view(head, n > 0 ? size_t(n) : 0));
+
+        std::lock_guard<std::mutex> guard(lock);
+        std::unique_ptr<PciIds> &ids = byFile[std::make_pair(st.st_size, hash)];
+        if (!ids) ids.reset(new PciIds(fd, size_t(st.st_size)));
+        ::close(fd);
+        return *ids;
+    }
+
+    bool isOpen() const { return m_data != nullptr; }
+
+    std::string_view vendorName(uint16_t vendor) const {
+        const Entry *e = find(vendor);
+        if (!e) return std::string_view();
+        return nameAfterId(m_data + e->begin, m_data + e->end);
+    }
+
+    std::string_view deviceName(uint16_t vendor, uint16_t device) const {
+        const Entry *e = find(vendor);
+        if (!e) return std::string_view();
+
+        // Device lines are a single tab deep; subsystems are two tabs deep.
+        const char *p = m_data + e->begin;
+        const char *end = m_data + e->end;
+        while (p < end) {
+            const char *nl = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)));
+            if (!nl) break;
+            p = nl + 1;
+            if (p < end && p[0] == '\t' && p + 1 < end && p[1] != '\t') {
+                if (parseId(p + 1, end) == device) return nameAfterId(p + 1, end);
+            }
+        }
+        return std::string_view();
+    }
+
+private:
+    struct Entry {
+        uint16_t id;
+        uint32_t begin;     // offset of the vendor line
+        uint32_t end;       // offset of the next top-level line
+    };
+
+    PciIds() = default;
+
+    PciIds(int fd, size_t size) {
+        void *map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) return;
+        m_data = static_cast<const char *>(map);
+        m_size = size;
+        buildIndex();
+    }
+
+    // The mapping lives for the rest of the process; nothing to tear down.
+    PciIds(const PciIds &) = delete;
+    PciIds &operator=(const PciIds &) = delete;
+
+    void buildIndex() {
+        const char *p = m_data;
+        const char *end = m_data + m_size;
+        Entry *open = nullptr;
+
+        m_index.reserve(4096);
+        while (p < end) {
+            const char c = *p;
+            if (c != '\t' && c != '#' && c != '\n') {
+                // Any top-level line closes the previous vendor block. The
+                // device class section ("C 03  Display controller") comes last
+                // and has no vendor ID, so it just ends the final block.
+                if (open) {
+                    open->end = uint32_t(p - m_data);
+                    open = nullptr;
+                }
+                int id = parseId(p, end);
+                if (id >= 0) {
+                    m_index.push_back({uint16_t(id), uint32_t(p - m_data), uint32_t(m_size)});
+                    open = &m_index.back();
+                }
+            }
+            const char *nl = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)));
+            if (!nl) break;
+            p = nl + 1;
+        }
+
+        // The upstream file is sorted already, but local edits might not be.
+        std::stable_sort(m_index.begin(), m_index.end(), [](const Entry &a, const Entry &b) {
+            return a.id < b.id;
+        });
+        m_index.shrink_to_fit();
+    }
+
+    const Entry *find(uint16_t vendor) const {
+        auto it = std::lower_bound(m_index.begin(), m_index.end(), vendor, [](const Entry &e, uint16_t v) {
+            return e.id < v;
+        });
+        return (it != m_index.end() && it->id == vendor) ? &*it : nullptr;
+    }
+
+    const char *m_data = nullptr;
+    size_t m_size = 0;
+    std::vector<Entry> m_index;
+};
+
+bool readHex(const std::string &path, unsigned long &value) {
+    std::string text;
+    if (!SysFs::readLine(path, text) || text.empty()) return false;
+    char *end = nullptr;
+    value = std::strtoul(text.c_str(), &end, 16);
+    return end != text.c_str();
+}
+
+}
+
+bool probeGraphics(GraphicsFacts &facts) {
+    facts = GraphicsFacts();
+
+    const std::string base(kPciDevices);
+    if (!SysFs::exists(base)) return false;
+
+    const PciIds &ids = PciIds::forCurrentRoot();
+    if (!ids.isOpen()) return false;
+
+    std::vector<std::string> slots = SysFs::listDir(base);
+    std::sort(slots.begin(), slots.end());
+
+    for (const std::string &slot : slots) {
+        const std::string dir = base + '/' + slot;
+
+        unsigned long cls = 0;
+        if (!readHex(dir + "/class", cls)) continue;
+        if ((cls >> 16) != 0x03) continue;   // display controllers only
+
+        unsigned long vendor = 0, device = 0;
+        if (!readHex(dir + "/vendor", vendor) || !readHex(dir + "/device", device)) continue;
+
+        GraphicsDevice gpu;
+        gpu.slot = slot;
+        gpu.vendorId = uint16_t(vendor);
+        gpu.deviceId = uint16_t(device);
+        gpu.classCode = uint32_t(cls);
+
+        long long bootVga = 0;
+        gpu.bootVga = SysFs::readLong(dir + "/boot_vga", bootVga) && bootVga == 1;
+
+        gpu.vendorName = std::string(ids.vendorName(gpu.vendorId));
+        gpu.deviceName = std::string(ids.deviceName(gpu.vendorId, gpu.deviceId));
+        facts.devices.push_back(std::move(gpu));
+    }
+
+    // Primary (boot) GPU first, everything else in bus order.
+    std::stable_sort(facts.devices.begin(), facts.devices.end(), [](const GraphicsDevice &a, const GraphicsDevice &b) {
+        return a.bootVga && !b.bootVga;
+    });
+    return true;
+}
+
+}
+}
@@ -0,0 +1,350 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "probeengine.h"
+#include "hardware.h"
+#include "snapshotcache.h"
+#include "snapshotpublisher.h"
+#include "trace.h"
+#include <QFutureInterface>
+#include <QFutureWatcher>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtConcurrent>
+
+namespace {
+
+// Default budgets. The native backends answer in well under a millisecond;
+// these only matter when we fall back to a tool or a mount misbehaves.
+const int kDefaultDeadlineMs[ProbeEngine::ProbeCount] = {
+    1000,   // OSVersion
+    3000,   // Processor
+    3000,   // Memory
+    3000,   // Graphics
+    2000,   // StartupDisk
+};
+
+// How long after its deadline a probe gets to hand in partial results
+// (tools have been killed by then) before the row is given up on.
+const int kGraceMs = 250;
+
+}
+
+ProbeEngine::ProbeEngine(QObject *parent)
+    : QObject(parent)
+    , m_pool(new QThreadPool)
+    , m_state(ProbeCount, Idle)
+    , m_results(ProbeCount)
+    , m_partial(ProbeCount, false)
+    , m_rerun(ProbeCount, false)
+    , m_launched(ProbeCount)
+    , m_hasDetails(ProbeCount, false)
+    , m_run(std::make_shared<RunState>())
+{
+    // One thread per probe. The global pool is sized to the core count, which on
+    // a small VM would queue lspci behind lshw and defeat the whole point.
+    m_pool->setMaxThreadCount(ProbeCount);
+
+    m_cacheEnabled = Hardware::sysRoot().isEmpty() && qgetenv("ABOUTTHISSYN_NO_CACHE").isEmpty();
+
+    m_deadlines.reserve(ProbeCount);
+    m_watchers.reserve(ProbeCount);
+    m_timers.reserve(ProbeCount);
+    for (int i = 0; i < ProbeCount; ++i) {
+        const Probe probe = static_cast<Probe>(i);
+        m_deadlines.append(kDefaultDeadlineMs[i]);
+
+        QFutureWatcher<QString> *watcher = new QFutureWatcher<QString>(this);
+        connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, probe]() {
+            if (m_state[probe] != Running || watcher->isCanceled()) return;
+            // the watcher only follows the latest launch, so this is its snapshot
+            if (std::shared_ptr<Hardware::Snapshot> details = std::move(m_launched[probe])) keepDetails(probe, *details);
+            finishProbe(probe, watcher->result(), m_run->truncated[probe].load());
+        });
+        m_watchers.append(watcher);
+
+        QTimer *timer = new QTimer(this);
+        timer->setSingleShot(true);
+        connect(timer, &QTimer::timeout, this, [this, probe]() { expireProbe(probe); });
+        m_timers.append(timer);
+    }
+}
+
+ProbeEngine::~ProbeEngine()
+{
+    cancel();
+
+    // Tools are killed within one wait slice of cancel(). A probe stuck in the
+    // kernel (statfs on a dead NFS mount) can't be interrupted at all, so
+    // rather than block the exit on it, leave the pool behind; process exit
+    // takes the thread with it.
+    if (m_pool->waitForDone(200)) delete m_pool;
+}
+
+void ProbeEngine::start()
+{
+    if (m_pending > 0) return;
+
+    ATS_TRACE_SPAN("ProbeEngine::start", "app");
+    m_run = std::make_shared<RunState>();
+    m_cacheDirty = false;
+
+    // A resident publisher's snapshot is current by construction, so it
+    // beats the cache and covers the OS row too.
+    QMap<int, QString> cached;
+    auto shared = std::make_shared<Hardware::Snapshot>();
+    ATS_TRACE_BEGIN(sharedSpan, "Shared::readSnapshot", "cache");
+    m_usedShared = m_cacheEnabled && loadShared(cached, *shared);
+    ATS_TRACE_END(sharedSpan);
+    m_usedCache = m_usedShared;
+    if (!m_usedShared) {
+        ATS_TRACE_BEGIN(cacheSpan, "SnapshotCache::load", "cache");
+        m_usedCache = m_cacheEnabled && SnapshotCache().load(cached);
+        ATS_TRACE_END(cacheSpan);
+    }
+
+    for (int i = 0; i < ProbeCount; ++i) {
+        const Probe probe = static_cast<Probe>(i);
+        m_results[i].clear();
+        m_partial[i] = false;
+        m_rerun[i] = false;
+        m_hasDetails[i] = false;
+
+        if (m_usedCache && (isCacheable(probe) || m_usedShared) && cached.contains(i)) {
+            // Already-finished future: the watcher still reports it through
+            // the event loop, so callers see one code path either way.
+            QFutureInterface<QString> ready;
+            ready.reportStarted();
+            ready.reportFinished(&cached[i]);
+            m_launched[i] = m_usedShared ? shared : nullptr;
+            m_state[i] = Running;
+            ++m_pending;
+            m_watchers[i]->setFuture(ready.future());
+            continue;
+        }
+
+        launch(probe);
+    }
+}
+
+void ProbeEngine::resume()
+{
+    if (m_pending > 0) return;
+
+    m_run = std::make_shared<RunState>();
+    for (int i = 0; i < ProbeCount; ++i) {
+        if (m_state[i] == Idle) launch(static_cast<Probe>(i));
+    }
+}
+
+void ProbeEngine::invalidate(Probe probe)
+{
+    ATS_TRACE_SPAN_DETAIL("ProbeEngine::invalidate", "app", std::to_string(int(probe)));
+    if (m_run->cancelled) {
+        m_state[probe] = Idle;
+        return;
+    }
+    if (m_state[probe] == Running) {
+        m_rerun[probe] = true;
+        return;
+    }
+    if (m_pending == 0) m_run = std::make_shared<RunState>();
+    m_run->truncated[probe] = false;
+    launch(probe);
+}
+
+void ProbeEngine::launch(Probe probe)
+{
+    m_state[probe] = Running;
+    ++m_pending;
+    // a fresh answer, not one read back from the cache
+    if (isCacheable(probe)) m_cacheDirty = true;
+
+    Hardware::ProbeLimits limits;
+    limits.deadline = QDeadlineTimer(m_deadlines[probe]);
+    limits.cancelled = std::shared_ptr<const std::atomic<bool>>(m_run, &m_run->cancelled);
+
+    // Its own snapshot per launch: a timed-out worker may still be writing
+    // to the last one.
+    auto details = std::make_shared<Hardware::Snapshot>();
+    m_launched[probe] = details;
+    m_hasDetails[probe] = false;
+
+    std::shared_ptr<RunState> run = m_run;
+    m_watchers[probe]->setFuture(QtConcurrent::run(m_pool, [probe, limits, run, details]() {
+        Hardware::setProbeLimits(limits);
+        QString value = runProbe(probe, *details);
+        run->truncated[probe] = Hardware::probeLimitReached();
+        Hardware::clearProbeLimits();
+        return value;
+    }));
+    m_timers[probe]->start(m_deadlines[probe] + kGraceMs);
+}
+
+void ProbeEngine::cancel()
+{
+    m_run->cancelled = true;
+    for (int i = 0; i < ProbeCount; ++i) {
+        m_timers[i]->stop();
+        // back to Idle, so resume() knows which rows never got an answer
+        if (m_state[i] == Running) m_state[i] = Idle;
+    }
+    m_pending = 0;
+}
+
+void ProbeEngine::setDeadline(Probe probe, int msecs)
+{
+    m_deadlines[probe] = qMax(0, msecs);
+}
+
+int ProbeEngine::deadline(Probe probe) const
+{
+    return m_deadlines.at(probe);
+}
+
+void ProbeEngine::finishProbe(Probe probe, const QString &value, bool partial)
+{
+    m_timers[probe]->stop();
+    m_state[probe] = Done;
+    m_results[probe] = value;
+    m_partial[probe] = partial;
+
+    emit probeFinished(probe, value);
+
+    // The answer may predate the hotplug that asked for a rerun.
+    if (m_rerun[probe]) {
+        m_rerun[probe] = false;
+        --m_pending;
+        m_run->truncated[probe] = false;
+        launch(probe);
+        return;
+    }
+
+    if (--m_pending == 0) {
+        if (m_cacheEnabled && m_cacheDirty) saveCache();
+        m_cacheDirty = false;
+        emit allFinished();
+    }
+}
+
+void ProbeEngine::expireProbe(Probe probe)
+{
+    if (m_state[probe] != Running) return;
+    finishProbe(probe, unavailableText(), true);
+}
+
+bool ProbeEngine::isCacheable(Probe probe)
+{
+    // OS version is one small file read, and disk capacity changes under us.
+    switch (probe) {
+    case Processor:
+    case Memory:
+    case Graphics:
+        return true;
+    default:
+        return false;
+    }
+}
+
+QString ProbeEngine::unavailableText()
+{
+    return QStringLiteral("Unavailable");
+}
+
+bool ProbeEngine::loadShared(QMap<int, QString> &values, Hardware::Snapshot &snapshot)
+{
+    if (!Hardware::Shared::readSnapshot(snapshot)) return false;
+    values.insert(OSVersion, Hardware::formatOSVersion(snapshot.os));
+    values.insert(Processor, Hardware::formatProcessor(snapshot.processor));
+    values.insert(Memory, Hardware::formatMemory(snapshot.memory));
+    values.insert(Graphics, Hardware::formatGraphics(snapshot.graphics));
+    return true;
+}
+
+void ProbeEngine::saveCache()
+{
+    ATS_TRACE_SPAN("SnapshotCache::save", "cache");
+    QMap<int, QString> values;
+    for (int i = 0; i < ProbeCount; ++i) {
+        const Probe probe = static_cast<Probe>(i);
+        if (!isCacheable(probe)) continue;
+        // don't persist a partial snapshot
+        if (m_partial[i] || m_results[i].isEmpty()) return;
+        values.insert(i, m_results[i]);
+    }
+    SnapshotCache().save(values);
+}
+
+QFuture<QString> ProbeEngine::future(Probe probe) const
+{
+    return m_watchers.at(probe)->future();
+}
+
+bool ProbeEngine::isFinished(Probe probe) const
+{
+    return m_state.at(probe) == Done;
+}
+
+bool ProbeEngine::isAllFinished() const
+{
+    for (State state : m_state) {
+        if (state != Done) return false;
+    }
+    return true;
+}
+
+QString ProbeEngine::result(Probe probe) const
+{
+    return m_results.at(probe);
+}
+
+bool ProbeEngine::isPartial(Probe probe) const
+{
+    return m_partial.at(probe);
+}
+
+const Hardware::Snapshot *ProbeEngine::details(Probe probe) const
+{
+    return m_state.at(probe) == Done && m_hasDetails.at(probe) ? &m_details : nullptr;
+}
+
+void ProbeEngine::keepDetails(Probe probe, Hardware::Snapshot &from)
+{
+    switch (probe) {
+    case OSVersion:   m_details.os = from.os; break;
+    case Processor:   m_details.processor = from.processor; break;
+    case Memory:      m_details.memory = from.memory; break;
+    case Graphics:    m_details.graphics = from.graphics; break;
+    case StartupDisk: m_details.startupDisk = from.startupDisk; break;
+    case ProbeCount:  return;
+    }
+    m_hasDetails[probe] = true;
+}
+
+// The structured result goes in details, for the details pane; the row
+// gets the one-line summary of it.
+QString ProbeEngine::runProbe(Probe probe, Hardware::Snapshot &details)
+{
+    switch (probe) {
+    case OSVersion:
+        details.os = Hardware::probeOS();
+        return Hardware::formatOSVersion(details.os);
+    case Processor:
+        details.processor = Hardware::probeProcessor();
+        return Hardware::formatProcessor(details.processor);
+    case Memory:
+        details.memory = Hardware::probeMemory();
+        return Hardware::formatMemory(details.memory);
+    case Graphics:
+        details.graphics = Hardware::probeGraphics();
+        return Hardware::formatGraphics(details.graphics);
+    case StartupDisk:
+        details.startupDisk = Hardware::probeStartupDisk();
+        return Hardware::formatStartupDisk(details.startupDisk);
+    case ProbeCount:
+        break;
+    }
+    return QString();
+}
@@ -0,0 +1,148 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef PROBEENGINE_H
+#define PROBEENGINE_H
+
+#include "hardware.h"
+#include <QObject>
+#include <QFuture>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+class QThreadPool;
+class QTimer;
+template <typename T> class QFutureWatcher;
+
+// Runs every Hardware::get* probe at the same time on a private worker pool.
+// Results come back as futures, and as signals delivered on the thread that
+// owns the engine (normally the GUI thread), so the window can paint straight
+// away and fill each row in as its probe lands.
+//
+// Every probe has a deadline. External tools still running when it passes
+// are killed and whatever they printed so far is used; a probe that still
+// hasn't returned shortly after (a hung statfs, say) is reported as
+// unavailableText() and its eventual result is dropped.
+class ProbeEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Probe {
+        OSVersion,
+        Processor,
+        Memory,
+        Graphics,
+        StartupDisk,
+        ProbeCount
+    };
+    Q_ENUM(Probe)
+
+    explicit ProbeEngine(QObject *parent = nullptr);
+    ~ProbeEngine();
+
+    // Kicks off all probes. Calling it again while probes are running is a no-op.
+    // If a resident publisher (--publish) is running, every row it carries
+    // comes from its shared segment. Otherwise static probes (processor,
+    // memory, graphics) are answered from the snapshot cache when it's valid.
+    // The startup disk always runs.
+    void start();
+
+    // Stops everything in flight: child processes are killed, pending rows get
+    // no further signals, and nothing is written to the cache. Instant.
+    void cancel();
+
+    // Re-runs only the probes a cancel() cut short; finished rows keep their
+    // results. Used when a closing window is asked to stay open after all.
+    void resume();
+
+    // Re-runs one probe whose answer may be stale (hardware was hotplugged),
+    // leaving the others alone. The row gets a fresh probeFinished() and the
+    // snapshot cache is rewritten once it lands. If the probe is running, it
+    // runs again afterwards; after a cancel(), resume() picks it up.
+    void invalidate(Probe probe);
+
+    // Per-probe time budget in milliseconds, applied from the next start().
+    void setDeadline(Probe probe, int msecs);
+    int deadline(Probe probe) const;
+
+    // True if the last start() was served (partly) from the snapshot cache
+    // or the shared segment; usedSharedSnapshot() says which.
+    bool usedCache() const { return m_usedCache; }
+    bool usedSharedSnapshot() const { return m_usedShared; }
+
+    // On by default for the live machine. Off under a sysroot, or when
+    // ABOUTTHISSYN_NO_CACHE is set (benchmarks want cold probes).
+    void setCacheEnabled(bool enabled) { m_cacheEnabled = enabled; }
+    bool isCacheEnabled() const { return m_cacheEnabled; }
+
+    // Whether a probe's result is stable for the lifetime of a boot.
+    static bool isCacheable(Probe probe);
+
+    // What a row shows when its probe ran out of time.
+    static QString unavailableText();
+
+    QFuture<QString> future(Probe probe) const;
+    bool isFinished(Probe probe) const;
+    bool isAllFinished() const;
+
+    // Empty until the probe has finished; unavailableText() if it timed out.
+    QString result(Probe probe) const;
+
+    // True if the probe finished but had to cut a tool short, or timed out.
+    bool isPartial(Probe probe) const;
+
+    // The structured answer behind a finished row, for views that show more
+    // than its one line: the field of the snapshot that matches the probe.
+    // Null while it runs, after a timeout, and for rows read back from the
+    // snapshot cache, which only keeps the text.
+    const Hardware::Snapshot *details(Probe probe) const;
+
+signals:
+    void probeFinished(ProbeEngine::Probe probe, const QString &value);
+    void allFinished();
+
+private:
+    enum State { Idle, Running, Done };
+
+    // Shared with the worker threads, which may outlive a cancelled engine.
+    struct RunState {
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> truncated[ProbeCount];
+        RunState() { for (auto &t : truncated) t = false; }
+    };
+
+    static QString runProbe(Probe probe, Hardware::Snapshot &details);
+    void keepDetails(Probe probe, Hardware::Snapshot &from);
+    void launch(Probe probe);
+    void finishProbe(Probe probe, const QString &value, bool partial);
+    void expireProbe(Probe probe);
+    void saveCache();
+    static bool loadShared(QMap<int, QString> &values, Hardware::Snapshot &snapshot);
+
+    QThreadPool *m_pool;
+    QVector<QFutureWatcher<QString> *> m_watchers;
+    QVector<QTimer *> m_timers;
+    QVector<State> m_state;
+    QVector<QString> m_results;
+    QVector<bool> m_partial;
+    QVector<bool> m_rerun;
+    QVector<int> m_deadlines;
+    // What each running probe fills in; the shared snapshot for rows it served.
+    QVector<std::shared_ptr<Hardware::Snapshot>> m_launched;
+    Hardware::Snapshot m_details;
+    QVector<bool> m_hasDetails;
+    std::shared_ptr<RunState> m_run;
+    int m_pending = 0;
+    bool m_usedCache = false;
+    bool m_usedShared = false;
+    bool m_cacheDirty = false;
+    bool m_cacheEnabled = true;
+};
+
+#endif // PROBEENGINE_H
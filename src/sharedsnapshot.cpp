@@ -0,0 +1,255 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "sharedsnapshot.h"
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Hardware {
+namespace Shared {
+
+namespace {
+
+constexpr size_t kHeaderSize = (sizeof(SegmentHeader) + 63) & ~size_t(63);
+
+// A write is one memcpy of a few KB, so a reader that keeps finding it odd
+// is looking at a publisher that died or closed, not a slow one.
+constexpr int kReadAttempts = 256;
+
+bool fail(std::string *error, const std::string &message) {
+    if (error) *error = message;
+    return false;
+}
+
+// Anyone can create a name in /dev/shm, so only trust a segment root or we
+// made, and that nobody else can write to.
+const char *untrusted(const struct stat &st) {
+    if (st.st_uid != 0 && st.st_uid != ::geteuid()) return "owned by another user";
+    if (st.st_mode & (S_IWGRP | S_IWOTH)) return "writable by other users";
+    return nullptr;
+}
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+char *payload(SegmentHeader *h) {
+    return reinterpret_cast<char *>(h) + h->headerSize;
+}
+
+const char *payload(const SegmentHeader *h) {
+    return reinterpret_cast<const char *>(h) + h->headerSize;
+}
+
+uint64_t nowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+}
+
+Publisher::~Publisher()
+{
+    close();
+}
+
+bool Publisher::open(const std::string &name, size_t capacity, std::string *error)
+{
+    close();
+
+    const size_t mapSize = kHeaderSize + capacity;
+    int fd = -1;
+    // Twice at most: a leftover segment of another size is unlinked and
+    // made afresh, since shrinking it under a reader's mapping would SIGBUS it.
+    for (int attempt = 0; attempt < 2 && fd < 0; ++attempt) {
+        fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) return fail(error, name + ": " + std::strerror(errno));
+        if (::flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            const int err = errno;
+            ::close(fd);
+            if (err == EWOULDBLOCK) return fail(error, name + ": another publisher is running");
+            return fail(error, name + ": " + std::strerror(err));
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return fail(error, name + ": " + std::strerror(errno));
+        }
+        // Readers would refuse it anyway, so say why up front; one of ours
+        // that's too open just gets tightened.
+        if ((st.st_mode & (S_IWGRP | S_IWOTH)) && st.st_uid == ::geteuid()) {
+            ::fchmod(fd, 0644);
+            st.st_mode &= ~mode_t(S_IWGRP | S_IWOTH);
+        }
+        if (const char *problem = untrusted(st)) {
+            ::close(fd);
+            return fail(error, name + ": " + problem);
+        }
+        if (st.st_size != 0 && size_t(st.st_size) != mapSize) {
+            ::shm_unlink(name.c_str());
+            ::close(fd);
+            fd = -1;
+            continue;
+        }
+        if (st.st_size == 0 && ::ftruncate(fd, off_t(mapSize)) != 0) {
+            const int err = errno;
+            ::shm_unlink(name.c_str());
+            ::close(fd);
+            return fail(error, name + ": " + std::strerror(err));
+        }
+    }
+    if (fd < 0) return fail(error, name + ": couldn't replace the old segment");
+
+    void *map = ::mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        ::close(fd);
+        return fail(error, name + ": " + std::strerror(errno));
+    }
+
+    // Fresh segments are zero-filled. A crashed publisher's keeps its
+    // sequence, made odd until our first publish, so nobody trusts the
+    // payload it may have left half-written.
+    SegmentHeader *h = static_cast<SegmentHeader *>(map);
+    const uint64_t previous = h->sequence.load(std::memory_order_relaxed);
+    h->sequence.store(previous | 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(h->magic, kMagic, sizeof(kMagic));
+    h->version = kVersion;
+    h->headerSize = uint32_t(kHeaderSize);
+    h->capacity = capacity;
+    h->publisherPid = uint32_t(::getpid());
+
+    m_name = name;
+    m_header = h;
+    m_mapSize = mapSize;
+    m_fd = fd;
+    return true;
+}
+
+void Publisher::close()
+{
+    if (!m_header) return;
+    m_header->sequence.fetch_or(1, std::memory_order_release);
+    ::shm_unlink(m_name.c_str());
+    ::munmap(m_header, m_mapSize);
+    ::close(m_fd);      // drops the flock
+    m_header = nullptr;
+    m_mapSize = 0;
+    m_fd = -1;
+}
+
+bool Publisher::publish(const char *data, size_t size)
+{
+    if (!m_header || size > m_header->capacity) return false;
+
+    // Odd, whatever it was before (odd already after open()).
+    const uint64_t writing = m_header->sequence.load(std::memory_order_relaxed) | 1;
+    m_header->sequence.store(writing, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(payload(m_header), data, size);
+    m_header->payloadBytes.store(size, std::memory_order_relaxed);
+    m_header->publishedNs.store(nowNs(), std::memory_order_relaxed);
+
+    m_header->sequence.store(writing + 1, std::memory_order_release);
+    return true;
+}
+
+Subscriber::~Subscriber()
+{
+    close();
+}
+
+bool Subscriber::open(const std::string &name, std::string *error)
+{
+    close();
+
+    int fd = ::shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) return fail(error, name + ": " + std::strerror(errno));
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(SegmentHeader)) {
+        ::close(fd);
+        return fail(error, name + ": too short for a snapshot segment");
+    }
+    if (const char *problem = untrusted(st)) {
+        ::close(fd);
+        return fail(error, name + ": " + problem);
+    }
+    // A live publisher holds an exclusive flock for as long as it runs. If
+    // ours goes through, it was killed (SIGKILL, the OOM killer) without
+    // getting to mark the sequence, and the payload is stale.
+    if (::flock(fd, LOCK_SH | LOCK_NB) == 0) {
+        ::close(fd);
+        return fail(error, name + ": no publisher running");
+    }
+    void *map = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return fail(error, name + ": " + std::strerror(errno));
+
+    const SegmentHeader *h = static_cast<const SegmentHeader *>(map);
+    const char *problem = nullptr;
+    if (std::memcmp(h->magic, kMagic, sizeof(kMagic)) != 0) problem = "not a snapshot segment";
+    else if (h->version != kVersion) problem = "unsupported segment version";
+    else if (h->headerSize < sizeof(SegmentHeader) || h->headerSize % 64 != 0
+             || h->headerSize > size_t(st.st_size)
+             || h->capacity > size_t(st.st_size) - h->headerSize) problem = "segment out of bounds";
+    if (problem) {
+        ::munmap(map, size_t(st.st_size));
+        return fail(error, name + ": " + problem);
+    }
+
+    m_header = h;
+    m_mapSize = size_t(st.st_size);
+    return true;
+}
+
+void Subscriber::close()
+{
+    if (m_header) ::munmap(const_cast<SegmentHeader *>(m_header), m_mapSize);
+    m_header = nullptr;
+    m_mapSize = 0;
+}
+
+bool Subscriber::read(std::vector<char> *out, uint64_t *sequence, uint64_t *publishedNs) const
+{
+    if (!m_header) return false;
+
+    for (int attempt = 0; attempt < kReadAttempts; ++attempt) {
+        const uint64_t before = m_header->sequence.load(std::memory_order_acquire);
+        if (before == 0) return false;  // never published
+        if (before & 1) {
+            cpuRelax();
+            continue;
+        }
+
+        const uint64_t bytes = m_header->payloadBytes.load(std::memory_order_relaxed);
+        const uint64_t when = m_header->publishedNs.load(std::memory_order_relaxed);
+        if (bytes > m_header->capacity) continue;   // torn; the sequence check would say so too
+        out->resize(size_t(bytes));
+        std::memcpy(out->data(), payload(m_header), size_t(bytes));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_header->sequence.load(std::memory_order_relaxed) != before) continue;
+
+        if (sequence) *sequence = before;
+        if (publishedNs) *publishedNs = when;
+        return true;
+    }
+    return false;
+}
+
+}
+}
@@ -0,0 +1,123 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef SHAREDSNAPSHOT_H
+#define SHAREDSNAPSHOT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// The probe results of this machine in POSIX shared memory, so monitoring
+// agents, login banners and the card can all share one set of probes. A
+// resident publisher (AboutThisSyn --publish) owns the segment and rewrites it
+// when the hardware changes; any number of readers map it read-only.
+//
+// The segment is a SegmentHeader followed by one binary snapshot (see
+// snapshotformat.h) behind a seqlock: the publisher makes the sequence odd,
+// copies the new payload in, then makes it even again. A reader copies the
+// payload out and keeps it only if the sequence was even and unchanged
+// throughout. After open() that's a couple of loads and a memcpy, with no
+// syscalls and no locks, so a reader never holds up the publisher or another
+// reader.
+//
+// Qt-free, like snapshotformat.h: agents can link it without Qt.
+namespace Hardware {
+namespace Shared {
+
+constexpr const char *kDefaultName = "/aboutthissyn";
+constexpr char kMagic[8] = { 'A', 'T', 'S', 'S', 'H', 'M', '\0', '\0' };
+constexpr uint32_t kVersion = 1;
+// Sparse on tmpfs: only the pages the payload touches are ever allocated.
+constexpr size_t kDefaultCapacity = 4u << 20;
+
+struct SegmentHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;        // payload starts here, 64-byte aligned
+    uint64_t capacity;          // payload bytes available
+    uint32_t publisherPid;
+    uint32_t reserved;
+    // Its own cache line: readers poll it, the rest of the header is static.
+    // Odd while a write is in progress and after a clean close(); 0 until
+    // the first publish. A publisher that was killed leaves it even, which
+    // is why Subscriber::open() checks for the publisher's flock too.
+    alignas(64) std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> payloadBytes;
+    std::atomic<uint64_t> publishedNs;  // CLOCK_REALTIME of the last publish
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "seqlock needs a lock-free counter");
+
+// Owns the segment: creates it, and holds an exclusive flock on it so a
+// second publisher refuses to start. One that crashed is taken over in place,
+// so readers that mapped it carry on. close() leaves the sequence odd, which
+// readers take as "probe it yourself", and unlinks the name; a reader whose
+// read() keeps failing should reopen.
+class Publisher
+{
+public:
+    Publisher() = default;
+    ~Publisher();
+
+    Publisher(const Publisher &) = delete;
+    Publisher &operator=(const Publisher &) = delete;
+
+    bool open(const std::string &name = kDefaultName, size_t capacity = kDefaultCapacity,
+              std::string *error = nullptr);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+
+    // Replaces the payload; readers mid-copy retry. False if it doesn't fit.
+    bool publish(const char *data, size_t size);
+
+    uint64_t sequence() const { return m_header ? m_header->sequence.load(std::memory_order_relaxed) : 0; }
+
+private:
+    std::string m_name;
+    SegmentHeader *m_header = nullptr;
+    size_t m_mapSize = 0;
+    int m_fd = -1;
+};
+
+// Maps a published segment read-only. open() is the only call that enters
+// the kernel; everything else is plain memory access. open() refuses a
+// segment that isn't owned by root or the caller, or that group or others
+// can write, so another local user can't plant facts in someone's card, and
+// one whose publisher no longer holds its lock. A long-lived reader should
+// reopen now and then to notice a publisher that has died since.
+class Subscriber
+{
+public:
+    Subscriber() = default;
+    ~Subscriber();
+
+    Subscriber(const Subscriber &) = delete;
+    Subscriber &operator=(const Subscriber &) = delete;
+
+    bool open(const std::string &name = kDefaultName, std::string *error = nullptr);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+
+    // Changes on every publish. Cheap enough to poll before deciding to read().
+    uint64_t sequence() const { return m_header ? m_header->sequence.load(std::memory_order_acquire) : 0; }
+
+    // Copies a consistent payload into *out, reusing its storage. The buffer
+    // comes from operator new, so Binary::Reader::openBuffer() can view it
+    // in place. False if nothing has been published yet, the publisher has
+    // gone, or it was caught mid-write on every attempt.
+    bool read(std::vector<char> *out, uint64_t *sequence = nullptr, uint64_t *publishedNs = nullptr) const;
+
+private:
+    const SegmentHeader *m_header = nullptr;
+    size_t m_mapSize = 0;
+};
+
+}
+}
+
+#endif // SHAREDSNAPSHOT_H
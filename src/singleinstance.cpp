@@ -0,0 +1,159 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "singleinstance.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTimer>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+const char kRequest[] = "activate\n";
+const char kReply[] = "ok\n";
+
+// A healthy instance answers within a frame or two. Past this it's wedged
+// (or exiting), and we'd rather open a window of our own.
+const int kReplyTimeoutMs = 500;
+
+// /tmp is shared with everyone, so the fallback socket goes in a 0700
+// directory of our own. Empty if that name is already taken by something we
+// don't own or others can write to.
+std::string privateTmpDir() {
+    const std::string dir = "/tmp/AboutThisSyn-" + std::to_string(::getuid());
+    if (::mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) return std::string();
+    struct stat st;
+    if (::lstat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)
+        || st.st_uid != ::getuid() || (st.st_mode & 077) != 0) {
+        return std::string();
+    }
+    return dir;
+}
+
+// $XDG_RUNTIME_DIR/AboutThisSyn-<display>, or /tmp/AboutThisSyn-<uid>/AboutThisSyn-<display>.
+// The display is part of the name so a second session gets its own window.
+// Empty if there's nowhere safe to put it.
+std::string socketPath() {
+    std::string path;
+    if (const char *runtime = std::getenv("XDG_RUNTIME_DIR")) path = runtime;
+    if (path.empty()) path = privateTmpDir();
+    if (path.empty()) return std::string();
+    path += "/AboutThisSyn";
+
+    const char *display = std::getenv("WAYLAND_DISPLAY");
+    if (!display || !*display) display = std::getenv("DISPLAY");
+    if (display && *display) {
+        path += '-';
+        for (const char *c = display; *c; ++c) path += (*c == '/' || *c == ':') ? '_' : *c;
+    }
+    return path;
+}
+
+// Connected fd, or -1 if nobody is listening there. A listener running as
+// another user counts as nobody: it must never be able to answer for us.
+int connectTo(const std::string &path) {
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) return -1;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    ucred peer;
+    socklen_t peerLen = sizeof(peer);
+    if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer, &peerLen) != 0 || peer.uid != ::getuid()) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+}
+
+SingleInstance::SingleInstance(QObject *parent)
+    : QObject(parent)
+    , m_server(new QLocalServer(this))
+{
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    connect(m_server, &QLocalServer::newConnection, this, &SingleInstance::acceptConnection);
+}
+
+SingleInstance::~SingleInstance()
+{
+}
+
+bool SingleInstance::forwardToRunning(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--new-instance") == 0) return false;
+    }
+
+    const int fd = connectTo(socketPath());
+    if (fd < 0) return false;
+
+    bool handedOver = false;
+    const ssize_t len = ssize_t(sizeof(kRequest) - 1);
+    if (::send(fd, kRequest, size_t(len), MSG_NOSIGNAL) == len) {
+        pollfd pfd = { fd, POLLIN, 0 };
+        char reply[sizeof(kReply)] = {};
+        if (::poll(&pfd, 1, kReplyTimeoutMs) == 1
+            && ::recv(fd, reply, sizeof(kReply) - 1, MSG_WAITALL) == ssize_t(sizeof(kReply) - 1)) {
+            handedOver = std::strcmp(reply, kReply) == 0;
+        }
+    }
+    ::close(fd);
+    return handedOver;
+}
+
+bool SingleInstance::listen()
+{
+    const std::string path = socketPath();
+    if (path.empty()) return false;
+    const QString name = QString::fromStdString(path);
+    if (m_server->listen(name)) return true;
+    if (m_server->serverError() != QAbstractSocket::AddressInUseError) return false;
+
+    // Either another instance got there first, or one crashed and left its
+    // socket file behind. Only the second kind may be cleaned up.
+    const int fd = connectTo(path);
+    if (fd >= 0) {
+        ::close(fd);
+        return false;
+    }
+    QLocalServer::removeServer(name);
+    return m_server->listen(name);
+}
+
+void SingleInstance::acceptConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            if (!socket->canReadLine()) return;
+            const QByteArray line = socket->readLine();
+            if (line == kRequest) {
+                socket->write(kReply);
+                socket->flush();
+                emit activationRequested();
+            }
+            socket->disconnectFromServer();
+        });
+        // Don't let a client that never speaks hang around.
+        QTimer::singleShot(kReplyTimeoutMs * 2, socket, &QLocalSocket::abort);
+    }
+}
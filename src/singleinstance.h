@@ -0,0 +1,45 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef SINGLEINSTANCE_H
+#define SINGLEINSTANCE_H
+
+#include <QObject>
+
+class QLocalServer;
+
+// One About This Computer per user and display. The first launch listens on
+// a local socket; every later launch hands its request over and exits, and
+// the running instance raises its window (cancelling a fade-out if need be)
+// instead of paying for a new QApplication and a fresh round of probes.
+class SingleInstance : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SingleInstance(QObject *parent = nullptr);
+    ~SingleInstance();
+
+    // Called before any QApplication exists, so it's plain POSIX sockets
+    // rather than QLocalSocket. True if a running instance acknowledged the
+    // request, in which case the caller should just exit. --new-instance
+    // skips the hand-over.
+    static bool forwardToRunning(int argc, char *argv[]);
+
+    // Starts accepting requests from later launches. False if another
+    // instance already owns the socket (e.g. this one has --new-instance).
+    bool listen();
+
+signals:
+    void activationRequested();
+
+private slots:
+    void acceptConnection();
+
+private:
+    QLocalServer *m_server;
+};
+
+#endif // SINGLEINSTANCE_H
@@ -0,0 +1,110 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "snapshotcache.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace {
+
+const quint32 kMagic = 0x41545343; // "ATSC"
+
+// Bump whenever the stored values change shape or formatting, so old caches
+// are ignored rather than shown.
+const quint16 kFormatVersion = 3;
+
+QByteArray readSmallFile(const QString &path) {
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return QByteArray();
+    return f.read(4096).trimmed();
+}
+
+}
+
+SnapshotCache::SnapshotCache()
+{
+    // Honour XDG_CACHE_HOME directly rather than via QStandardPaths, which
+    // would bake the (localisable) application name into the path.
+    QString base = QString::fromLocal8Bit(qgetenv("XDG_CACHE_HOME"));
+    if (base.isEmpty()) base = QDir::homePath() + "/.cache";
+    m_path = base + "/AboutThisSyn/snapshot";
+}
+
+QByteArray SnapshotCache::currentKey()
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    // Changes on every boot, so anything hot-swapped while we were off is seen.
+    hash.addData(readSmallFile("/proc/sys/kernel/random/boot_id"));
+
+    // DMI identity: the world-readable bits only (serials need root).
+    static const char *const dmiFields[] = {
+        "sys_vendor", "product_name", "product_version",
+        "board_vendor", "board_name", "bios_version", "bios_date"
+    };
+    for (const char *field : dmiFields) {
+        hash.addData(readSmallFile(QString("/sys/class/dmi/id/") + field));
+        hash.addData("\0", 1);
+    }
+
+    // PCI inventory: slot plus vendor:device, so a GPU swap in the same slot
+    // still invalidates.
+    QDir pci("/sys/bus/pci/devices");
+    const QStringList slots = pci.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    for (const QString &slot : slots) {
+        hash.addData(slot.toLatin1());
+        hash.addData(readSmallFile(pci.filePath(slot + "/vendor")));
+        hash.addData(readSmallFile(pci.filePath(slot + "/device")));
+    }
+
+    return hash.result().toHex();
+}
+
+bool SnapshotCache::load(QMap<int, QString> &values) const
+{
+    QFile f(m_path);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    QDataStream in(&f);
+    in.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    quint16 version = 0;
+    QByteArray key;
+    in >> magic >> version;
+    if (magic != kMagic || version != kFormatVersion) return false;
+
+    in >> key;
+    if (in.status() != QDataStream::Ok || key != currentKey()) return false;
+
+    QMap<int, QString> stored;
+    in >> stored;
+    if (in.status() != QDataStream::Ok) return false;
+
+    values = stored;
+    return true;
+}
+
+bool SnapshotCache::save(const QMap<int, QString> &values) const
+{
+    QDir().mkpath(QFileInfo(m_path).absolutePath());
+
+    QSaveFile f(m_path);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+
+    QDataStream out(&f);
+    out.setVersion(QDataStream::Qt_5_0);
+    out << kMagic << kFormatVersion << currentKey() << values;
+
+    if (out.status() != QDataStream::Ok) {
+        f.cancelWriting();
+        return false;
+    }
+    return f.commit();
+}
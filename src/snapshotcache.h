@@ -0,0 +1,38 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef SNAPSHOTCACHE_H
+#define SNAPSHOTCACHE_H
+
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+
+// On-disk cache of probe results that don't change while the machine is up.
+// Lives at $XDG_CACHE_HOME/AboutThisSyn/snapshot and is keyed on the kernel
+// boot ID plus a fingerprint of the DMI identity and PCI device list, so a
+// reboot or a hardware swap throws it away.
+class SnapshotCache
+{
+public:
+    SnapshotCache();
+
+    QString fileName() const { return m_path; }
+
+    // Fills values (probe id -> formatted result) if the file exists, parses,
+    // and was written for the current boot and hardware.
+    bool load(QMap<int, QString> &values) const;
+
+    // Writes atomically; a half-written cache is never visible.
+    bool save(const QMap<int, QString> &values) const;
+
+    // boot_id + fingerprint, hashed. Exposed for diagnostics.
+    static QByteArray currentKey();
+
+private:
+    QString m_path;
+};
+
+#endif // SNAPSHOTCACHE_H
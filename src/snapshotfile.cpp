@@ -0,0 +1,324 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "snapshotfile.h"
+#include <QBuffer>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <cstring>
+
+namespace Hardware {
+namespace Binary {
+
+namespace {
+
+// A spool keeps this much in memory before it spills to disk.
+const int kSpoolBuffer = 1 << 20;
+
+template <typename T>
+uint32_t count(const Spool &spool) {
+    return uint32_t(spool.size() / sizeof(T));
+}
+
+template <typename T>
+Range rangeFrom(uint32_t first, const Spool &spool) {
+    return Range{ first, count<T>(spool) - first };
+}
+
+size_t aligned(size_t n) {
+    return (n + 7) & ~size_t(7);
+}
+
+template <typename T>
+Section placed(size_t &at, const Spool &spool) {
+    const Section s{ at, count<T>(spool), uint32_t(sizeof(T)) };
+    at = aligned(at + spool.size());
+    return s;
+}
+
+// Pads up to the section's offset, then writes its bytes.
+bool writeSection(QIODevice &f, const Section &s, const Spool &spool) {
+    static const char zeros[8] = {};
+    const qint64 pad = qint64(s.offset) - f.pos();
+    if (pad < 0 || pad > qint64(sizeof(zeros))) return false;
+    if (pad > 0 && f.write(zeros, pad) != pad) return false;
+    return spool.copyTo(f);
+}
+
+QString fromRef(const Reader &reader, StringRef ref) {
+    const std::string_view s = reader.string(ref);
+    return QString::fromUtf8(s.data(), int(s.size()));
+}
+
+}
+
+bool Spool::append(const void *data, size_t bytes)
+{
+    m_buffer.append(static_cast<const char *>(data), int(bytes));
+    m_size += bytes;
+    if (m_buffer.size() < kSpoolBuffer) return true;
+
+    if (!m_file) {
+        m_file.reset(new QTemporaryFile);
+        if (!m_file->open()) return false;
+    }
+    const bool ok = m_file->write(m_buffer) == qint64(m_buffer.size());
+    m_buffer.clear();
+    return ok;
+}
+
+bool Spool::copyTo(QIODevice &out) const
+{
+    if (m_file) {
+        if (!m_file->flush() || !m_file->seek(0)) return false;
+        char chunk[64 * 1024];
+        for (qint64 n; (n = m_file->read(chunk, sizeof(chunk))) != 0; ) {
+            if (n < 0 || out.write(chunk, n) != n) return false;
+        }
+    }
+    return m_buffer.isEmpty() || out.write(m_buffer) == qint64(m_buffer.size());
+}
+
+// Appends utf8 and its terminator; a string table past 4 GiB is caught in save().
+StringRef Writer::store(const QByteArray &utf8)
+{
+    const char nul = '\0';
+    if (m_strings.size() == 0) m_failed |= !m_strings.append(&nul, 1); // offset 0 is the empty string
+
+    const StringRef ref{ uint32_t(m_strings.size()), uint32_t(utf8.size()) };
+    m_failed |= !m_strings.append(utf8.constData(), size_t(utf8.size()));
+    m_failed |= !m_strings.append(&nul, 1);
+    return ref;
+}
+
+StringRef Writer::intern(const QString &s)
+{
+    if (s.isEmpty()) return StringRef{ 0, 0 };
+
+    const QByteArray utf8 = s.toUtf8();
+    auto it = m_interned.constFind(utf8);
+    if (it != m_interned.constEnd()) return it.value();
+
+    const StringRef ref = store(utf8);
+    m_interned.insert(utf8, ref);
+    return ref;
+}
+
+void Writer::add(const QString &host, const Snapshot &snapshot)
+{
+    HostRecord h{};
+    h.name = host.isEmpty() ? StringRef{ 0, 0 } : store(host.toUtf8());
+    h.osName = intern(snapshot.os.name);
+    h.osVersion = intern(snapshot.os.version);
+    h.osVersionId = intern(snapshot.os.versionId);
+    h.osPrettyName = intern(snapshot.os.prettyName);
+    h.memoryType = intern(snapshot.memory.type);
+    h.memorySource = intern(snapshot.memory.source);
+    h.memoryTotalBytes = snapshot.memory.totalBytes;
+    h.memorySpeedMts = uint32_t(snapshot.memory.speedMts);
+
+    const ProcessorInfo &p = snapshot.processor;
+    CpuRecord cpu{};
+    cpu.model = intern(p.model);
+    cpu.rawModel = intern(p.rawModel);
+    cpu.physicalCores = uint32_t(p.physicalCores);
+    cpu.logicalCpus = uint32_t(p.logicalCpus);
+    cpu.sockets = uint32_t(p.sockets);
+    cpu.numaNodes = uint32_t(p.numaNodes);
+    cpu.maxGhz = p.maxGhz;
+    const uint32_t firstCpu = count<CpuRecord>(m_cpus);
+    m_failed |= !m_cpus.append(cpu);
+    h.cpus = rangeFrom<CpuRecord>(firstCpu, m_cpus);
+
+    const uint32_t firstDimm = count<DimmRecord>(m_dimms);
+    for (const MemoryModule &m : snapshot.memory.modules) {
+        DimmRecord d{};
+        d.sizeBytes = m.sizeBytes;
+        d.type = intern(m.type);
+        d.locator = intern(m.locator);
+        d.bankLocator = intern(m.bankLocator);
+        d.manufacturer = intern(m.manufacturer);
+        d.partNumber = intern(m.partNumber);
+        d.speedMts = uint32_t(m.speedMts);
+        d.configuredMts = uint32_t(m.configuredMts);
+        m_failed |= !m_dimms.append(d);
+    }
+    h.dimms = rangeFrom<DimmRecord>(firstDimm, m_dimms);
+
+    const uint32_t firstGpu = count<GpuRecord>(m_gpus);
+    for (const GraphicsDevice &gpu : snapshot.graphics.devices) {
+        GpuRecord g{};
+        g.slot = intern(gpu.slot);
+        g.vendor = intern(gpu.vendor);
+        g.device = intern(gpu.device);
+        g.name = intern(gpu.name);
+        g.vendorId = gpu.vendorId;
+        g.deviceId = gpu.deviceId;
+        g.classCode = gpu.classCode;
+        g.flags = gpu.bootVga ? GpuBootVga : 0;
+        m_failed |= !m_gpus.append(g);
+    }
+    h.gpus = rangeFrom<GpuRecord>(firstGpu, m_gpus);
+
+    const uint32_t firstDisk = count<DiskRecord>(m_disks);
+    for (const StorageDevice &dev : snapshot.storage.devices) {
+        DiskRecord d{};
+        d.name = intern(dev.name);
+        d.model = intern(dev.model);
+        d.vendor = intern(dev.vendor);
+        d.scheduler = intern(dev.scheduler);
+        d.bytesTotal = dev.bytesTotal;
+        d.flags = (dev.rotational ? DiskRotational : 0) | (dev.removable ? DiskRemovable : 0);
+        d.logicalBlockSize = uint32_t(dev.logicalBlockSize);
+        d.physicalBlockSize = uint32_t(dev.physicalBlockSize);
+        d.queueDepth = uint32_t(dev.queueDepth);
+        m_failed |= !m_disks.append(d);
+    }
+    h.disks = rangeFrom<DiskRecord>(firstDisk, m_disks);
+
+    m_failed |= !m_hosts.append(h);
+    ++m_hostCount;
+}
+
+bool Writer::write(QIODevice &out) const
+{
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrderMark;
+    header.headerSize = sizeof(FileHeader);
+
+    if (m_failed || m_strings.size() > UINT32_MAX) return false;
+
+    size_t at = sizeof(FileHeader);
+    header.hosts = placed<HostRecord>(at, m_hosts);
+    header.cpus = placed<CpuRecord>(at, m_cpus);
+    header.dimms = placed<DimmRecord>(at, m_dimms);
+    header.gpus = placed<GpuRecord>(at, m_gpus);
+    header.disks = placed<DiskRecord>(at, m_disks);
+    header.strings = placed<char>(at, m_strings);
+
+    return out.write(reinterpret_cast<const char *>(&header), sizeof(header)) == qint64(sizeof(header))
+           && writeSection(out, header.hosts, m_hosts)
+           && writeSection(out, header.cpus, m_cpus)
+           && writeSection(out, header.dimms, m_dimms)
+           && writeSection(out, header.gpus, m_gpus)
+           && writeSection(out, header.disks, m_disks)
+           && writeSection(out, header.strings, m_strings);
+}
+
+QByteArray Writer::toByteArray() const
+{
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    if (!write(buffer)) return QByteArray();
+    return bytes;
+}
+
+bool Writer::save(const QString &path, QString *error) const
+{
+    if (m_strings.size() > UINT32_MAX) {
+        if (error) *error = "string table too large";
+        return false;
+    }
+    if (m_failed) {
+        if (error) *error = "couldn't spool records to a temporary file";
+        return false;
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+
+    if (!write(f)) {
+        if (error) *error = f.errorString();
+        f.cancelWriting();
+        return false;
+    }
+    if (!f.commit()) {
+        if (error) *error = f.errorString();
+        return false;
+    }
+    return true;
+}
+
+QString hostName(const Reader &reader, const HostRecord &host)
+{
+    return fromRef(reader, host.name);
+}
+
+Snapshot toSnapshot(const Reader &reader, const HostRecord &host)
+{
+    Snapshot s;
+    s.os.name = fromRef(reader, host.osName);
+    s.os.version = fromRef(reader, host.osVersion);
+    s.os.versionId = fromRef(reader, host.osVersionId);
+    s.os.prettyName = fromRef(reader, host.osPrettyName);
+
+    s.memory.totalBytes = host.memoryTotalBytes;
+    s.memory.speedMts = int(host.memorySpeedMts);
+    s.memory.type = fromRef(reader, host.memoryType);
+    s.memory.source = fromRef(reader, host.memorySource);
+
+    for (const CpuRecord &cpu : reader.cpus(host)) {
+        s.processor.model = fromRef(reader, cpu.model);
+        s.processor.rawModel = fromRef(reader, cpu.rawModel);
+        s.processor.physicalCores = int(cpu.physicalCores);
+        s.processor.logicalCpus = int(cpu.logicalCpus);
+        s.processor.sockets = int(cpu.sockets);
+        s.processor.numaNodes = int(cpu.numaNodes);
+        s.processor.maxGhz = cpu.maxGhz;
+    }
+
+    for (const DimmRecord &d : reader.dimms(host)) {
+        MemoryModule m;
+        m.sizeBytes = d.sizeBytes;
+        m.type = fromRef(reader, d.type);
+        m.speedMts = int(d.speedMts);
+        m.configuredMts = int(d.configuredMts);
+        m.locator = fromRef(reader, d.locator);
+        m.bankLocator = fromRef(reader, d.bankLocator);
+        m.manufacturer = fromRef(reader, d.manufacturer);
+        m.partNumber = fromRef(reader, d.partNumber);
+        s.memory.modules.append(m);
+    }
+
+    for (const GpuRecord &g : reader.gpus(host)) {
+        GraphicsDevice gpu;
+        gpu.slot = fromRef(reader, g.slot);
+        gpu.vendorId = g.vendorId;
+        gpu.deviceId = g.deviceId;
+        gpu.classCode = g.classCode;
+        gpu.bootVga = g.flags & GpuBootVga;
+        gpu.vendor = fromRef(reader, g.vendor);
+        gpu.device = fromRef(reader, g.device);
+        gpu.name = fromRef(reader, g.name);
+        s.graphics.devices.append(gpu);
+    }
+
+    for (const DiskRecord &d : reader.disks(host)) {
+        StorageDevice dev;
+        dev.name = fromRef(reader, d.name);
+        dev.model = fromRef(reader, d.model);
+        dev.vendor = fromRef(reader, d.vendor);
+        dev.bytesTotal = d.bytesTotal;
+        dev.rotational = d.flags & DiskRotational;
+        dev.removable = d.flags & DiskRemovable;
+        dev.logicalBlockSize = int(d.logicalBlockSize);
+        dev.physicalBlockSize = int(d.physicalBlockSize);
+        dev.queueDepth = int(d.queueDepth);
+        dev.scheduler = fromRef(reader, d.scheduler);
+        s.storage.devices.append(dev);
+    }
+    return s;
+}
+
+}
+}
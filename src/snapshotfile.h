@@ -0,0 +1,79 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef SNAPSHOTFILE_H
+#define SNAPSHOTFILE_H
+
+#include "hardware.h"
+#include "snapshotformat.h"
+#include <QByteArray>
+#include <QHash>
+#include <QIODevice>
+#include <QTemporaryFile>
+#include <memory>
+
+// Writing binary snapshot files, and turning their records back into the
+// Hardware structs. The format itself and the zero-copy reader are in
+// snapshotformat.h.
+namespace Hardware {
+namespace Binary {
+
+// One section's bytes as they're appended: in memory up to a limit, then
+// spilled to a temporary file that goes away with the spool.
+class Spool
+{
+public:
+    bool append(const void *data, size_t bytes);
+    template <typename T> bool append(const T &record) { return append(&record, sizeof(T)); }
+    size_t size() const { return m_size; }
+    bool copyTo(QIODevice &out) const;
+
+private:
+    QByteArray m_buffer;
+    std::unique_ptr<QTemporaryFile> m_file;
+    size_t m_size = 0;
+};
+
+// Collects hosts (records plus the shared string table) and writes the file
+// in one go. Each section spools to a temporary file as it grows, and host
+// names, which never repeat, aren't kept for deduplication, so memory stays
+// bounded by the distinct models, part numbers and so on, not the host count.
+class Writer
+{
+public:
+    void add(const QString &host, const Snapshot &snapshot);
+    int hostCount() const { return m_hostCount; }
+
+    // Writes atomically; a half-written file is never visible.
+    bool save(const QString &path, QString *error = nullptr) const;
+
+    // The whole file in memory; empty if it couldn't be laid out.
+    QByteArray toByteArray() const;
+
+private:
+    StringRef intern(const QString &s);
+    StringRef store(const QByteArray &utf8);
+    bool write(QIODevice &out) const;
+
+    int m_hostCount = 0;
+    Spool m_hosts;
+    Spool m_cpus;
+    Spool m_dimms;
+    Spool m_gpus;
+    Spool m_disks;
+    Spool m_strings;
+    QHash<QByteArray, StringRef> m_interned;
+    bool m_failed = false;      // a spool couldn't spill; save() reports it
+};
+
+// Copies a host's records out of the mapping. Only startupDisk and the
+// storage volumes stay empty: the format doesn't carry them.
+QString hostName(const Reader &reader, const HostRecord &host);
+Snapshot toSnapshot(const Reader &reader, const HostRecord &host);
+
+}
+}
+
+#endif // SNAPSHOTFILE_H
@@ -0,0 +1,113 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "snapshotformat.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Hardware {
+namespace Binary {
+
+namespace {
+
+bool fail(std::string *error, const char *message) {
+    if (error) *error = message;
+    return false;
+}
+
+// A section must sit inside the file, start aligned for its records and
+// step by at least the record size this build knows about.
+bool sectionFits(const Section &s, size_t recordSize, size_t fileSize) {
+    if (s.offset % 8 != 0 || s.offset > fileSize) return false;
+    if (s.count == 0) return true;
+    if (s.stride < recordSize || (recordSize > 1 && s.stride % 8 != 0)) return false;
+    return uint64_t(s.count) * s.stride <= fileSize - s.offset;
+}
+
+}
+
+Reader::~Reader()
+{
+    close();
+}
+
+void Reader::close()
+{
+    if (m_data && m_mapped) ::munmap(const_cast<char *>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+}
+
+bool Reader::isSnapshotFile(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    char magic[sizeof(kMagic)];
+    const bool ok = ::pread(fd, magic, sizeof(magic), 0) == ssize_t(sizeof(magic))
+                    && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+    ::close(fd);
+    return ok;
+}
+
+bool Reader::open(const std::string &path, std::string *error)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return fail(error, "can't open file");
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        return fail(error, "too short for a snapshot");
+    }
+    void *map = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return fail(error, "can't map file");
+
+    m_data = static_cast<const char *>(map);
+    m_size = size_t(st.st_size);
+    m_mapped = true;
+    return validate(error);
+}
+
+bool Reader::openBuffer(const char *data, size_t size, std::string *error)
+{
+    close();
+    if (!data || size < sizeof(FileHeader)) return fail(error, "too short for a snapshot");
+    if (reinterpret_cast<uintptr_t>(data) % 8 != 0) return fail(error, "buffer isn't 8-byte aligned");
+
+    m_data = data;
+    m_size = size;
+    return validate(error);
+}
+
+bool Reader::validate(std::string *error)
+{
+    const FileHeader &h = header();
+    const char *problem = nullptr;
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) problem = "not a snapshot file";
+    else if (h.byteOrder != kByteOrderMark) problem = "written on a machine of the other byte order";
+    else if (h.version < kVersion) problem = "unsupported snapshot version";
+    else if (h.headerSize < sizeof(FileHeader) || h.headerSize > m_size) problem = "bad header size";
+    else if (!sectionFits(h.hosts, sizeof(HostRecord), m_size)
+             || !sectionFits(h.cpus, sizeof(CpuRecord), m_size)
+             || !sectionFits(h.dimms, sizeof(DimmRecord), m_size)
+             || !sectionFits(h.gpus, sizeof(GpuRecord), m_size)
+             || !sectionFits(h.disks, sizeof(DiskRecord), m_size)
+             || !sectionFits(h.strings, 1, m_size)) problem = "section out of bounds";
+
+    if (problem) {
+        close();
+        return fail(error, problem);
+    }
+    return true;
+}
+
+}
+}
@@ -0,0 +1,243 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef SNAPSHOTFORMAT_H
+#define SNAPSHOTFORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Binary snapshot files (".atss"): probe results for any number of hosts in
+// a layout that's read in place. A file is
+//
+//   FileHeader | hosts | cpus | dimms | gpus | disks | string table
+//
+// with every section 8-byte aligned. Records are fixed-size and refer to
+// strings by (offset, length) into the table, which is UTF-8, NUL after each
+// string, and deduplicated, so a fleet's thousand copies of one CPU model are
+// stored once. Integers are native little-endian.
+//
+// Each section records its own stride. Later versions may grow the header
+// and records at the end; readers accept any version from kVersion up, step
+// by the stride and only look at the fields they know. A change old readers
+// couldn't skip over gets a new magic instead.
+//
+// Qt-free, like sysfs.h: tools can read these without linking Qt.
+namespace Hardware {
+namespace Binary {
+
+constexpr char kMagic[8] = { 'A', 'T', 'S', 'S', 'N', 'A', 'P', '\0' };
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kByteOrderMark = 0x01020304;
+
+struct StringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct Range {
+    uint32_t first;
+    uint32_t count;
+};
+
+struct Section {
+    uint64_t offset;
+    uint32_t count;             // records (bytes, for the string table)
+    uint32_t stride;            // bytes per record (1 for the string table)
+};
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t headerSize;
+    uint32_t reserved;
+    Section hosts;
+    Section cpus;
+    Section dimms;
+    Section gpus;
+    Section disks;
+    Section strings;
+};
+
+struct HostRecord {
+    StringRef name;
+    StringRef osName;
+    StringRef osVersion;
+    StringRef osVersionId;
+    StringRef osPrettyName;
+    StringRef memoryType;
+    StringRef memorySource;
+    uint64_t memoryTotalBytes;
+    uint32_t memorySpeedMts;
+    uint32_t reserved;
+    Range cpus;
+    Range dimms;
+    Range gpus;
+    Range disks;
+};
+
+struct CpuRecord {
+    StringRef model;
+    StringRef rawModel;
+    uint32_t physicalCores;
+    uint32_t logicalCpus;
+    uint32_t sockets;
+    uint32_t numaNodes;         // 0 in files from before it was recorded
+    double maxGhz;
+};
+
+struct DimmRecord {
+    uint64_t sizeBytes;
+    StringRef type;
+    StringRef locator;
+    StringRef bankLocator;
+    StringRef manufacturer;
+    StringRef partNumber;
+    uint32_t speedMts;
+    uint32_t configuredMts;
+};
+
+enum GpuFlags : uint32_t {
+    GpuBootVga = 1u << 0
+};
+
+struct GpuRecord {
+    StringRef slot;
+    StringRef vendor;
+    StringRef device;
+    StringRef name;
+    uint16_t vendorId;
+    uint16_t deviceId;
+    uint32_t classCode;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+enum DiskFlags : uint32_t {
+    DiskRotational = 1u << 0,
+    DiskRemovable = 1u << 1
+};
+
+struct DiskRecord {
+    StringRef name;
+    StringRef model;
+    StringRef vendor;
+    StringRef scheduler;
+    uint64_t bytesTotal;
+    uint32_t flags;
+    uint32_t logicalBlockSize;
+    uint32_t physicalBlockSize;
+    uint32_t queueDepth;
+};
+
+// The layout is the file format: no implicit padding anywhere.
+static_assert(sizeof(FileHeader) == 120, "FileHeader layout");
+static_assert(sizeof(HostRecord) == 104, "HostRecord layout");
+static_assert(sizeof(CpuRecord) == 40, "CpuRecord layout");
+static_assert(sizeof(DimmRecord) == 56, "DimmRecord layout");
+static_assert(sizeof(GpuRecord) == 48, "GpuRecord layout");
+static_assert(sizeof(DiskRecord) == 56, "DiskRecord layout");
+
+// A section of records viewed in place, stepping by the file's stride.
+template <typename T>
+class Records
+{
+public:
+    class Iterator
+    {
+    public:
+        Iterator(const char *p, uint32_t stride) : m_p(p), m_stride(stride) {}
+        const T &operator*() const { return *reinterpret_cast<const T *>(m_p); }
+        const T *operator->() const { return reinterpret_cast<const T *>(m_p); }
+        Iterator &operator++() { m_p += m_stride; return *this; }
+        bool operator!=(const Iterator &other) const { return m_p != other.m_p; }
+
+    private:
+        const char *m_p;
+        uint32_t m_stride;
+    };
+
+    Records() = default;
+    Records(const char *base, uint32_t count, uint32_t stride) : m_base(base), m_count(count), m_stride(stride) {}
+
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    const T &operator[](size_t i) const { return *reinterpret_cast<const T *>(m_base + i * m_stride); }
+    Iterator begin() const { return Iterator(m_base, m_stride); }
+    Iterator end() const { return Iterator(m_base + size_t(m_count) * m_stride, m_stride); }
+
+private:
+    const char *m_base = nullptr;
+    uint32_t m_count = 0;
+    uint32_t m_stride = sizeof(T);
+};
+
+// Maps a snapshot file read-only and hands out views into it. Opening checks
+// the header and that every section lies inside the file, nothing more: no
+// record is touched until asked for. Ranges and strings are bounds-checked
+// on access and come back empty if they point outside the file.
+class Reader
+{
+public:
+    Reader() = default;
+    ~Reader();
+
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+
+    bool open(const std::string &path, std::string *error = nullptr);
+    // Same checks over bytes the caller owns (a copy out of shared memory,
+    // say). They must stay put, and 8-byte aligned, until close().
+    bool openBuffer(const char *data, size_t size, std::string *error = nullptr);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+
+    // Cheap check of the first bytes, for telling a snapshot from an archive.
+    static bool isSnapshotFile(const std::string &path);
+
+    Records<HostRecord> hosts() const {
+        return m_data ? records<HostRecord>(header().hosts) : Records<HostRecord>();
+    }
+    Records<CpuRecord> cpus(const HostRecord &host) const { return slice<CpuRecord>(header().cpus, host.cpus); }
+    Records<DimmRecord> dimms(const HostRecord &host) const { return slice<DimmRecord>(header().dimms, host.dimms); }
+    Records<GpuRecord> gpus(const HostRecord &host) const { return slice<GpuRecord>(header().gpus, host.gpus); }
+    Records<DiskRecord> disks(const HostRecord &host) const { return slice<DiskRecord>(header().disks, host.disks); }
+
+    std::string_view string(StringRef ref) const {
+        const Section &s = header().strings;
+        if (uint64_t(ref.offset) + ref.length > s.count) return std::string_view();
+        return std::string_view(m_data + s.offset + ref.offset, ref.length);
+    }
+
+    size_t fileSize() const { return m_size; }
+
+private:
+    const FileHeader &header() const { return *reinterpret_cast<const FileHeader *>(m_data); }
+
+    template <typename T>
+    Records<T> records(const Section &s) const {
+        return Records<T>(m_data + s.offset, s.count, s.stride);
+    }
+
+    template <typename T>
+    Records<T> slice(const Section &s, Range r) const {
+        if (uint64_t(r.first) + r.count > s.count) return Records<T>();
+        return Records<T>(m_data + s.offset + size_t(r.first) * s.stride, r.count, s.stride);
+    }
+
+    bool validate(std::string *error);
+
+    const char *m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;
+};
+
+}
+}
+
+#endif // SNAPSHOTFORMAT_H
@@ -0,0 +1,126 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "snapshotpublisher.h"
+#include "snapshotfile.h"
+#include "trace.h"
+#include "ueventmonitor.h"
+#include <QFutureWatcher>
+#include <QSysInfo>
+#include <QTimer>
+#include <QtConcurrent>
+
+namespace {
+
+// Same budget the card gives its slowest probes.
+const int kProbeDeadlineMs = 3000;
+
+}
+
+SnapshotPublisher::SnapshotPublisher(QObject *parent)
+    : QObject(parent)
+    , m_uevents(new UEventMonitor(this))
+    , m_poll(new QTimer(this))
+    , m_watcher(new QFutureWatcher<Probed>(this))
+{
+    m_poll->setInterval(kPollMs);
+    connect(m_poll, &QTimer::timeout, this, &SnapshotPublisher::refresh);
+    // Which row went stale doesn't matter here: the whole snapshot is redone.
+    connect(m_uevents, &UEventMonitor::probeInvalidated, this, &SnapshotPublisher::refresh);
+    connect(m_watcher, &QFutureWatcherBase::finished, this, &SnapshotPublisher::probed);
+}
+
+SnapshotPublisher::~SnapshotPublisher()
+{
+    stop();
+    m_watcher->waitForFinished();
+}
+
+bool SnapshotPublisher::start(const QString &name, QString *error)
+{
+    std::string why;
+    if (!m_segment.open(name.toStdString(), Hardware::Shared::kDefaultCapacity, &why)) {
+        if (error) *error = QString::fromStdString(why);
+        return false;
+    }
+    // Without uevents (some containers) the poll still catches changes.
+    m_uevents->open();
+    m_poll->start();
+    refresh();
+    return true;
+}
+
+void SnapshotPublisher::stop()
+{
+    m_poll->stop();
+    m_uevents->close();
+    m_segment.close();
+}
+
+void SnapshotPublisher::refresh()
+{
+    if (!m_segment.isOpen()) return;
+    // A hotplug mid-run may not be in this one's results.
+    if (m_watcher->isRunning()) {
+        m_again = true;
+        return;
+    }
+
+    m_watcher->setFuture(QtConcurrent::run([]() {
+        ATS_TRACE_SPAN("SnapshotPublisher::probe", "probe");
+        Hardware::ProbeLimits limits;
+        limits.deadline = QDeadlineTimer(kProbeDeadlineMs);
+        Hardware::setProbeLimits(limits);
+        Probed probed;
+        probed.snapshot = Hardware::probeAll();
+        probed.complete = !Hardware::probeLimitReached();
+        Hardware::clearProbeLimits();
+        return probed;
+    }));
+}
+
+void SnapshotPublisher::probed()
+{
+    if (!m_segment.isOpen()) return;
+
+    // A probe cut short by the deadline would be served to every reader as
+    // this machine's facts; keep what's there (or nothing) and let the next
+    // refresh try again, as ProbeEngine does for the disk cache.
+    const Probed probed = m_watcher->result();
+    QByteArray bytes;
+    if (probed.complete) {
+        Hardware::Binary::Writer writer;
+        writer.add(QSysInfo::machineHostName(), probed.snapshot);
+        bytes = writer.toByteArray();
+    }
+    if (!bytes.isEmpty() && bytes != m_last && m_segment.publish(bytes.constData(), size_t(bytes.size()))) {
+        m_last = bytes;
+        ++m_published;
+        emit published(m_segment.sequence());
+    }
+
+    if (m_again) {
+        m_again = false;
+        refresh();
+    }
+}
+
+namespace Hardware {
+namespace Shared {
+
+bool readSnapshot(Snapshot &snapshot, const QString &name) {
+    Subscriber subscriber;
+    if (!subscriber.open(name.toStdString())) return false;
+
+    std::vector<char> bytes;
+    Binary::Reader reader;
+    if (!subscriber.read(&bytes) || !reader.openBuffer(bytes.data(), bytes.size())) return false;
+    if (reader.hosts().empty()) return false;
+    snapshot = Binary::toSnapshot(reader, reader.hosts()[0]);
+    return true;
+}
+
+}
+}
@@ -0,0 +1,77 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef SNAPSHOTPUBLISHER_H
+#define SNAPSHOTPUBLISHER_H
+
+#include "hardware.h"
+#include "sharedsnapshot.h"
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+
+class QTimer;
+class UEventMonitor;
+template <typename T> class QFutureWatcher;
+
+// The resident side of --publish: runs every probe, writes the result into
+// the shared segment (sharedsnapshot.h) as a binary snapshot, and does it
+// again whenever a hotplug event says something changed, plus a slow poll
+// for what has no event (an OS upgrade). A refresh that comes out
+// byte-identical isn't published, so readers polling sequence() only ever
+// see real changes.
+class SnapshotPublisher : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int kPollMs = 5 * 60 * 1000;
+
+    explicit SnapshotPublisher(QObject *parent = nullptr);
+    ~SnapshotPublisher();
+
+    // Opens the segment (failing if another publisher has it) and starts the
+    // first probe run. The segment stays unpublished until that lands.
+    bool start(const QString &name = QString::fromLatin1(Hardware::Shared::kDefaultName),
+               QString *error = nullptr);
+    void stop();
+
+    int publishCount() const { return m_published; }
+
+public slots:
+    void refresh();
+
+signals:
+    void published(quint64 sequence);
+
+private:
+    struct Probed {
+        Hardware::Snapshot snapshot;
+        bool complete = false;      // no probe hit the deadline
+    };
+
+    void probed();
+
+    Hardware::Shared::Publisher m_segment;
+    UEventMonitor *m_uevents;
+    QTimer *m_poll;
+    QFutureWatcher<Probed> *m_watcher;
+    QByteArray m_last;
+    bool m_again = false;
+    int m_published = 0;
+};
+
+namespace Hardware {
+namespace Shared {
+
+// One-shot client: maps the segment, copies out the current snapshot and
+// decodes it. False if nobody is publishing. Startup disk and volumes come
+// back empty, as with any binary snapshot.
+bool readSnapshot(Snapshot &snapshot, const QString &name = QString::fromLatin1(kDefaultName));
+
+}
+}
+
+#endif // SNAPSHOTPUBLISHER_H
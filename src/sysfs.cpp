@@ -0,0 +1,163 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "sysfs.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Hardware {
+namespace SysFs {
+
+namespace {
+
+std::string &rootStorage() {
+    static std::string r;
+    return r;
+}
+
+thread_local const std::string *t_root = nullptr;
+
+std::string normalizedRoot(const std::string &root) {
+    std::string r = root;
+    while (r.size() > 1 && r.back() == '/') r.pop_back();
+    if (r == "/") r.clear();
+    return r;
+}
+
+}
+
+void setRoot(const std::string &root) {
+    rootStorage() = normalizedRoot(root);
+}
+
+const std::string &root() {
+    return t_root ? *t_root : rootStorage();
+}
+
+std::string resolve(const std::string &path) {
+    const std::string &r = root();
+    if (r.empty()) return path;
+    return r + path;
+}
+
+ScopedThreadRoot::ScopedThreadRoot(const std::string &root)
+    : m_root(normalizedRoot(root))
+    , m_previous(t_root)
+{
+    t_root = &m_root;
+}
+
+ScopedThreadRoot::~ScopedThreadRoot()
+{
+    t_root = m_previous;
+}
+
+bool readFile(const std::string &path, std::string &out, size_t maxBytes) {
+    out.clear();
+    int fd = ::open(resolve(path).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    // Most sysfs attributes fit in one page, so start there and grow if needed.
+    size_t chunk = 4096;
+    while (out.size() < maxBytes) {
+        size_t old = out.size();
+        size_t want = std::min(chunk, maxBytes - old);
+        out.resize(old + want);
+        ssize_t n = ::read(fd, &out[old], want);
+        if (n < 0 && errno == EINTR) {
+            out.resize(old);
+            continue;
+        }
+        if (n <= 0) {
+            out.resize(old);
+            break;
+        }
+        out.resize(old + size_t(n));
+        if (chunk < 65536) chunk *= 2;
+    }
+    ::close(fd);
+    return true;
+}
+
+bool readLong(const std::string &path, long long &value) {
+    char buf[32];
+    int fd = ::open(resolve(path).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    ssize_t n = ::read(fd, buf, sizeof(buf) - 1);
+    ::close(fd);
+    if (n <= 0) return false;
+    buf[n] = '\0';
+
+    char *end = nullptr;
+    errno = 0;
+    long long v = std::strtoll(buf, &end, 10);
+    if (end == buf || errno != 0) return false;
+    value = v;
+    return true;
+}
+
+bool readLine(const std::string &path, std::string &value) {
+    if (!readFile(path, value, 4096)) return false;
+    size_t nl = value.find('\n');
+    if (nl != std::string::npos) value.resize(nl);
+    while (!value.empty() && (value.back() == ' ' || value.back() == '\t' || value.back() == '\r'))
+        value.pop_back();
+    return true;
+}
+
+std::vector<std::string> listNumbered(const std::string &dir, const char *prefix) {
+    std::vector<std::string> names;
+    DIR *d = ::opendir(resolve(dir).c_str());
+    if (!d) return names;
+
+    const size_t plen = std::strlen(prefix);
+    while (dirent *e = ::readdir(d)) {
+        const char *name = e->d_name;
+        if (std::strncmp(name, prefix, plen) != 0) continue;
+        const char *p = name + plen;
+        if (*p == '\0') continue;
+        bool digits = true;
+        for (; *p; ++p) {
+            if (*p < '0' || *p > '9') {
+                digits = false;
+                break;
+            }
+        }
+        if (digits) names.emplace_back(name);
+    }
+    ::closedir(d);
+
+    std::sort(names.begin(), names.end(), [plen](const std::string &a, const std::string &b) {
+        if (a.size() != b.size()) return a.size() < b.size();
+        return a.compare(plen, std::string::npos, b, plen, std::string::npos) < 0;
+    });
+    return names;
+}
+
+std::vector<std::string> listDir(const std::string &dir) {
+    std::vector<std::string> names;
+    DIR *d = ::opendir(resolve(dir).c_str());
+    if (!d) return names;
+    while (dirent *e = ::readdir(d)) {
+        if (std::strcmp(e->d_name, ".") == 0 || std::strcmp(e->d_name, "..") == 0) continue;
+        names.emplace_back(e->d_name);
+    }
+    ::closedir(d);
+    return names;
+}
+
+bool exists(const std::string &path) {
+    struct stat st;
+    return ::stat(resolve(path).c_str(), &st) == 0;
+}
+
+}
+}
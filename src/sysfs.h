@@ -0,0 +1,89 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef SYSFS_H
+#define SYSFS_H
+
+#include <string>
+#include <vector>
+
+// Small, allocation-light helpers for reading /proc and /sys directly.
+// Deliberately Qt-free: these sit on the hot path of every native probe and
+// are called hundreds of times on big machines.
+namespace Hardware {
+namespace SysFs {
+
+// Every path below is taken as absolute on the probed system and resolved
+// against this root first. Empty (the default) means the live machine; a
+// captured tree ("/srv/fixtures/host42") makes probes reproducible. Set it
+// before probing starts; it is not meant to change while probes run.
+void setRoot(const std::string &root);
+const std::string &root();
+std::string resolve(const std::string &path);
+
+// Overrides the root for the calling thread only, for the lifetime of the
+// object. This is how batch mode probes many captured trees at once, one per
+// worker thread, without them seeing each other's files.
+class ScopedThreadRoot
+{
+public:
+    explicit ScopedThreadRoot(const std::string &root);
+    ~ScopedThreadRoot();
+
+    ScopedThreadRoot(const ScopedThreadRoot &) = delete;
+    ScopedThreadRoot &operator=(const ScopedThreadRoot &) = delete;
+
+private:
+    std::string m_root;
+    const std::string *m_previous;
+};
+
+// Reads up to maxBytes of a file into out. Returns false if it can't be opened.
+// pseudo-files report st_size 0, so this just reads until EOF.
+bool readFile(const std::string &path, std::string &out, size_t maxBytes = 1 << 20);
+
+// Reads a file holding a single integer (sysfs style, trailing newline ok).
+bool readLong(const std::string &path, long long &value);
+
+// Reads a one-line sysfs attribute with the trailing whitespace stripped.
+bool readLine(const std::string &path, std::string &value);
+
+// Lists directory entries whose name is prefix followed only by digits,
+// e.g. "cpu0".."cpu255" but not "cpufreq". Returned in numeric order.
+std::vector<std::string> listNumbered(const std::string &dir, const char *prefix);
+
+// Lists all directory entries (minus "." and ".."), unsorted.
+std::vector<std::string> listDir(const std::string &dir);
+
+bool exists(const std::string &path);
+
+// Batched reads, for when a probe needs thousands of small attributes at
+// once (every CPU's topology and caches on a 384-thread box). Paths go
+// through resolve() like everything else.
+struct BatchRead {
+    std::string path;
+    std::string data;           // up to maxBytes, as read
+    bool ok = false;            // opened and read without error
+};
+
+enum class BatchMode {
+    Auto,       // io_uring where the kernel allows it, else Pread
+    Uring,      // opens, reads and closes queued on an io_uring, a ring at a time
+    Pread       // open/pread/close per file
+};
+
+// Process-wide, like setRoot(); benchmarks use it to compare the two paths.
+void setBatchMode(BatchMode mode);
+BatchMode batchMode();
+
+// Reads every file in one go. With io_uring each ringful of files costs three
+// submissions (opens, reads, closes) rather than three syscalls a file.
+// Returns the path actually taken: "io_uring" or "pread".
+const char *readBatch(std::vector<BatchRead> &files, size_t maxBytes = 4096);
+
+}
+}
+
+#endif // SYSFS_H
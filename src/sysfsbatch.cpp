@@ -0,0 +1,236 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "sysfs.h"
+#include "uring.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <memory>
+#include <unistd.h>
+
+namespace Hardware {
+namespace SysFs {
+
+namespace {
+
+// Files per round trip. Enough that a 384-CPU box needs a few dozen
+// submissions; the read arena is this many maxBytes slots, 1 MiB at the
+// default 4 KiB.
+const unsigned kRingEntries = 256;
+
+// What a completion belongs to, in the top half of user_data; the slot is
+// in the bottom half.
+enum Op : uint64_t { OpOpen = 1, OpRead, OpClose };
+
+// How a round trip ended. Failed leaves nothing in flight, but the ring may
+// hold unsubmitted SQEs and mustn't be used again. Stranded means ops may
+// still complete later, into whatever memory they were given.
+enum class Trip { Done, Failed, Stranded };
+
+std::atomic<BatchMode> g_mode{ BatchMode::Auto };
+
+// One ring per thread, kept: batch mode probes a tree per worker, and
+// io_uring_setup plus its three mmaps would otherwise dominate small batches.
+// A null ring after a failed open means "don't try again on this thread".
+struct ThreadRing {
+    std::unique_ptr<Native::Uring> ring;
+    bool tried = false;
+};
+thread_local ThreadRing t_ring;
+
+Native::Uring *threadRing() {
+    if (!t_ring.tried) {
+        t_ring.tried = true;
+        t_ring.ring.reset(new Native::Uring);
+        if (!t_ring.ring->open(kRingEntries)) t_ring.ring.reset();
+    }
+    return t_ring.ring.get();
+}
+
+void readOne(BatchRead &file, size_t maxBytes) {
+    file.data.clear();
+    file.ok = false;
+    const int fd = ::open(resolve(file.path).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    file.data.resize(maxBytes);
+    ssize_t n;
+    do {
+        n = ::pread(fd, &file.data[0], maxBytes, 0);
+    } while (n < 0 && errno == EINTR);
+    ::close(fd);
+    file.data.resize(n > 0 ? size_t(n) : 0);
+    file.ok = n >= 0;
+}
+
+const char *readSequential(std::vector<BatchRead> &files, size_t maxBytes) {
+    for (BatchRead &file : files) readOne(file, maxBytes);
+    return "pread";
+}
+
+// Queues one op per slot, submits them together and waits for them all.
+// The fill callback returns false to leave a slot out. If waiting fails,
+// keeps collecting for a while, since the ops own their buffers until they
+// complete.
+template <typename Fill, typename Done>
+Trip roundTrip(Native::Uring &ring, Op op, size_t count, Fill &&fill, Done &&done) {
+    unsigned queued = 0;
+    for (size_t i = 0; i < count; ++i) {
+        io_uring_sqe *sqe = ring.prepare();
+        if (!sqe) return Trip::Failed; // nothing published yet
+        if (!fill(i, *sqe)) sqe->opcode = IORING_OP_NOP;
+        sqe->user_data = uint64_t(op) << 32 | uint64_t(i);
+        ++queued;
+    }
+    if (queued == 0) return Trip::Done;
+
+    bool failed = !ring.submit(queued);
+    int waitFailures = 0;
+    unsigned reaped = 0;
+    for (;;) {
+        reaped += ring.reap([&](const io_uring_cqe &cqe) {
+            if (cqe.user_data >> 32 != op) return;
+            done(size_t(cqe.user_data & 0xffffffffu), cqe.res);
+        });
+        if (reaped >= queued) return failed ? Trip::Failed : Trip::Done;
+        if (ring.submit(queued - reaped)) continue;
+        failed = true;
+        if (++waitFailures >= 100) return Trip::Stranded;
+        usleep(1000);
+    }
+}
+
+// Opens, reads and closes of up to a ringful of files, as three submissions.
+// False if the kernel can't do it (OPENAT and READ arrived in 5.6), with no
+// file marked ok; the caller then falls back for the lot. *stranded is set
+// if ops may still be in flight, and then paths and arena must never be
+// freed.
+bool readChunk(Native::Uring &ring, BatchRead *files, size_t count, size_t maxBytes,
+               std::vector<std::string> &paths, std::vector<int> &fds, std::vector<char> &arena,
+               bool *stranded) {
+    paths.resize(count);
+    fds.assign(count, -1);
+    arena.resize(count * maxBytes);
+    for (size_t i = 0; i < count; ++i) paths[i] = resolve(files[i].path);
+
+    bool unsupported = false;
+    Trip trip = roundTrip(ring, OpOpen, count,
+        [&](size_t i, io_uring_sqe &sqe) {
+            sqe.opcode = IORING_OP_OPENAT;
+            sqe.fd = AT_FDCWD;
+            sqe.addr = reinterpret_cast<uint64_t>(paths[i].c_str());
+            sqe.open_flags = O_RDONLY | O_CLOEXEC;
+            return true;
+        },
+        [&](size_t i, int res) {
+            if (res >= 0) fds[i] = res;
+            else if (res == -EINVAL || res == -EOPNOTSUPP) unsupported = true;
+        });
+
+    if (trip == Trip::Done && !unsupported) {
+        trip = roundTrip(ring, OpRead, count,
+            [&](size_t i, io_uring_sqe &sqe) {
+                if (fds[i] < 0) return false;
+                sqe.opcode = IORING_OP_READ;
+                sqe.fd = fds[i];
+                sqe.addr = reinterpret_cast<uint64_t>(&arena[i * maxBytes]);
+                sqe.len = unsigned(maxBytes);
+                sqe.off = 0;
+                return true;
+            },
+            [&](size_t i, int res) {
+                if (fds[i] < 0) return;
+                if (res == -EINVAL || res == -EOPNOTSUPP) {
+                    unsupported = true;
+                    return;
+                }
+                files[i].ok = res >= 0;
+                files[i].data.assign(&arena[i * maxBytes], res > 0 ? size_t(res) : 0);
+            });
+    }
+
+    // Closing has to happen whatever went wrong above; plain close() for
+    // anything the ring didn't get to. A CLOSE still in flight may run
+    // later, when the number could belong to someone else's file, so those
+    // are leaked instead. Plain-closing under a stranded READ is fine: the
+    // request holds its own reference to the file.
+    std::vector<bool> pending(count, false);
+    if (trip == Trip::Done) {
+        trip = roundTrip(ring, OpClose, count,
+            [&](size_t i, io_uring_sqe &sqe) {
+                if (fds[i] < 0) return false;
+                sqe.opcode = IORING_OP_CLOSE;
+                sqe.fd = fds[i];
+                pending[i] = true;
+                return true;
+            },
+            [&](size_t i, int res) {
+                pending[i] = false;
+                if (res >= 0) fds[i] = -1;
+            });
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (fds[i] >= 0 && !(trip == Trip::Stranded && pending[i])) ::close(fds[i]);
+        fds[i] = -1;
+    }
+
+    if (trip == Trip::Stranded) *stranded = true;
+    if (trip != Trip::Done || unsupported) {
+        for (size_t i = 0; i < count; ++i) files[i].ok = false;
+        return false;
+    }
+    return true;
+}
+
+}
+
+void setBatchMode(BatchMode mode) {
+    g_mode = mode;
+}
+
+BatchMode batchMode() {
+    return g_mode;
+}
+
+const char *readBatch(std::vector<BatchRead> &files, size_t maxBytes) {
+    for (BatchRead &file : files) {
+        file.data.clear();
+        file.ok = false;
+    }
+    if (files.empty() || maxBytes == 0) return "pread";
+
+    const BatchMode mode = g_mode;
+    Native::Uring *ring = mode == BatchMode::Pread ? nullptr : threadRing();
+    if (!ring) return readSequential(files, maxBytes);
+
+    std::vector<std::string> paths;
+    std::vector<int> fds;
+    std::vector<char> arena;
+    const size_t step = ring->entries();
+    for (size_t first = 0; first < files.size(); first += step) {
+        const size_t count = std::min(step, files.size() - first);
+        bool stranded = false;
+        if (readChunk(*ring, &files[first], count, maxBytes, paths, fds, arena, &stranded)) continue;
+
+        // Closing a ring doesn't wait for its ops, so whatever a stranded
+        // one might still write into (or read a path from) is leaked. Moving
+        // a vector keeps its buffer where it is.
+        if (stranded) {
+            new std::vector<std::string>(std::move(paths));
+            new std::vector<char>(std::move(arena));
+        }
+
+        // Old kernel, or the ring broke: finish with pread, and don't use
+        // this thread's ring again.
+        t_ring.ring.reset();
+        for (size_t i = first; i < files.size(); ++i) readOne(files[i], maxBytes);
+        return "pread";
+    }
+    return "io_uring";
+}
+
+}
+}
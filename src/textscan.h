@@ -0,0 +1,152 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef TEXTSCAN_H
+#define TEXTSCAN_H
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+// Tokenizing for /proc, sysfs and tool output, straight off one byte buffer.
+// Everything hands out std::string_view slices of the caller's buffer, so a
+// parse makes no heap allocations until the caller decides to keep a value.
+// Qt-free, like sysfs.h.
+namespace Hardware {
+namespace Text {
+
+inline bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+inline std::string_view trimmed(std::string_view s) {
+    size_t b = 0, e = s.size();
+    while (b < e && isSpace(s[b])) ++b;
+    while (e > b && isSpace(s[e - 1])) --e;
+    return s.substr(b, e - b);
+}
+
+inline bool startsWith(std::string_view s, std::string_view prefix) {
+    return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+}
+
+inline bool contains(std::string_view s, std::string_view needle) {
+    return s.find(needle) != std::string_view::npos;
+}
+
+// Splits "Key<sep> value" at the first sep; both halves trimmed.
+inline bool splitKeyValue(std::string_view line, char sep, std::string_view &key, std::string_view &value) {
+    const size_t at = line.find(sep);
+    if (at == std::string_view::npos) return false;
+    key = trimmed(line.substr(0, at));
+    value = trimmed(line.substr(at + 1));
+    return true;
+}
+
+// Value of "Key<sep> value" when the line's key is exactly key.
+inline bool valueFor(std::string_view line, std::string_view key, char sep, std::string_view &value) {
+    if (!startsWith(line, key)) return false;
+    std::string_view rest = line.substr(key.size());
+    size_t i = 0;
+    while (i < rest.size() && (rest[i] == ' ' || rest[i] == '\t')) ++i;
+    if (i == rest.size() || rest[i] != sep) return false;
+    value = trimmed(rest.substr(i + 1));
+    return true;
+}
+
+// Leading integer of s (after whitespace), e.g. "16318412 kB" -> 16318412.
+inline bool toLong(std::string_view s, long long &value) {
+    s = trimmed(s);
+    const std::from_chars_result r = std::from_chars(s.data(), s.data() + s.size(), value);
+    return r.ec == std::errc() && r.ptr != s.data();
+}
+
+// Leading decimal number of s. from_chars for doubles isn't everywhere we
+// build yet, so this copies into a stack buffer for strtod; anything longer
+// than a number plausibly is doesn't parse.
+inline bool toDouble(std::string_view s, double &value) {
+    s = trimmed(s);
+    char buf[64];
+    if (s.empty() || s.size() >= sizeof(buf)) return false;
+    std::memcpy(buf, s.data(), s.size());
+    buf[s.size()] = '\0';
+    char *end = nullptr;
+    value = std::strtod(buf, &end);
+    return end != buf;
+}
+
+// Calls f(first, last) for each range of a sysfs CPU list, "0-95,192-287"
+// or "3". Malformed pieces are skipped.
+template <typename F>
+inline void forEachRange(std::string_view list, F &&f) {
+    while (!list.empty()) {
+        const size_t comma = list.find(',');
+        const std::string_view range = trimmed(list.substr(0, comma));
+        list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+
+        long long first = 0, last = 0;
+        const size_t dash = range.find('-');
+        if (!toLong(range.substr(0, dash), first)) continue;
+        last = first;
+        if (dash != std::string_view::npos && !toLong(range.substr(dash + 1), last)) continue;
+        if (last >= first) f(first, last);
+    }
+}
+
+// "0-3,8-11" -> 8
+inline int countList(std::string_view list) {
+    int count = 0;
+    forEachRange(list, [&count](long long first, long long last) { count += int(last - first + 1); });
+    return count;
+}
+
+// Walks a buffer one line at a time, without the '\n'.
+class LineReader
+{
+public:
+    explicit LineReader(std::string_view text) : m_text(text) {}
+
+    bool next(std::string_view &line) {
+        if (m_pos >= m_text.size()) return false;
+        size_t eol = m_text.find('\n', m_pos);
+        if (eol == std::string_view::npos) eol = m_text.size();
+        line = m_text.substr(m_pos, eol - m_pos);
+        m_pos = eol + 1;
+        return true;
+    }
+
+private:
+    std::string_view m_text;
+    size_t m_pos = 0;
+};
+
+// Walks blank-line separated blocks, as printed by lspci -vmm.
+class BlockReader
+{
+public:
+    explicit BlockReader(std::string_view text) : m_text(text) {}
+
+    bool next(std::string_view &block) {
+        // skip leading blank lines
+        while (m_pos < m_text.size() && m_text[m_pos] == '\n') ++m_pos;
+        if (m_pos >= m_text.size()) return false;
+
+        size_t end = m_text.find("\n\n", m_pos);
+        if (end == std::string_view::npos) end = m_text.size();
+        block = m_text.substr(m_pos, end - m_pos);
+        m_pos = end;
+        return true;
+    }
+
+private:
+    std::string_view m_text;
+    size_t m_pos = 0;
+};
+
+}
+}
+
+#endif // TEXTSCAN_H
@@ -0,0 +1,135 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "hardware_p.h"
+#include "textscan.h"
+
+namespace Hardware {
+namespace Native {
+
+namespace {
+
+int toIntOrZero(std::string_view s) {
+    long long v = 0;
+    return Text::toLong(s, v) ? int(v) : 0;
+}
+
+std::string_view unquoted(std::string_view v) {
+    if (v.size() >= 2 && (v.front() == '"' || v.front() == '\'') && v.back() == v.front()) {
+        return v.substr(1, v.size() - 2);
+    }
+    return v;
+}
+
+}
+
+void parseLscpu(std::string_view text, LscpuFacts &facts) {
+    facts = LscpuFacts();
+
+    Text::LineReader lines(text);
+    std::string_view line, value;
+    while (lines.next(line)) {
+        if (Text::valueFor(line, "Model name", ':', value)) {
+            facts.modelName = value;
+        } else if (Text::valueFor(line, "Core(s) per socket", ':', value)) {
+            facts.coresPerSocket = toIntOrZero(value);
+        } else if (Text::valueFor(line, "Socket(s)", ':', value)) {
+            facts.sockets = toIntOrZero(value);
+        } else if (Text::valueFor(line, "CPU max MHz", ':', value)) {
+            // Some distros have CPU max MHz
+            double mhz = 0.0;
+            if (Text::toDouble(value, mhz) && mhz > 0) facts.maxMhz = mhz;
+        }
+    }
+}
+
+bool parseLspciGraphics(std::string_view text, LspciDevice &gpu) {
+    // Blocks separated by empty lines:
+    // Class: VGA compatible controller
+    // Vendor: ...
+    // Device: ...
+    Text::BlockReader blocks(text);
+    std::string_view block;
+    while (blocks.next(block)) {
+        if (!Text::contains(block, "VGA compatible controller") && !Text::contains(block, "3D controller")) continue;
+
+        LspciDevice found;
+        Text::LineReader lines(block);
+        std::string_view line, value;
+        while (lines.next(line)) {
+            if (Text::valueFor(line, "Vendor", ':', value)) found.vendor = value;
+            else if (Text::valueFor(line, "Device", ':', value)) found.device = value;
+        }
+        if (!found.vendor.empty() && !found.device.empty()) {
+            gpu = found;
+            return true;
+        }
+    }
+    return false;
+}
+
+void parseOsRelease(std::string_view text, OsReleaseFacts &facts) {
+    facts = OsReleaseFacts();
+
+    // VERSION="1.0 Canora (Beta 2)"
+    Text::LineReader lines(text);
+    std::string_view line, key, value;
+    while (lines.next(line)) {
+        if (!Text::splitKeyValue(line, '=', key, value)) continue;
+        value = unquoted(value);
+        if (key == "VERSION") facts.version = value;
+        else if (key == "VERSION_ID") facts.versionId = value;
+        else if (key == "NAME") facts.name = value;
+        else if (key == "PRETTY_NAME") facts.prettyName = value;
+    }
+}
+
+bool parseMountInfoLine(std::string_view line, MountEntry &entry) {
+    // 36 35 98:0 /mnt1 /mnt/parent rw,noatime master:1 - ext3 /dev/root rw,errors=continue
+    // id, parent, dev, root, mount point, options, optional fields..., "-",
+    // fs type, source, super options
+    int index = 0;
+    int afterSeparator = -1;
+    size_t pos = 0;
+    while (pos < line.size()) {
+        size_t end = line.find(' ', pos);
+        if (end == std::string_view::npos) end = line.size();
+        const std::string_view field = line.substr(pos, end - pos);
+        pos = end + 1;
+        if (field.empty()) continue;
+
+        if (afterSeparator < 0) {
+            if (index == 2) entry.majorMinor = field;
+            else if (index == 4) entry.mountPoint = field;
+            else if (index > 5 && field == "-") afterSeparator = 0;
+            ++index;
+        } else {
+            if (afterSeparator == 0) entry.fileSystem = field;
+            else if (afterSeparator == 1) entry.source = field;
+            if (++afterSeparator == 2) return true;
+        }
+    }
+    return false;
+}
+
+double ghzFromModelName(std::string_view model) {
+    // "@\s*([0-9.]+)\s*GHz"
+    for (size_t at = model.find('@'); at != std::string_view::npos; at = model.find('@', at + 1)) {
+        size_t i = at + 1;
+        while (i < model.size() && Text::isSpace(model[i])) ++i;
+        const size_t numBegin = i;
+        while (i < model.size() && ((model[i] >= '0' && model[i] <= '9') || model[i] == '.')) ++i;
+        const size_t numEnd = i;
+        while (i < model.size() && Text::isSpace(model[i])) ++i;
+        if (numEnd == numBegin || model.compare(i, 3, "GHz") != 0) continue;
+
+        double ghz = 0.0;
+        if (Text::toDouble(model.substr(numBegin, numEnd - numBegin), ghz)) return ghz;
+    }
+    return 0.0;
+}
+
+}
+}
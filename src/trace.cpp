@@ -0,0 +1,155 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "trace.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+namespace Trace {
+
+std::atomic<bool> g_enabled{false};
+
+namespace {
+
+struct Event {
+    const char *name;
+    const char *category;
+    uint64_t startNs;
+    uint64_t endNs;
+    char detail[48];
+};
+
+// One per thread that ever recorded a span. Only the owning thread writes
+// events and bumps count (release); flush() reads count (acquire) and the
+// events below it. Full buffers drop new spans rather than wrap, so a reader
+// never sees an event being overwritten.
+struct ThreadBuffer {
+    static const size_t kCapacity = 8192;
+
+    long tid = 0;
+    std::atomic<size_t> count{0};
+    Event events[kCapacity];
+};
+
+std::mutex g_registryLock;
+std::vector<ThreadBuffer *> g_buffers;     // never freed: threads may still be writing
+std::string g_path;
+
+thread_local ThreadBuffer *t_buffer = nullptr;
+
+ThreadBuffer *threadBuffer() {
+    if (!t_buffer) {
+        ThreadBuffer *b = new ThreadBuffer;
+        b->tid = long(::syscall(SYS_gettid));
+        std::lock_guard<std::mutex> guard(g_registryLock);
+        g_buffers.push_back(b);
+        t_buffer = b;
+    }
+    return t_buffer;
+}
+
+void writeJsonString(FILE *f, const char *s) {
+    std::fputc('"', f);
+    for (; *s; ++s) {
+        const unsigned char c = static_cast<unsigned char>(*s);
+        if (c == '"' || c == '\\') {
+            std::fputc('\\', f);
+            std::fputc(c, f);
+        } else if (c < 0x20) {
+            std::fprintf(f, "\\u%04x", c);
+        } else {
+            std::fputc(c, f);
+        }
+    }
+    std::fputc('"', f);
+}
+
+}
+
+uint64_t nowNs() {
+    timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+void enable(const std::string &path) {
+    {
+        std::lock_guard<std::mutex> guard(g_registryLock);
+        g_path = path;
+    }
+    g_enabled.store(!path.empty(), std::memory_order_relaxed);
+}
+
+void enableFromEnvironment(int argc, char *argv[]) {
+    std::string path;
+    if (const char *env = std::getenv("ABOUTTHISSYN_TRACE")) path = env;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--trace=", 8) == 0) path = argv[i] + 8;
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) path = argv[++i];
+    }
+    if (!path.empty()) enable(path);
+}
+
+void record(const char *name, const char *category, uint64_t startNs, uint64_t endNs, const char *detail) {
+    ThreadBuffer *b = threadBuffer();
+    const size_t n = b->count.load(std::memory_order_relaxed);
+    if (n >= ThreadBuffer::kCapacity) return;
+
+    Event &e = b->events[n];
+    e.name = name;
+    e.category = category;
+    e.startNs = startNs;
+    e.endNs = endNs;
+    e.detail[0] = '\0';
+    if (detail) {
+        std::strncpy(e.detail, detail, sizeof(e.detail) - 1);
+        e.detail[sizeof(e.detail) - 1] = '\0';
+    }
+    b->count.store(n + 1, std::memory_order_release);
+}
+
+bool flush() {
+    std::lock_guard<std::mutex> guard(g_registryLock);
+    if (g_path.empty()) return false;
+
+    FILE *f = std::fopen(g_path.c_str(), "w");
+    if (!f) return false;
+
+    const long pid = long(::getpid());
+    bool first = true;
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", f);
+    for (ThreadBuffer *b : g_buffers) {
+        const size_t n = b->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; ++i) {
+            const Event &e = b->events[i];
+            if (!first) std::fputs(",\n", f);
+            first = false;
+
+            // Chrome wants microseconds; keep the nanoseconds as decimals.
+            std::fputs("{\"name\":", f);
+            writeJsonString(f, e.name);
+            std::fputs(",\"cat\":", f);
+            writeJsonString(f, e.category);
+            std::fprintf(f, ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%ld,\"tid\":%ld",
+                         e.startNs / 1000.0, (e.endNs - e.startNs) / 1000.0, pid, b->tid);
+            if (e.detail[0]) {
+                std::fputs(",\"args\":{\"detail\":", f);
+                writeJsonString(f, e.detail);
+                std::fputc('}', f);
+            }
+            std::fputc('}', f);
+        }
+    }
+    std::fputs("\n]}\n", f);
+    return std::fclose(f) == 0;
+}
+
+}
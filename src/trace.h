@@ -0,0 +1,97 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Lightweight tracing for "why is About This Computer slow to open?" reports.
+//
+// Spans are recorded with nanosecond timestamps into a per-thread buffer that
+// only its own thread writes to, so recording takes no locks. When tracing is
+// off a span costs one relaxed atomic load; with MS_TRACING=OFF the macros
+// compile away entirely. Turn it on with ABOUTTHISSYN_TRACE=file.json or
+// --trace=file.json, then load the file in chrome://tracing or Perfetto.
+namespace Trace {
+
+extern std::atomic<bool> g_enabled;
+
+inline bool isEnabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+// Starts recording; the trace is written to path by flush().
+void enable(const std::string &path);
+
+// Checks ABOUTTHISSYN_TRACE and argv for --trace=<file> or --trace <file>
+// (both forms QCommandLineParser accepts) and enables tracing if either is
+// present. Call first thing in main().
+void enableFromEnvironment(int argc, char *argv[]);
+
+// Writes everything recorded so far as Chrome trace-event JSON. Safe to call
+// while other threads are still recording; their newer spans are just left out.
+bool flush();
+
+uint64_t nowNs();
+
+void record(const char *name, const char *category, uint64_t startNs, uint64_t endNs, const char *detail);
+
+// RAII span. name and category must be string literals (only the pointer is
+// kept); detail is copied, truncated to a few dozen bytes when recorded.
+class Span
+{
+public:
+    explicit Span(const char *name, const char *category = "app")
+        : m_name(isEnabled() ? name : nullptr), m_category(category)
+    {
+        if (m_name) m_start = nowNs();
+    }
+
+    bool isActive() const { return m_name != nullptr; }
+    void setDetail(const std::string &detail) { m_detail = detail; }
+
+    ~Span() { end(); }
+
+    // Closes the span early, for blocks that aren't their own scope.
+    void end() {
+        if (m_name) record(m_name, m_category, m_start, nowNs(), m_detail.empty() ? nullptr : m_detail.c_str());
+        m_name = nullptr;
+    }
+
+    Span(const Span &) = delete;
+    Span &operator=(const Span &) = delete;
+
+private:
+    const char *m_name;
+    const char *m_category;
+    uint64_t m_start = 0;
+    std::string m_detail;
+};
+
+}
+
+#define ATS_TRACE_CONCAT_(a, b) a##b
+#define ATS_TRACE_CONCAT(a, b) ATS_TRACE_CONCAT_(a, b)
+
+// ATS_TRACE_SPAN_DETAIL only evaluates its detail expression while tracing,
+// so building e.g. a tool's command line costs nothing otherwise.
+// ATS_TRACE_BEGIN/ATS_TRACE_END bracket a block by hand.
+#ifdef ATS_TRACING
+#define ATS_TRACE_BEGIN(var, ...) ::Trace::Span var(__VA_ARGS__)
+#define ATS_TRACE_END(var) var.end()
+#define ATS_TRACE_SPAN(...) ::Trace::Span ATS_TRACE_CONCAT(atsTraceSpan, __LINE__)(__VA_ARGS__)
+#define ATS_TRACE_SPAN_DETAIL(name, category, detail) \
+    ::Trace::Span ATS_TRACE_CONCAT(atsTraceSpan, __LINE__)(name, category); \
+    if (ATS_TRACE_CONCAT(atsTraceSpan, __LINE__).isActive()) \
+        ATS_TRACE_CONCAT(atsTraceSpan, __LINE__).setDetail(detail)
+#else
+#define ATS_TRACE_BEGIN(var, ...) do {} while (0)
+#define ATS_TRACE_END(var) do {} while (0)
+#define ATS_TRACE_SPAN(...) do {} while (0)
+#define ATS_TRACE_SPAN_DETAIL(name, category, detail) do {} while (0)
+#endif
+
+#endif // TRACE_H
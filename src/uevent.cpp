@@ -0,0 +1,147 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "uevent.h"
+#include "textscan.h"
+#include <initializer_list>
+
+namespace Hardware {
+namespace UEvent {
+
+namespace {
+
+// PCI base class 0x03: VGA, XGA, 3D and other display controllers.
+bool isDisplayClass(std::string_view pciClass) {
+    // PCI_CLASS is printed with %X, so 0x030000 arrives as "30000".
+    return pciClass.size() == 5 && pciClass[0] == '3';
+}
+
+bool isOneOf(std::string_view s, std::initializer_list<std::string_view> values) {
+    for (std::string_view v : values) {
+        if (s == v) return true;
+    }
+    return false;
+}
+
+// "KERNEL[1234.567890] add      /devices/pci0000:00/... (pci)"
+bool parseUdevadmHeader(std::string_view line, std::string &datagram) {
+    if (!Text::startsWith(line, "KERNEL[")) return false;
+    const size_t close = line.find(']');
+    if (close == std::string_view::npos) return false;
+    std::string_view rest = Text::trimmed(line.substr(close + 1));
+    const size_t space = rest.find(' ');
+    if (space == std::string_view::npos) return false;
+    const std::string_view action = rest.substr(0, space);
+    std::string_view devpath = Text::trimmed(rest.substr(space + 1));
+    const size_t paren = devpath.find(" (");
+    if (paren != std::string_view::npos) devpath = devpath.substr(0, paren);
+
+    datagram.assign(action);
+    datagram += '@';
+    datagram.append(devpath);
+    datagram += '\0';
+    return true;
+}
+
+}
+
+bool parse(std::string_view datagram, Event &event) {
+    event = Event();
+
+    // udev's own rebroadcasts start "libudev\0" and carry a binary header;
+    // we only listen to the kernel group, but a replay might include them.
+    if (Text::startsWith(datagram, std::string_view("libudev\0", 8))) return false;
+
+    size_t pos = 0;
+    bool first = true;
+    while (pos < datagram.size()) {
+        size_t end = datagram.find('\0', pos);
+        if (end == std::string_view::npos) end = datagram.size();
+        const std::string_view field = datagram.substr(pos, end - pos);
+        pos = end + 1;
+
+        if (first) {
+            // the "ACTION@DEVPATH" summary; the KEY=VALUE pairs repeat it
+            first = false;
+            const size_t at = field.find('@');
+            if (at == std::string_view::npos) return false;
+            event.action = field.substr(0, at);
+            event.devpath = field.substr(at + 1);
+            continue;
+        }
+
+        const size_t eq = field.find('=');
+        if (eq == std::string_view::npos) continue;
+        const std::string_view key = field.substr(0, eq);
+        const std::string_view value = field.substr(eq + 1);
+        if (key == "ACTION") event.action = value;
+        else if (key == "DEVPATH") event.devpath = value;
+        else if (key == "SUBSYSTEM") event.subsystem = value;
+        else if (key == "DEVTYPE") event.devtype = value;
+        else if (key == "PCI_CLASS") event.pciClass = value;
+    }
+    return !event.action.empty();
+}
+
+unsigned classify(const Event &e) {
+    if (e.subsystem == "pci") {
+        if (!isOneOf(e.action, { "add", "remove" })) return None;
+        // Without PCI_CLASS we can't tell, so assume it might be a GPU.
+        return e.pciClass.empty() || isDisplayClass(e.pciClass) ? Graphics : None;
+    }
+    if (e.subsystem == "block") {
+        return isOneOf(e.action, { "add", "remove", "change" }) ? Storage : None;
+    }
+    if (e.subsystem == "memory") {
+        return isOneOf(e.action, { "add", "remove", "online", "offline" }) ? Memory : None;
+    }
+    if (e.subsystem == "cpu") {
+        return isOneOf(e.action, { "add", "remove", "online", "offline" }) ? Processor : None;
+    }
+    return None;
+}
+
+std::vector<std::string> datagramsFromRecording(std::string_view text) {
+    std::vector<std::string> datagrams;
+    std::string current;
+    bool inBlock = false;
+
+    auto finish = [&]() {
+        if (inBlock) datagrams.push_back(current);
+        current.clear();
+        inBlock = false;
+    };
+
+    Text::LineReader lines(text);
+    std::string_view line;
+    while (lines.next(line)) {
+        line = Text::trimmed(line);
+        if (line.empty()) {
+            finish();
+            continue;
+        }
+        if (!inBlock) {
+            if (parseUdevadmHeader(line, current)) {
+                inBlock = true;
+            } else if (line.find('@') != std::string_view::npos && line.find('=') == std::string_view::npos
+                       && line.find(' ') == std::string_view::npos) {
+                current.assign(line);
+                current += '\0';
+                inBlock = true;
+            }
+            // anything else (udevadm's banner, UDEV[...] blocks) is skipped
+            // up to the next blank line
+            continue;
+        }
+        if (line.find('=') == std::string_view::npos) continue;
+        current.append(line);
+        current += '\0';
+    }
+    finish();
+    return datagrams;
+}
+
+}
+}
@@ -0,0 +1,52 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef UEVENT_H
+#define UEVENT_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Kernel uevents, as read from a NETLINK_KOBJECT_UEVENT socket, and which of
+// our probes each one makes stale. Qt-free, like sysfs.h; the socket itself
+// is handled by UEventMonitor.
+namespace Hardware {
+namespace UEvent {
+
+// One datagram: "ACTION@DEVPATH\0KEY=VALUE\0KEY=VALUE\0...". Views point into
+// the buffer it was parsed from.
+struct Event {
+    std::string_view action;        // add, remove, change, online, offline, bind, ...
+    std::string_view devpath;
+    std::string_view subsystem;
+    std::string_view devtype;       // "disk", "partition" for block
+    std::string_view pciClass;      // PCI_CLASS, hex without 0x ("30000")
+};
+
+bool parse(std::string_view datagram, Event &event);
+
+// What an event affects, as a bit mask.
+enum Target : unsigned {
+    None = 0,
+    Processor = 1u << 0,        // cpu online/offline
+    Memory = 1u << 1,           // memory block add/remove/online/offline
+    Graphics = 1u << 2,         // display-class PCI device add/remove
+    Storage = 1u << 3,          // block device add/remove/change
+    AllTargets = Processor | Memory | Graphics | Storage
+};
+
+unsigned classify(const Event &event);
+
+// Turns a recorded stream back into datagrams, for replaying through a
+// socketpair. Accepts `udevadm monitor --kernel --property` output as well as
+// blocks of "ACTION@DEVPATH" followed by KEY=VALUE lines; blocks are
+// separated by blank lines and anything else is skipped.
+std::vector<std::string> datagramsFromRecording(std::string_view text);
+
+}
+}
+
+#endif // UEVENT_H
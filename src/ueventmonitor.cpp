@@ -0,0 +1,185 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "ueventmonitor.h"
+#include "trace.h"
+#include "uevent.h"
+#include <QFile>
+#include <QSocketNotifier>
+#include <QTimer>
+#include <cerrno>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// Kernel uevents are at most a few KB (UEVENT_BUFFER_SIZE is 2048).
+const size_t kDatagramMax = 8192;
+
+// Hotplug storms (a JBOD powering up) shouldn't overflow the queue before
+// the event loop gets to it.
+const int kReceiveBuffer = 1 << 20;
+
+const struct {
+    unsigned target;
+    ProbeEngine::Probe probe;
+} kTargets[] = {
+    { Hardware::UEvent::Processor, ProbeEngine::Processor },
+    { Hardware::UEvent::Memory, ProbeEngine::Memory },
+    { Hardware::UEvent::Graphics, ProbeEngine::Graphics },
+    { Hardware::UEvent::Storage, ProbeEngine::StartupDisk },
+};
+
+}
+
+UEventMonitor::UEventMonitor(QObject *parent)
+    : QObject(parent)
+    , m_coalesce(new QTimer(this))
+{
+    m_coalesce->setSingleShot(true);
+    m_coalesce->setInterval(kCoalesceMs);
+    connect(m_coalesce, &QTimer::timeout, this, &UEventMonitor::flush);
+}
+
+UEventMonitor::~UEventMonitor()
+{
+    close();
+}
+
+bool UEventMonitor::open()
+{
+    close();
+    ATS_TRACE_SPAN("UEventMonitor::open", "app");
+
+    const int fd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (fd < 0) return false;
+
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &kReceiveBuffer, sizeof(kReceiveBuffer));
+
+    sockaddr_nl addr = {};
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = 1; // the kernel's own events, not udev's rebroadcasts
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    watch(fd, true);
+    return true;
+}
+
+bool UEventMonitor::openReplay(const QString &recordingPath)
+{
+    close();
+
+    QFile f(recordingPath);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+    const QByteArray text = f.readAll();
+    std::vector<std::string> datagrams =
+        Hardware::UEvent::datagramsFromRecording(std::string_view(text.constData(), size_t(text.size())));
+
+    // SEQPACKET keeps datagram boundaries and, unlike DGRAM, reports the
+    // writer hanging up, which is how the end of the replay is noticed.
+    int fds[2];
+    if (::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) != 0) return false;
+    watch(fds[0], false);
+
+    // Fed from a thread: a long recording wouldn't fit in the socket buffer.
+    const int writeFd = fds[1];
+    try {
+        m_replayWriter = std::thread([writeFd, datagrams = std::move(datagrams)]() {
+            for (const std::string &d : datagrams) {
+                if (::send(writeFd, d.data(), d.size(), MSG_NOSIGNAL) < 0) break;
+            }
+            ::close(writeFd);
+        });
+    } catch (const std::system_error &) {
+        ::close(writeFd);
+        close();
+        return false;
+    }
+    return true;
+}
+
+void UEventMonitor::watch(int fd, bool fromKernel)
+{
+    m_fd = fd;
+    m_fromKernel = fromKernel;
+    m_replayDone = false;
+    m_notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(m_notifier, &QSocketNotifier::activated, this, &UEventMonitor::readEvents);
+}
+
+void UEventMonitor::close()
+{
+    delete m_notifier;
+    m_notifier = nullptr;
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+    // with our end closed, a replay writer fails its next send and exits
+    if (m_replayWriter.joinable()) m_replayWriter.join();
+    m_coalesce->stop();
+    m_pending = 0;
+}
+
+void UEventMonitor::readEvents()
+{
+    char buf[kDatagramMax];
+    for (;;) {
+        sockaddr_nl sender = {};
+        iovec iov = { buf, sizeof(buf) };
+        msghdr msg = {};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        if (m_fromKernel) {
+            msg.msg_name = &sender;
+            msg.msg_namelen = sizeof(sender);
+        }
+
+        const ssize_t n = ::recvmsg(m_fd, &msg, MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == ENOBUFS) {
+                // The queue overflowed and events were lost: we no longer
+                // know what changed, so everything hotpluggable is stale.
+                m_pending |= Hardware::UEvent::AllTargets;
+                continue;
+            }
+            break; // EAGAIN: drained
+        }
+        if (n == 0) {
+            // replay writer hung up
+            if (!m_fromKernel && !m_replayDone) {
+                m_replayDone = true;
+                m_notifier->setEnabled(false);
+                flush();
+                emit replayFinished();
+            }
+            break;
+        }
+
+        ++m_eventsSeen;
+        // Only the kernel (port 0) sends to this group; ignore anyone else.
+        if (m_fromKernel && sender.nl_pid != 0) continue;
+
+        Hardware::UEvent::Event event;
+        if (!Hardware::UEvent::parse(std::string_view(buf, size_t(n)), event)) continue;
+        m_pending |= Hardware::UEvent::classify(event);
+    }
+
+    if (m_pending && !m_coalesce->isActive()) m_coalesce->start();
+}
+
+void UEventMonitor::flush()
+{
+    m_coalesce->stop();
+    const unsigned pending = m_pending;
+    m_pending = 0;
+    for (const auto &t : kTargets) {
+        if (pending & t.target) emit probeInvalidated(t.probe);
+    }
+}
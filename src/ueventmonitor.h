@@ -0,0 +1,71 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef UEVENTMONITOR_H
+#define UEVENTMONITOR_H
+
+#include "probeengine.h"
+#include <QObject>
+#include <QString>
+#include <thread>
+
+class QSocketNotifier;
+class QTimer;
+
+// Listens for kernel hotplug events and says which probe they made stale:
+// a display-class PCI device coming or going re-probes Graphics, block
+// devices the StartupDisk row, memory blocks Memory and CPUs Processor.
+// Everything else (USB, network, power supply, ...) is ignored.
+//
+// A hotplug is a burst of events (a disk and each of its partitions, a GPU
+// and its audio function), so they're coalesced: each affected probe is
+// signalled once, shortly after the burst ends.
+//
+// The socket is normally NETLINK_KOBJECT_UEVENT, which needs no privileges.
+// openReplay() swaps in one end of a socketpair fed from a recorded stream,
+// so the whole path can be exercised without touching hardware.
+class UEventMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UEventMonitor(QObject *parent = nullptr);
+    ~UEventMonitor();
+
+    // Binds to the kernel's uevent multicast group.
+    bool open();
+
+    // Replays a recording (see UEvent::datagramsFromRecording) through a
+    // socketpair; replayFinished() follows the last event.
+    bool openReplay(const QString &recordingPath);
+
+    void close();
+    bool isOpen() const { return m_fd >= 0; }
+
+    // Datagrams read so far, relevant or not.
+    int eventsSeen() const { return m_eventsSeen; }
+
+    static constexpr int kCoalesceMs = 200;
+
+signals:
+    void probeInvalidated(ProbeEngine::Probe probe);
+    void replayFinished();
+
+private:
+    void watch(int fd, bool fromKernel);
+    void readEvents();
+    void flush();
+
+    int m_fd = -1;
+    bool m_fromKernel = false;
+    QSocketNotifier *m_notifier = nullptr;
+    QTimer *m_coalesce;
+    unsigned m_pending = 0;
+    int m_eventsSeen = 0;
+    bool m_replayDone = false;
+    std::thread m_replayWriter;
+};
+
+#endif // UEVENTMONITOR_H
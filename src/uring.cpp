@@ -0,0 +1,100 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#include "uring.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Hardware {
+namespace Native {
+
+Uring::~Uring()
+{
+    if (m_sqes) munmap(m_sqes, m_sqesLength);
+    if (m_cqRing && m_cqRing != m_sqRing) munmap(m_cqRing, m_cqLength);
+    if (m_sqRing) munmap(m_sqRing, m_sqLength);
+    if (m_fd >= 0) ::close(m_fd);
+}
+
+bool Uring::open(unsigned entries)
+{
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    m_fd = int(syscall(__NR_io_uring_setup, entries, &params));
+    if (m_fd < 0) return false;
+
+    m_sqLength = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cqLength = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single) m_sqLength = m_cqLength = std::max(m_sqLength, m_cqLength);
+
+    m_sqRing = mmap(nullptr, m_sqLength, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+    if (m_sqRing == MAP_FAILED) { m_sqRing = nullptr; return false; }
+    if (single) {
+        m_cqRing = m_sqRing;
+    } else {
+        m_cqRing = mmap(nullptr, m_cqLength, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+        if (m_cqRing == MAP_FAILED) { m_cqRing = nullptr; return false; }
+    }
+    m_sqesLength = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = mmap(nullptr, m_sqesLength, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) return false;
+    m_sqes = static_cast<io_uring_sqe *>(sqes);
+
+    char *sq = static_cast<char *>(m_sqRing);
+    char *cq = static_cast<char *>(m_cqRing);
+    m_sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    m_sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    m_sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    m_cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    m_cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    m_entries = params.sq_entries;
+    return true;
+}
+
+io_uring_sqe *Uring::prepare()
+{
+    if (m_queued + m_unsubmitted >= m_entries) return nullptr;
+    // Only we touch the tail, so a plain read is fine; the kernel reads it
+    // after the release store in submit().
+    const unsigned index = (*m_sqTail + m_queued) & m_sqMask;
+    io_uring_sqe *sqe = &m_sqes[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    m_sqArray[index] = index;
+    ++m_queued;
+    return sqe;
+}
+
+bool Uring::submit(unsigned waitFor)
+{
+    if (m_queued > 0) {
+        __atomic_store_n(m_sqTail, *m_sqTail + m_queued, __ATOMIC_RELEASE);
+        m_unsubmitted += m_queued;
+        m_queued = 0;
+    }
+
+    for (;;) {
+        const unsigned flags = waitFor > 0 ? IORING_ENTER_GETEVENTS : 0;
+        const long r = syscall(__NR_io_uring_enter, m_fd, m_unsubmitted, waitFor, flags, nullptr, 0);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        // The kernel can take fewer than offered (out of memory for
+        // requests, say), and then doesn't wait; go round with the rest.
+        if (r == 0 && m_unsubmitted > 0) return false;
+        m_unsubmitted -= std::min(m_unsubmitted, unsigned(r));
+        if (m_unsubmitted == 0) return true;
+    }
+}
+
+}
+}
@@ -0,0 +1,77 @@
+/*
+ * TM & (C) 2025 Syndromatic Ltd. All rights reserved.
+ * Designed by Syndromatic in Manchester.
+ */
+
+#ifndef URING_H
+#define URING_H
+
+#include <linux/io_uring.h>
+#include <cstddef>
+
+// A bare io_uring through the raw syscalls, since the tree doesn't pull in
+// liburing: one SQ and CQ ring mapped into our address space, with just
+// enough around them to queue requests, submit them in one go and reap the
+// completions. Used by the disk benchmark and the batched sysfs reader.
+// Not thread-safe; one ring per thread.
+namespace Hardware {
+namespace Native {
+
+class Uring
+{
+public:
+    Uring() = default;
+    ~Uring();
+
+    Uring(const Uring &) = delete;
+    Uring &operator=(const Uring &) = delete;
+
+    // False on kernels before 5.1, or where seccomp or a sysctl says no.
+    bool open(unsigned entries);
+    bool isOpen() const { return m_fd >= 0; }
+    unsigned entries() const { return m_entries; }
+
+    // A zeroed SQE to fill in, or nullptr once entries() are queued and
+    // not yet submitted.
+    io_uring_sqe *prepare();
+    unsigned queued() const { return m_queued; }
+
+    // Hands everything queued to the kernel and waits until at least
+    // waitFor completions are ready (0: don't wait). False on error.
+    bool submit(unsigned waitFor);
+
+    // Calls f(const io_uring_cqe &) for each completion ready now.
+    template <typename F>
+    unsigned reap(F &&f) {
+        unsigned head = *m_cqHead;
+        const unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+        unsigned n = 0;
+        for (; head != tail; ++head, ++n) f(m_cqes[head & m_cqMask]);
+        __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+        return n;
+    }
+
+private:
+    int m_fd = -1;
+    unsigned m_entries = 0;
+    void *m_sqRing = nullptr;
+    void *m_cqRing = nullptr;
+    size_t m_sqLength = 0;
+    size_t m_cqLength = 0;
+    size_t m_sqesLength = 0;
+    io_uring_sqe *m_sqes = nullptr;
+    unsigned *m_sqTail = nullptr;
+    unsigned m_sqMask = 0;
+    unsigned *m_sqArray = nullptr;
+    unsigned *m_cqHead = nullptr;
+    unsigned *m_cqTail = nullptr;
+    unsigned m_cqMask = 0;
+    io_uring_cqe *m_cqes = nullptr;
+    unsigned m_queued = 0;          // prepared, tail not yet published
+    unsigned m_unsubmitted = 0;     // published, not yet consumed by the kernel
+};
+
+}
+}
+
+#endif // URING_H